@@ -78,6 +78,8 @@ PassThruCanBackend::PassThruCanBackend(const QString &name, QObject *parent)
             this, &PassThruCanBackend::enqueueReceivedFrames);
     connect(m_canIO, &PassThruCanIO::messagesSent,
             this, &QCanBusDevice::framesWritten);
+    connect(m_canIO, &PassThruCanIO::messagesLost,
+            this, [this](quint64 count) { addDroppedFrames(QCanBusDevice::Input, count); });
 }
 
 PassThruCanBackend::~PassThruCanBackend()
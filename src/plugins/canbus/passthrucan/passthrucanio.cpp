@@ -252,6 +252,8 @@ void PassThruCanIO::readMessages(bool writePending)
                            QCanBusDevice::ReadError);
         if (status != J2534::PassThru::BufferOverflow)
             return;
+        // the driver does not tell how many messages were lost
+        emit messagesLost(1);
     }
     const int numFrames = qMin<ulong>(m_ioBuffer.size(), numMsgs);
     QList<QCanBusFrame> frames;
@@ -40,6 +40,7 @@ Q_SIGNALS:
     void errorOccurred(const QString &description, QCanBusDevice::CanBusError error);
     void messagesReceived(QList<QCanBusFrame> frames);
     void messagesSent(qint64 count);
+    void messagesLost(quint64 count);
     void openFinished(bool success);
     void closeFinished();
 
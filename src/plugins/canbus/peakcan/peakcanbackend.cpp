@@ -674,6 +674,7 @@ void PeakCanBackendPrivate::startWrite()
                   qUtf16Printable(errorString));
         q->setError(errorString, QCanBusDevice::WriteError);
     } else {
+        q->addTransmittedFrame(frame);
         emit q->framesWritten(qint64(1));
     }
 
@@ -694,6 +695,8 @@ void PeakCanBackendPrivate::startRead()
 
             const TPCANStatus st = ::CAN_ReadFD(channelIndex, &message, &timestamp);
             if (st != PCAN_ERROR_OK) {
+                if (Q_UNLIKELY(st & (PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN)))
+                    q->addDroppedFrames(QCanBusDevice::Input, 1);
                 if (Q_UNLIKELY(st != PCAN_ERROR_QRCVEMPTY))
                     q->setError(systemErrorString(st), QCanBusDevice::ReadError);
                 break;
@@ -707,6 +710,7 @@ void PeakCanBackendPrivate::startRead()
             const int size = dlcToSize(static_cast<CanFrameDlc>(message.DLC));
             QCanBusFrame frame(message.ID, QByteArray(reinterpret_cast<const char *>(message.DATA), size));
             frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(static_cast<qint64>(timestamp)));
+            frame.setTimeStampSource(QCanBusFrame::TimeStampSource::Hardware);
             frame.setExtendedFrameFormat(message.MSGTYPE & PCAN_MESSAGE_EXTENDED);
             frame.setFrameType((message.MSGTYPE & PCAN_MESSAGE_RTR)
                                ? QCanBusFrame::RemoteRequestFrame : QCanBusFrame::DataFrame);
@@ -721,6 +725,8 @@ void PeakCanBackendPrivate::startRead()
 
             const TPCANStatus st = ::CAN_Read(channelIndex, &message, &timestamp);
             if (st != PCAN_ERROR_OK) {
+                if (Q_UNLIKELY(st & (PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN)))
+                    q->addDroppedFrames(QCanBusDevice::Input, 1);
                 if (Q_UNLIKELY(st != PCAN_ERROR_QRCVEMPTY))
                     q->setError(systemErrorString(st), QCanBusDevice::ReadError);
                 break;
@@ -736,6 +742,7 @@ void PeakCanBackendPrivate::startRead()
             const quint64 millis = timestamp.millis + Q_UINT64_C(0x100000000) * timestamp.millis_overflow;
             const quint64 micros = Q_UINT64_C(1000) * millis + timestamp.micros;
             frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(static_cast<qint64>(micros)));
+            frame.setTimeStampSource(QCanBusFrame::TimeStampSource::Hardware);
             frame.setExtendedFrameFormat(message.MSGTYPE & PCAN_MESSAGE_EXTENDED);
             frame.setFrameType((message.MSGTYPE & PCAN_MESSAGE_RTR)
                                ? QCanBusFrame::RemoteRequestFrame : QCanBusFrame::DataFrame);
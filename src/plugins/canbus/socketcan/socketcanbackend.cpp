@@ -11,11 +11,14 @@
 #include <QtCore/qdebug.h>
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
 #include <QtCore/qsocketnotifier.h>
 
 #include <linux/can/error.h>
 #include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
 #include <linux/sockios.h>
 #include <errno.h>
 #include <unistd.h>
@@ -29,6 +32,9 @@
 #ifndef CANFD_ESI
 #   define CANFD_ESI 0x02 /* error state indicator of the transmitting node */
 #endif
+#ifndef SO_RXQ_OVFL
+#   define SO_RXQ_OVFL 40 /* report dropped frames as ancillary data */
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -48,6 +54,23 @@ enum {
     DeviceIsActive = 1
 };
 
+namespace {
+
+// Interfaces whose hardware timestamps were enabled by devices of this process,
+// with the configuration to restore once the last of these devices is closed.
+struct HwTimeStampInterfaces {
+    struct Entry {
+        hwtstamp_config previousConfig;
+        int users;
+    };
+    QHash<QString, Entry> interfaces;
+    QMutex mutex;
+};
+
+} // namespace
+
+Q_GLOBAL_STATIC(HwTimeStampInterfaces, gHwTimeStampInterfaces)
+
 static QByteArray fileContent(const QString &fileName)
 {
     QFile file(fileName);
@@ -187,6 +210,7 @@ bool SocketCanBackend::open()
 
 void SocketCanBackend::close()
 {
+    restoreHardwareTimeStamps();
     ::close(canSocket);
     canSocket = -1;
 
@@ -330,6 +354,76 @@ bool SocketCanBackend::applyConfigurationParameter(ConfigurationKey key, const Q
     return success;
 }
 
+/*
+    Many CAN drivers timestamp all received frames unconditionally, others need to be
+    told to do so. The configuration applies to the whole interface, and may be used by
+    others, e.g. for PTP. Therefore only receive timestamps are enabled, and only if they
+    are off. The previous configuration is restored by restoreHardwareTimeStamps() when
+    the last device of this process using the interface is closed.
+    Changing it requires CAP_NET_ADMIN, so failing here is not an error.
+*/
+void SocketCanBackend::enableHardwareTimeStamps()
+{
+#if defined(SIOCGHWTSTAMP)
+    QMutexLocker locker(&gHwTimeStampInterfaces->mutex);
+    auto &interfaces = gHwTimeStampInterfaces->interfaces;
+    if (const auto it = interfaces.find(canSocketName); it != interfaces.end()) {
+        ++it->users;
+        m_usesHwTimeStamps = true;
+        return;
+    }
+
+    ifreq interface = {};
+    qstrncpy(interface.ifr_name, canSocketName.toLatin1().constData(), sizeof(interface.ifr_name));
+    hwtstamp_config config = {};
+    interface.ifr_data = reinterpret_cast<char *>(&config);
+    if (ioctl(canSocket, SIOCGHWTSTAMP, &interface) < 0) {
+        qCDebug(QT_CANBUS_PLUGINS_SOCKETCAN, "Cannot read hardware timestamp configuration: %ls",
+                qUtf16Printable(qt_error_string(errno)));
+        return;
+    }
+    if (config.rx_filter != HWTSTAMP_FILTER_NONE)
+        return;
+
+    const hwtstamp_config previousConfig = config;
+    config.rx_filter = HWTSTAMP_FILTER_ALL; // tx_type stays as it is
+    if (ioctl(canSocket, SIOCSHWTSTAMP, &interface) < 0) {
+        qCDebug(QT_CANBUS_PLUGINS_SOCKETCAN, "Cannot enable hardware timestamps: %ls",
+                qUtf16Printable(qt_error_string(errno)));
+        return;
+    }
+    interfaces.insert(canSocketName, { previousConfig, 1 });
+    m_usesHwTimeStamps = true;
+#endif
+}
+
+void SocketCanBackend::restoreHardwareTimeStamps()
+{
+    if (!m_usesHwTimeStamps)
+        return;
+    m_usesHwTimeStamps = false;
+
+    QMutexLocker locker(&gHwTimeStampInterfaces->mutex);
+    auto &interfaces = gHwTimeStampInterfaces->interfaces;
+    const auto it = interfaces.find(canSocketName);
+    if (it == interfaces.end() || --it->users > 0)
+        return;
+
+    hwtstamp_config config = it->previousConfig;
+    interfaces.erase(it);
+    if (canSocket == -1)
+        return;
+
+    ifreq interface = {};
+    qstrncpy(interface.ifr_name, canSocketName.toLatin1().constData(), sizeof(interface.ifr_name));
+    interface.ifr_data = reinterpret_cast<char *>(&config);
+    if (ioctl(canSocket, SIOCSHWTSTAMP, &interface) < 0) {
+        qCWarning(QT_CANBUS_PLUGINS_SOCKETCAN,
+                  "Cannot restore the hardware timestamp configuration: %ls",
+                  qUtf16Printable(qt_error_string(errno)));
+    }
+}
+
 bool SocketCanBackend::connectSocket()
 {
     struct ifreq interface;
@@ -356,6 +450,26 @@ bool SocketCanBackend::connectSocket()
         return false;
     }
 
+    // let the kernel report frames dropped due to receive queue overflows
+    const int dropMonitor = 1;
+    if (Q_UNLIKELY(setsockopt(canSocket, SOL_SOCKET, SO_RXQ_OVFL,
+                              &dropMonitor, sizeof(dropMonitor)) < 0)) {
+        qCWarning(QT_CANBUS_PLUGINS_SOCKETCAN, "Cannot enable drop monitoring: %ls",
+                  qUtf16Printable(qt_error_string(errno)));
+    }
+    m_kernelDropCount = 0;
+
+    // prefer timestamps of the CAN controller and fall back to kernel software timestamps
+    const int timeStampFlags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+            | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(canSocket, SOL_SOCKET, SO_TIMESTAMPING,
+                   &timeStampFlags, sizeof(timeStampFlags)) == 0) {
+        enableHardwareTimeStamps();
+    } else {
+        qCDebug(QT_CANBUS_PLUGINS_SOCKETCAN, "Cannot enable SO_TIMESTAMPING: %ls",
+                qUtf16Printable(qt_error_string(errno)));
+    }
+
     m_iov.iov_base = &m_frame;
     m_msg.msg_name = &m_address;
     m_msg.msg_iov = &m_iov;
@@ -479,11 +593,15 @@ bool SocketCanBackend::writeFrame(const QCanBusFrame &newData)
     }
 
     if (Q_UNLIKELY(bytesWritten < 0)) {
+        // the transmit queue of the network interface is full
+        if (errno == ENOBUFS)
+            addDroppedFrames(QCanBusDevice::Output, 1);
         setError(qt_error_string(errno),
                  QCanBusDevice::CanBusError::WriteError);
         return false;
     }
 
+    addTransmittedFrame(newData);
     emit framesWritten(1);
 
     return true;
@@ -677,16 +795,49 @@ void SocketCanBackend::readSocket()
             continue;
         }
 
-        struct timeval timeStamp = {};
-        if (Q_UNLIKELY(ioctl(canSocket, SIOCGSTAMP, &timeStamp) < 0)) {
-            setError(qt_error_string(errno),
-                     QCanBusDevice::CanBusError::ReadError);
-            timeStamp = {};
+        QCanBusFrame bufferedFrame;
+        bool hasTimeStamp = false;
+
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&m_msg); cmsg; cmsg = CMSG_NXTHDR(&m_msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET)
+                continue;
+
+            if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                // the kernel reports the total number of drops since socket creation
+                __u32 dropCount = 0;
+                ::memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+                if (dropCount != m_kernelDropCount) {
+                    addDroppedFrames(QCanBusDevice::Input, __u32(dropCount - m_kernelDropCount));
+                    m_kernelDropCount = dropCount;
+                }
+            } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                // index 0 holds the software timestamp, index 2 the raw hardware timestamp
+                timespec stamps[3] = {};
+                ::memcpy(stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                if (stamps[2].tv_sec || stamps[2].tv_nsec) {
+                    bufferedFrame.setTimeStamp(stamps[2].tv_sec, stamps[2].tv_nsec,
+                                               QCanBusFrame::TimeStampSource::Hardware);
+                    hasTimeStamp = true;
+                } else if (stamps[0].tv_sec || stamps[0].tv_nsec) {
+                    bufferedFrame.setTimeStamp(stamps[0].tv_sec, stamps[0].tv_nsec,
+                                               QCanBusFrame::TimeStampSource::Kernel);
+                    hasTimeStamp = true;
+                }
+            }
         }
 
-        const QCanBusFrame::TimeStamp stamp(timeStamp.tv_sec, timeStamp.tv_usec);
-        QCanBusFrame bufferedFrame;
-        bufferedFrame.setTimeStamp(stamp);
+        if (!hasTimeStamp) {
+            struct timeval timeStamp = {};
+            if (Q_UNLIKELY(ioctl(canSocket, SIOCGSTAMP, &timeStamp) < 0)) {
+                setError(qt_error_string(errno),
+                         QCanBusDevice::CanBusError::ReadError);
+                timeStamp = {};
+            }
+
+            const QCanBusFrame::TimeStamp stamp(timeStamp.tv_sec, timeStamp.tv_usec);
+            bufferedFrame.setTimeStamp(stamp);
+            bufferedFrame.setTimeStampSource(QCanBusFrame::TimeStampSource::Kernel);
+        }
         bufferedFrame.setFlexibleDataRateFormat(bytesReceived == CANFD_MTU);
 
         bufferedFrame.setExtendedFrameFormat(m_frame.can_id & CAN_EFF_FLAG);
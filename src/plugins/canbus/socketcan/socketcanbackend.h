@@ -18,6 +18,7 @@
 #include <sys/uio.h>
 #include <linux/can.h>
 #include <sys/time.h>
+#include <linux/net_tstamp.h>
 
 #include <memory>
 
@@ -79,6 +80,8 @@ private Q_SLOTS:
 private:
     void resetConfigurations();
     bool connectSocket();
+    void enableHardwareTimeStamps();
+    void restoreHardwareTimeStamps();
     bool applyConfigurationParameter(ConfigurationKey key, const QVariant &value);
 
     int protocol = CAN_RAW;
@@ -87,13 +90,17 @@ private:
     msghdr m_msg;
     iovec m_iov;
     sockaddr_can m_addr;
-    char m_ctrlmsg[CMSG_SPACE(sizeof(timeval)) + CMSG_SPACE(sizeof(__u32))];
+    // SO_TIMESTAMPING delivers software, legacy and raw hardware timestamps
+    char m_ctrlmsg[CMSG_SPACE(3 * sizeof(timespec)) + CMSG_SPACE(sizeof(__u32))];
 
     qint64 canSocket = -1;
     QSocketNotifier *notifier = nullptr;
     std::unique_ptr<LibSocketCan> libSocketCan;
     QString canSocketName;
     bool canFdOptionEnabled = false;
+    __u32 m_kernelDropCount = 0;
+    // this device uses the hardware timestamps enabled on the interface
+    bool m_usesHwTimeStamps = false;
 };
 
 QT_END_NAMESPACE
@@ -356,10 +356,12 @@ void SystecCanBackendPrivate::startWrite()
         ::memcpy(message.m_bData, payload.constData(), payloadSize);
 
     const UCANRET result = ::UcanWriteCanMsgEx(handle, channel, &message, nullptr);
-    if (Q_UNLIKELY(result != USBCAN_SUCCESSFUL))
+    if (Q_UNLIKELY(result != USBCAN_SUCCESSFUL)) {
         q->setError(systemErrorString(result), QCanBusDevice::WriteError);
-    else
+    } else {
+        q->addTransmittedFrame(frame);
         emit q->framesWritten(qint64(1));
+    }
 
     if (q->hasOutgoingFrames())
         enableWriteNotification(true);
@@ -378,7 +380,12 @@ void SystecCanBackendPrivate::readAllReceivedMessages()
         if (result == USBCAN_WARN_NODATA)
             break;
 
-        if (Q_UNLIKELY(result != USBCAN_SUCCESSFUL)) {
+        // the message was read successfully, but previous messages were lost
+        if (Q_UNLIKELY(result == USBCAN_WARN_SYS_RXOVERRUN
+                       || result == USBCAN_WARN_DLL_RXOVERRUN
+                       || result == USBCAN_WARN_FW_RXOVERRUN)) {
+            q->addDroppedFrames(QCanBusDevice::Input, 1);
+        } else if (Q_UNLIKELY(result != USBCAN_SUCCESSFUL)) {
             // handle errors
 
             q->setError(systemErrorString(result), QCanBusDevice::ReadError);
@@ -391,6 +398,7 @@ void SystecCanBackendPrivate::readAllReceivedMessages()
 
         // TODO: Timestamp can also be set to 100 us resolution with kUcanModeHighResTimer
         frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(message.m_dwTime * 1000));
+        frame.setTimeStampSource(QCanBusFrame::TimeStampSource::Hardware);
         frame.setExtendedFrameFormat(message.m_bFF & USBCAN_MSG_FF_EXT);
         frame.setLocalEcho(message.m_bFF & USBCAN_MSG_FF_ECHO);
         frame.setFrameType((message.m_bFF & USBCAN_MSG_FF_RTR)
@@ -333,10 +333,12 @@ void TinyCanBackendPrivate::startWrite()
     const qint32 messagesToWrite = 1;
     ::memcpy(message.Data.Bytes, payload.constData(), payloadSize);
     const int ret = ::CanTransmit(channelIndex, &message, messagesToWrite);
-    if (Q_UNLIKELY(ret < 0))
+    if (Q_UNLIKELY(ret < 0)) {
         q->setError(systemErrorString(ret), QCanBusDevice::CanBusError::WriteError);
-    else
+    } else {
+        q->addTransmittedFrame(frame);
         emit q->framesWritten(messagesToWrite);
+    }
 
     if (q->hasOutgoingFrames() && !writeNotifier->isActive())
         writeNotifier->start();
@@ -365,6 +367,11 @@ void TinyCanBackendPrivate::startRead()
             if (::CanGetDeviceStatus(channelIndex, &status) < 0) {
                 q->setError(systemErrorString(ret), QCanBusDevice::CanBusError::ReadError);
             } else {
+                // FifoStatus is an enumeration, not a bit mask
+                if (status.FifoStatus == FIFO_HW_OVERRUN || status.FifoStatus == FIFO_SW_OVERRUN
+                        || status.FifoStatus == FIFO_HW_SW_OVERRUN) {
+                    q->addDroppedFrames(QCanBusDevice::Input, 1);
+                }
                 if (status.CanStatus == CAN_STATUS_BUS_OFF) {
                     qCWarning(QT_CANBUS_PLUGINS_TINYCAN, "CAN bus is in off state, trying to reset the bus.");
                     resetController();
@@ -422,6 +422,8 @@ typedef qint16  XLstatus;
 #define XL_CAN_RXMSG_FLAG_WAKEUP             0x2000    // high voltage message on single wire CAN
 #define XL_CAN_RXMSG_FLAG_TE                 0x4000    // 1: transceiver error detected
 
+#define XL_CAN_QUEUE_OVERFLOW                0x0100    // flagsChip: receive queue overflow, messages have been lost
+
 typedef struct {
     quint32 busType;
     union {
@@ -434,9 +434,12 @@ void VectorCanBackendPrivate::startWrite()
         status = ::xlCanTransmit(portHandle, channelMask, &eventCount, &event);
     }
     if (Q_UNLIKELY(status != XL_SUCCESS)) {
+        if (status == XL_ERR_QUEUE_IS_FULL)
+            q->addDroppedFrames(QCanBusDevice::Output, 1);
         q->setError(systemErrorString(status),
                     QCanBusDevice::WriteError);
     } else {
+        q->addTransmittedFrame(frame);
         emit q->framesWritten(qint64(eventCount));
     }
 
@@ -462,6 +465,8 @@ void VectorCanBackendPrivate::startRead()
                 }
                 break;
             }
+            if (Q_UNLIKELY(event.flagsChip & XL_CAN_QUEUE_OVERFLOW))
+                q->addDroppedFrames(QCanBusDevice::Input, 1);
             if (event.tag != XL_CAN_EV_TAG_RX_OK)
                 continue;
 
@@ -480,7 +485,7 @@ void VectorCanBackendPrivate::startRead()
 
             QCanBusFrame frame(msg.id & ~XL_CAN_EXT_MSG_ID,
                 QByteArray(reinterpret_cast<const char *>(msg.data), dataLength));
-            frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(event.timeStamp / 1000));
+            frame.setTimeStamp(0, qint64(event.timeStamp), QCanBusFrame::TimeStampSource::Hardware);
             frame.setExtendedFrameFormat(msg.id & XL_CAN_EXT_MSG_ID);
             frame.setBitrateSwitch(msg.flags & XL_CAN_RXMSG_FLAG_BRS);
             frame.setFrameType((msg.flags & XL_CAN_RXMSG_FLAG_RTR)
@@ -506,12 +511,17 @@ void VectorCanBackendPrivate::startRead()
 
             const s_xl_can_msg &msg = event.tagData.msg;
 
+            if (Q_UNLIKELY((event.flags & XL_EVENT_FLAG_OVERRUN)
+                           || (msg.flags & XL_CAN_MSG_FLAG_OVERRUN))) {
+                q->addDroppedFrames(QCanBusDevice::Input, 1);
+            }
+
             if ((msg.flags & XL_CAN_MSG_FLAG_TX_COMPLETED) && !transmitEcho)
                 continue;
 
             QCanBusFrame frame(msg.id & ~XL_CAN_EXT_MSG_ID,
                 QByteArray(reinterpret_cast<const char *>(msg.data), int(msg.dlc)));
-            frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(event.timeStamp / 1000));
+            frame.setTimeStamp(0, qint64(event.timeStamp), QCanBusFrame::TimeStampSource::Hardware);
             frame.setExtendedFrameFormat(msg.id & XL_CAN_EXT_MSG_ID);
             frame.setLocalEcho(msg.flags & XL_CAN_MSG_FLAG_TX_COMPLETED);
             frame.setFrameType((msg.flags & XL_CAN_MSG_FLAG_REMOTE_FRAME)
@@ -256,9 +256,11 @@ bool VirtualCanBackend::writeFrame(const QCanBusFrame &frame)
         QCanBusFrame echoFrame = frame;
         echoFrame.setLocalEcho(true);
         echoFrame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(timeStamp * 1000));
+        echoFrame.setTimeStampSource(QCanBusFrame::TimeStampSource::Application);
         enqueueReceivedFrames({echoFrame});
     }
 
+    addTransmittedFrame(frame);
     emit framesWritten(qint64(1));
     return true;
 }
@@ -329,6 +331,7 @@ void VirtualCanBackend::clientReadyRead()
         const qint64 timeStamp = QDateTime::currentDateTime().toMSecsSinceEpoch();
         QCanBusFrame frame(id, data);
         frame.setTimeStamp(QCanBusFrame::TimeStamp::fromMicroSeconds(timeStamp * 1000));
+        frame.setTimeStampSource(QCanBusFrame::TimeStampSource::Application);
         if (flags.contains(RemoteRequestFlag))
             frame.setFrameType(QCanBusFrame::RemoteRequestFrame);
         frame.setExtendedFrameFormat(flags.contains(ExtendedFormatFlag));
@@ -9,11 +9,14 @@
 
 #include <QtCore/qdebug.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qeventloop.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qscopedvaluerollback.h>
 #include <QtCore/qtimer.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_LOGGING_CATEGORY(QT_CANBUS, "qt.canbus")
@@ -255,8 +258,13 @@ void QCanBusDevice::clearError()
     accessed using \l readFrame() and emits the \l framesReceived()
     signal.
 
+    If receive coalescing is enabled, the \l framesReceived() signal is
+    delayed until enough frames are pending or the maximum latency has
+    passed.
+
     Subclasses must call this function when they receive frames.
 
+    \sa setReceiveCoalescing()
 */
 void QCanBusDevice::enqueueReceivedFrames(const QList<QCanBusFrame> &newFrames)
 {
@@ -265,10 +273,49 @@ void QCanBusDevice::enqueueReceivedFrames(const QList<QCanBusFrame> &newFrames)
     if (Q_UNLIKELY(newFrames.isEmpty()))
         return;
 
+    QElapsedTimer timer;
+    timer.start();
+
     d->incomingFramesGuard.lock();
     d->incomingFrames.append(newFrames);
+
+    QCanBusDevice::Metrics &metrics = d->metrics;
+    metrics.receivedFrames += quint64(newFrames.size());
+    for (const QCanBusFrame &frame : newFrames)
+        metrics.receivedBytes += quint64(frame.payload().size());
+    metrics.receiveQueueHighWaterMark = qMax(metrics.receiveQueueHighWaterMark,
+                                             qint64(d->incomingFrames.size()));
+    metrics.receiveEnqueueTime += timer.nsecsElapsed();
+
+    d->pendingReceivedFrames += newFrames.size();
+    const bool hasLatency = d->coalescingLatency > std::chrono::microseconds::zero();
+    bool deliver = true;
+    if (hasLatency)
+        deliver = d->coalescingFrameCount > 0 && d->pendingReceivedFrames >= d->coalescingFrameCount;
+    else
+        deliver = d->pendingReceivedFrames >= qMax<qsizetype>(d->coalescingFrameCount, 1);
+    if (deliver)
+        d->pendingReceivedFrames = 0;
+    // The timer runs from the first pending frame on, it is only started or
+    // stopped when that changes, not for every received frame.
+    bool startTimer = false;
+    bool stopTimer = false;
+    if (d->coalescingTimer && hasLatency) {
+        startTimer = !deliver && !d->coalescingTimerArmed;
+        stopTimer = deliver && d->coalescingTimerArmed;
+        d->coalescingTimerArmed = !deliver;
+    }
+    QTimer *coalescingTimer = d->coalescingTimer;
     d->incomingFramesGuard.unlock();
-    emit framesReceived();
+
+    // plugins may call this function from a worker thread
+    if (startTimer)
+        QMetaObject::invokeMethod(coalescingTimer, qOverload<>(&QTimer::start));
+    else if (stopTimer)
+        QMetaObject::invokeMethod(coalescingTimer, &QTimer::stop);
+
+    if (deliver)
+        emit framesReceived();
 }
 
 /*!
@@ -282,6 +329,10 @@ void QCanBusDevice::enqueueOutgoingFrame(const QCanBusFrame &newFrame)
     Q_D(QCanBusDevice);
 
     d->outgoingFrames.append(newFrame);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    d->metrics.transmitQueueHighWaterMark = qMax(d->metrics.transmitQueueHighWaterMark,
+                                                 qint64(d->outgoingFrames.size()));
 }
 
 /*!
@@ -309,6 +360,56 @@ bool QCanBusDevice::hasOutgoingFrames() const
     return !d->outgoingFrames.isEmpty();
 }
 
+/*!
+    \since 6.7
+
+    Adds \a frame to the transmit counters returned by metrics().
+
+    Subclasses should call this function for every frame that was handed
+    over to the CAN driver or CAN hardware successfully, typically right
+    before emitting the \l framesWritten() signal.
+
+    \sa addDroppedFrames(), metrics()
+*/
+void QCanBusDevice::addTransmittedFrame(const QCanBusFrame &frame)
+{
+    Q_D(QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    ++d->metrics.transmittedFrames;
+    d->metrics.transmittedBytes += quint64(frame.payload().size());
+}
+
+/*!
+    \since 6.7
+
+    Adds \a count to the number of frames lost in \a direction, as returned
+    by metrics().
+
+    Subclasses should call this function whenever the CAN driver, the CAN
+    hardware or the operating system reports that frames were dropped, e.g.
+    because of a receive queue overflow. If the underlying layer only signals
+    that an overflow happened, but not how many frames were lost, \a count
+    should be \c 1.
+
+    \note \a direction must be either \l Input or \l Output.
+
+    \sa addTransmittedFrame(), metrics()
+*/
+void QCanBusDevice::addDroppedFrames(QCanBusDevice::Direction direction, quint64 count)
+{
+    Q_D(QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    if (direction == Direction::Input)
+        d->metrics.receiveDrops += count;
+    else if (direction == Direction::Output)
+        d->metrics.transmitDrops += count;
+    else
+        qCWarning(QT_CANBUS, "QCanBusDevice::addDroppedFrames(): Invalid direction %d.",
+                  int(direction));
+}
+
 /*!
     Sets the configuration parameter \a key for the CAN bus connection
     to \a value. The potential keys are represented by \l ConfigurationKey.
@@ -542,12 +643,230 @@ void QCanBusDevice::clear(QCanBusDevice::Directions direction)
     if (direction & Direction::Input) {
         QMutexLocker locker(&d->incomingFramesGuard);
         d->incomingFrames.clear();
+        d->pendingReceivedFrames = 0;
     }
 
     if (direction & Direction::Output)
         d->outgoingFrames.clear();
 }
 
+/*!
+    \class QCanBusDevice::Metrics
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QCanBusDevice::Metrics struct holds traffic counters of a CAN bus device.
+
+    The counters are accumulated since the device was created or since the last
+    call to \l QCanBusDevice::resetMetrics(). They allow an application to
+    detect frame loss and to size its processing capacity.
+
+    Frame and byte counters on the receive side are maintained by QCanBusDevice
+    itself. Transmit counters and drop counters depend on the CAN plugin
+    reporting them. Please refer to the plugins help pages for more information.
+
+    \sa QCanBusDevice::metrics()
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::receivedFrames
+
+    \brief The number of frames that were added to the receive queue.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::receivedBytes
+
+    \brief The number of payload bytes that were added to the receive queue.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::receiveDrops
+
+    \brief The number of received frames that were lost in the operating
+    system, the CAN driver or the CAN hardware before they could be read.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::receiveQueueHighWaterMark
+
+    \brief The maximum number of frames that were waiting in the receive
+    queue at the same time.
+
+    \sa QCanBusDevice::framesAvailable()
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::receiveEnqueueTime
+
+    \brief The accumulated time in nanoseconds spent in adding received frames
+    to the receive queue.
+
+    The time needed to deliver the \l QCanBusDevice::framesReceived() signal
+    is not included.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::transmittedFrames
+
+    \brief The number of frames that were handed over to the CAN driver.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::transmittedBytes
+
+    \brief The number of payload bytes that were handed over to the CAN driver.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::transmitDrops
+
+    \brief The number of frames that were lost in the transmit path.
+*/
+
+/*!
+    \variable QCanBusDevice::Metrics::transmitQueueHighWaterMark
+
+    \brief The maximum number of frames that were waiting in the transmit
+    queue of buffered devices at the same time.
+
+    \sa QCanBusDevice::framesToWrite()
+*/
+
+/*!
+    \since 6.7
+
+    Configures how often the \l framesReceived() signal is emitted.
+
+    By default, the signal is emitted each time the CAN plugin has received
+    new frames. On a busy bus, and with plugins that deliver frames one by one,
+    this results in one signal per frame. Coalescing reduces the number of
+    wake-ups at the cost of a higher latency, similar to interrupt coalescing
+    of network interfaces.
+
+    The signal is emitted as soon as at least \a frameCount frames are pending,
+    i.e. were received since the last emission. If \a maximumLatency is greater
+    than zero, the signal is also emitted when \a maximumLatency has passed since
+    the first pending frame arrived. A \a frameCount of zero then disables the
+    frame limit, so that the signal is only emitted by time.
+
+    Passing a \a frameCount of \c 1 and a \a maximumLatency of zero restores the
+    default behavior.
+
+    \note The maximum latency is rounded up to whole milliseconds, as it is
+    enforced by a timer of the thread the device lives in.
+
+    \note If \a maximumLatency is zero, frames are only announced once
+    \a frameCount frames have arrived. This function should therefore be
+    called with a maximum latency unless the traffic on the bus is known.
+
+    \sa receiveCoalescingFrameCount(), receiveCoalescingLatency(),
+        waitForFramesReceived()
+*/
+void QCanBusDevice::setReceiveCoalescing(qsizetype frameCount,
+                                         std::chrono::microseconds maximumLatency)
+{
+    Q_D(QCanBusDevice);
+
+    if (Q_UNLIKELY(frameCount < 0 || maximumLatency < std::chrono::microseconds::zero())) {
+        qCWarning(QT_CANBUS, "QCanBusDevice::setReceiveCoalescing(): Invalid parameters.");
+        return;
+    }
+
+    if (!d->coalescingTimer) {
+        d->coalescingTimer = new QTimer(this);
+        d->coalescingTimer->setSingleShot(true);
+        d->coalescingTimer->setTimerType(Qt::PreciseTimer);
+        connect(d->coalescingTimer, &QTimer::timeout, this, [this]() {
+            Q_D(QCanBusDevice);
+            {
+                QMutexLocker locker(&d->incomingFramesGuard);
+                d->coalescingTimerArmed = false;
+                if (d->pendingReceivedFrames == 0)
+                    return;
+                d->pendingReceivedFrames = 0;
+            }
+            emit framesReceived();
+        });
+    }
+
+    d->coalescingTimer->stop();
+    d->coalescingTimer->setInterval(
+                std::chrono::ceil<std::chrono::milliseconds>(maximumLatency));
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    d->coalescingFrameCount = frameCount;
+    d->coalescingLatency = maximumLatency;
+    d->pendingReceivedFrames = 0;
+    d->coalescingTimerArmed = false;
+}
+
+/*!
+    \since 6.7
+
+    Returns the number of frames after which the \l framesReceived()
+    signal is emitted. The default value is \c 1.
+
+    \sa setReceiveCoalescing()
+*/
+qsizetype QCanBusDevice::receiveCoalescingFrameCount() const
+{
+    Q_D(const QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    return d->coalescingFrameCount;
+}
+
+/*!
+    \since 6.7
+
+    Returns the maximum time a received frame may wait before the
+    \l framesReceived() signal is emitted. The default value is zero,
+    which means there is no time limit.
+
+    \sa setReceiveCoalescing()
+*/
+std::chrono::microseconds QCanBusDevice::receiveCoalescingLatency() const
+{
+    Q_D(const QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    return d->coalescingLatency;
+}
+
+/*!
+    \since 6.7
+
+    Returns the traffic counters accumulated since the device was created
+    or since the last call to resetMetrics().
+
+    This function is thread-safe.
+
+    \sa resetMetrics(), QCanBusDevice::Metrics
+*/
+QCanBusDevice::Metrics QCanBusDevice::metrics() const
+{
+    Q_D(const QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    return d->metrics;
+}
+
+/*!
+    \since 6.7
+
+    Resets all traffic counters returned by metrics() to zero.
+
+    \sa metrics()
+*/
+void QCanBusDevice::resetMetrics()
+{
+    Q_D(QCanBusDevice);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    d->metrics = {};
+}
+
 /*!
     For buffered devices, this function waits until all buffered frames
     have been written to the device and the \l framesWritten() signal has been emitted,
@@ -744,6 +1063,7 @@ QCanBusFrame QCanBusDevice::readFrame()
     if (Q_UNLIKELY(d->incomingFrames.isEmpty()))
         return QCanBusFrame(QCanBusFrame::InvalidFrame);
 
+    d->pendingReceivedFrames = 0;
     return d->incomingFrames.takeFirst();
 }
 
@@ -773,9 +1093,115 @@ QList<QCanBusFrame> QCanBusDevice::readAllFrames()
 
     QList<QCanBusFrame> result;
     result.swap(d->incomingFrames);
+    d->pendingReceivedFrames = 0;
     return result;
 }
 
+/*!
+    \since 6.7
+    Moves up to \a maxFrames \l{QCanBusFrame}s from the queue into the
+    caller-owned array \a frames and returns the number of frames moved.
+    The moved frames are removed from the queue. If no frames are available,
+    or if an error occurred, this function returns \c 0.
+
+    The queue operates according to the FIFO principle.
+
+    In contrast to readAllFrames(), this function neither allocates a new
+    list per call nor releases the storage of the queue. Applications that
+    drain the queue frequently can therefore reuse a preallocated buffer:
+
+    \code
+        std::array<QCanBusFrame, 1024> buffer;
+        qsizetype count;
+        while ((count = device->readFrames(buffer.data(), buffer.size())) > 0)
+            logger.write(buffer.data(), count);
+    \endcode
+
+    \sa readAllFrames(), processFrames(), framesAvailable()
+*/
+qsizetype QCanBusDevice::readFrames(QCanBusFrame *frames, qsizetype maxFrames)
+{
+    Q_D(QCanBusDevice);
+
+    if (Q_UNLIKELY(d->state != ConnectedState)) {
+        const QString error = tr("Cannot read frame as device is not connected.");
+        qCWarning(QT_CANBUS, "%ls", qUtf16Printable(error));
+        setError(error, CanBusError::OperationError);
+        return 0;
+    }
+
+    clearError();
+
+    if (Q_UNLIKELY(!frames || maxFrames <= 0))
+        return 0;
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+
+    const qsizetype count = qMin(maxFrames, d->incomingFrames.size());
+    if (count == 0)
+        return 0;
+
+    const auto first = d->incomingFrames.begin();
+    std::move(first, first + count, frames);
+    // QList releases leading elements without moving the remaining ones
+    d->incomingFrames.remove(0, count);
+    d->pendingReceivedFrames = 0;
+    return count;
+}
+
+/*!
+    \since 6.7
+    Gives \a processor access to the queued \l{QCanBusFrame}s without copying
+    them out of the queue, and removes the frames \a processor has consumed.
+    Returns the number of removed frames.
+
+    \a processor is called once with a pointer to the oldest queued frame and
+    the number of queued frames. It must return how many of these frames, counted
+    from the oldest one, it has processed; these frames are then removed from the
+    queue. Returning \c 0 leaves the queue untouched, allowing a consumer to peek
+    at the frames and to commit them later.
+
+    The pointer passed to \a processor is only valid during the call. While
+    \a processor runs, the queue is locked; it must therefore neither call other
+    functions of this device nor block for a longer time, because frames received
+    by a CAN plugin in another thread are delayed meanwhile.
+
+    If no frames are queued, \a processor is not called.
+
+    \sa readFrames(), readAllFrames()
+*/
+qsizetype QCanBusDevice::processFrames(
+        const std::function<qsizetype(const QCanBusFrame *frames, qsizetype count)> &processor)
+{
+    Q_D(QCanBusDevice);
+
+    if (Q_UNLIKELY(d->state != ConnectedState)) {
+        const QString error = tr("Cannot read frame as device is not connected.");
+        qCWarning(QT_CANBUS, "%ls", qUtf16Printable(error));
+        setError(error, CanBusError::OperationError);
+        return 0;
+    }
+
+    clearError();
+
+    if (Q_UNLIKELY(!processor))
+        return 0;
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+
+    const qsizetype available = d->incomingFrames.size();
+    if (available == 0)
+        return 0;
+
+    const qsizetype consumed = qBound(qsizetype(0),
+                                      processor(d->incomingFrames.constData(), available),
+                                      available);
+    d->incomingFrames.remove(0, consumed);
+    if (consumed > 0)
+        d->pendingReceivedFrames = 0;
+    return consumed;
+}
+
 /*!
     \fn void QCanBusDevice::framesWritten(qint64 framesCount)
 
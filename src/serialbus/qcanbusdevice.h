@@ -9,6 +9,7 @@
 #include <QtSerialBus/qcanbusframe.h>
 #include <QtSerialBus/qcanbusdeviceinfo.h>
 
+#include <chrono>
 #include <functional>
 
 QT_BEGIN_NAMESPACE
@@ -90,6 +91,20 @@ public:
         FormatFilter format = MatchBaseAndExtendedFormat;
     };
 
+    struct Metrics
+    {
+        quint64 receivedFrames = 0;
+        quint64 receivedBytes = 0;
+        quint64 receiveDrops = 0;
+        qint64 receiveQueueHighWaterMark = 0;
+        qint64 receiveEnqueueTime = 0;
+
+        quint64 transmittedFrames = 0;
+        quint64 transmittedBytes = 0;
+        quint64 transmitDrops = 0;
+        qint64 transmitQueueHighWaterMark = 0;
+    };
+
     explicit QCanBusDevice(QObject *parent = nullptr);
 
     virtual void setConfigurationParameter(ConfigurationKey key, const QVariant &value);
@@ -99,6 +114,9 @@ public:
     virtual bool writeFrame(const QCanBusFrame &frame) = 0;
     QCanBusFrame readFrame();
     QList<QCanBusFrame> readAllFrames();
+    qsizetype readFrames(QCanBusFrame *frames, qsizetype maxFrames);
+    qsizetype processFrames(
+            const std::function<qsizetype(const QCanBusFrame *frames, qsizetype count)> &processor);
     qint64 framesAvailable() const;
     qint64 framesToWrite() const;
 
@@ -114,6 +132,14 @@ public:
     Q_DECLARE_FLAGS(Directions, Direction)
     void clear(Directions direction = Direction::AllDirections);
 
+    Metrics metrics() const;
+    void resetMetrics();
+
+    void setReceiveCoalescing(qsizetype frameCount,
+                              std::chrono::microseconds maximumLatency = std::chrono::microseconds::zero());
+    qsizetype receiveCoalescingFrameCount() const;
+    std::chrono::microseconds receiveCoalescingLatency() const;
+
     virtual bool waitForFramesWritten(int msecs);
     virtual bool waitForFramesReceived(int msecs);
 
@@ -145,6 +171,9 @@ protected:
     QCanBusFrame dequeueOutgoingFrame();
     bool hasOutgoingFrames() const;
 
+    void addTransmittedFrame(const QCanBusFrame &frame);
+    void addDroppedFrames(QCanBusDevice::Direction direction, quint64 count);
+
     virtual bool open() = 0;
     virtual void close() = 0;
 
@@ -167,6 +196,7 @@ Q_DECLARE_TYPEINFO(QCanBusDevice::CanBusDeviceState, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusDevice::ConfigurationKey, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusDevice::Filter, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusDevice::Filter::FormatFilter, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QCanBusDevice::Metrics, Q_PRIMITIVE_TYPE);
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCanBusDevice::Filter::FormatFilters)
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCanBusDevice::Directions)
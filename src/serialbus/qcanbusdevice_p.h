@@ -22,6 +22,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 typedef QPair<QCanBusDevice::ConfigurationKey, QVariant > ConfigEntry;
 
 class QCanBusDevicePrivate : public QObjectPrivate
@@ -35,10 +37,22 @@ public:
     QString errorText;
 
     QList<QCanBusFrame> incomingFrames;
-    QMutex incomingFramesGuard;
+    mutable QMutex incomingFramesGuard;
     QList<QCanBusFrame> outgoingFrames;
     QList<ConfigEntry> configOptions;
 
+    // guarded by incomingFramesGuard, as plugins may receive in a worker thread
+    QCanBusDevice::Metrics metrics;
+
+    // framesReceived() coalescing, pendingReceivedFrames and coalescingTimerArmed are
+    // guarded by incomingFramesGuard. Reading frames resets pendingReceivedFrames, so
+    // that frames which were read already are not announced by the timer.
+    qsizetype coalescingFrameCount = 1;
+    std::chrono::microseconds coalescingLatency = std::chrono::microseconds::zero();
+    qsizetype pendingReceivedFrames = 0;
+    QTimer *coalescingTimer = nullptr;
+    bool coalescingTimerArmed = false;
+
     bool waitForReceivedEntered = false;
     bool waitForWrittenEntered = false;
 
@@ -90,7 +90,72 @@ using namespace Qt::StringLiterals;
     Sets \a ts as the timestamp for the CAN frame. Usually, this function is not needed, because the
     timestamp is created during the read operation and not needed during the write operation.
 
-    \sa QCanBusFrame::TimeStamp
+    \note This function resets the nanosecond part of the timestamp returned by
+    timeStampNanoSeconds() to the microsecond resolution of \a ts.
+
+    \sa QCanBusFrame::TimeStamp, timeStampSource()
+*/
+
+/*!
+    \fn void QCanBusFrame::setTimeStamp(qint64 seconds, qint64 nanoSeconds, TimeStampSource source)
+    \since 6.7
+
+    Sets the timestamp of the CAN frame to \a seconds and \a nanoSeconds, and
+    records that the timestamp was taken by \a source.
+
+    The timestamp is normalized, i.e. nanoseconds greater than 999999999 are converted
+    to seconds. \a nanoSeconds must not be negative.
+
+    This function is typically used by CAN plugins which obtain timestamps with
+    a resolution higher than one microsecond.
+
+    \sa timeStamp(), timeStampNanoSeconds(), timeStampSource()
+*/
+
+/*!
+    \fn qint64 QCanBusFrame::timeStampNanoSeconds() const
+    \since 6.7
+
+    Returns the sub-second part of the frame's timestamp in nanoseconds.
+
+    If the timestamp was set with microsecond resolution only, this is
+    \l {QCanBusFrame::TimeStamp::microSeconds()}{timeStamp().microSeconds()}
+    multiplied by 1000.
+
+    \sa timeStamp(), setTimeStamp()
+*/
+
+/*!
+    \enum QCanBusFrame::TimeStampSource
+    \since 6.7
+
+    This enum describes where the timestamp of a received frame was taken.
+
+    \value Unknown         The origin of the timestamp is not known.
+    \value Application     The timestamp was taken in user space when the
+                            frame was read from the CAN driver.
+    \value Kernel          The timestamp was taken by the operating system
+                            kernel when the frame was received.
+    \value Hardware        The timestamp was taken by the CAN controller or
+                            CAN interface hardware.
+*/
+
+/*!
+    \fn QCanBusFrame::TimeStampSource QCanBusFrame::timeStampSource() const
+    \since 6.7
+
+    Returns where the timestamp of the frame was taken.
+
+    \sa setTimeStampSource(), timeStamp()
+*/
+
+/*!
+    \fn void QCanBusFrame::setTimeStampSource(QCanBusFrame::TimeStampSource source)
+    \since 6.7
+
+    Sets the origin of the frame's timestamp to \a source.
+
+    \sa timeStampSource()
 */
 
 /*!
@@ -135,6 +200,8 @@ using namespace Qt::StringLiterals;
 
     \value Qt_5_8               This frame is the initial version introduced in Qt 5.8
     \value Qt_5_9               This frame version was introduced in Qt 5.9
+    \value Qt_5_10              This frame version was introduced in Qt 5.10
+    \value Qt_6_7               This frame version was introduced in Qt 6.7
 */
 
 /*!
@@ -421,19 +488,28 @@ QString QCanBusFrame::toString() const
 */
 QDataStream &operator<<(QDataStream &out, const QCanBusFrame &frame)
 {
+    // older Qt versions cannot skip fields added by newer frame versions
+    quint8 version = frame.version;
+    if (out.version() < QDataStream::Qt_6_7)
+        version = qMin<quint8>(version, QCanBusFrame::Version::Qt_5_10);
+
     out << frame.frameId();
     out << static_cast<quint8>(frame.frameType());
-    out << static_cast<quint8>(frame.version);
+    out << version;
     out << frame.hasExtendedFrameFormat();
     out << frame.hasFlexibleDataRateFormat();
     out << frame.payload();
     const QCanBusFrame::TimeStamp stamp = frame.timeStamp();
     out << stamp.seconds();
     out << stamp.microSeconds();
-    if (frame.version >= QCanBusFrame::Version::Qt_5_9)
+    if (version >= QCanBusFrame::Version::Qt_5_9)
         out << frame.hasBitrateSwitch() << frame.hasErrorStateIndicator();
-    if (frame.version >= QCanBusFrame::Version::Qt_5_10)
+    if (version >= QCanBusFrame::Version::Qt_5_10)
         out << frame.hasLocalEcho();
+    if (version >= QCanBusFrame::Version::Qt_6_7) {
+        out << frame.stampSubMicroSeconds;
+        out << static_cast<quint8>(frame.timeStampSource());
+    }
     return out;
 }
 
@@ -452,6 +528,8 @@ QDataStream &operator>>(QDataStream &in, QCanBusFrame &frame)
     bool bitrateSwitch = false;
     bool errorStateIndicator = false;
     bool localEcho = false;
+    quint16 subMicroSeconds = 0;
+    quint8 timeStampSource = 0;
     QByteArray payload;
     qint64 seconds;
     qint64 microSeconds;
@@ -465,6 +543,9 @@ QDataStream &operator>>(QDataStream &in, QCanBusFrame &frame)
     if (version >= QCanBusFrame::Version::Qt_5_10)
         in >> localEcho;
 
+    if (version >= QCanBusFrame::Version::Qt_6_7)
+        in >> subMicroSeconds >> timeStampSource;
+
     frame.setFrameId(frameId);
     frame.version = version;
 
@@ -477,6 +558,8 @@ QDataStream &operator>>(QDataStream &in, QCanBusFrame &frame)
     frame.setPayload(payload);
 
     frame.setTimeStamp(QCanBusFrame::TimeStamp(seconds, microSeconds));
+    frame.stampSubMicroSeconds = subMicroSeconds;
+    frame.setTimeStampSource(static_cast<QCanBusFrame::TimeStampSource>(timeStampSource));
 
     return in;
 }
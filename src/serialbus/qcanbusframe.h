@@ -41,17 +41,25 @@ public:
         InvalidFrame        = 0x4
     };
 
+    enum class TimeStampSource : quint8 {
+        Unknown             = 0x0,
+        Application         = 0x1,
+        Kernel              = 0x2,
+        Hardware            = 0x3
+    };
+
     explicit QCanBusFrame(FrameType type = DataFrame) noexcept :
         isExtendedFrame(0x0),
-        version(Qt_5_10),
+        version(Qt_6_7),
         isFlexibleDataRate(0x0),
         isBitrateSwitch(0x0),
         isErrorStateIndicator(0x0),
         isLocalEcho(0x0),
-        reserved0(0x0)
+        stampSource(0x0),
+        reserved0(0x0),
+        stampSubMicroSeconds(0)
     {
         Q_UNUSED(reserved0);
-        ::memset(reserved, 0, sizeof(reserved));
         setFrameId(0x0);
         setFrameType(type);
     }
@@ -77,15 +85,16 @@ public:
     explicit QCanBusFrame(QCanBusFrame::FrameId identifier, const QByteArray &data) :
         format(DataFrame),
         isExtendedFrame(0x0),
-        version(Qt_5_10),
+        version(Qt_6_7),
         isFlexibleDataRate(data.size() > 8 ? 0x1 : 0x0),
         isBitrateSwitch(0x0),
         isErrorStateIndicator(0x0),
         isLocalEcho(0x0),
+        stampSource(0x0),
         reserved0(0x0),
+        stampSubMicroSeconds(0),
         load(data)
     {
-        ::memset(reserved, 0, sizeof(reserved));
         setFrameId(identifier);
     }
 
@@ -173,10 +182,35 @@ public:
         if (data.size() > 8)
             isFlexibleDataRate = 0x1;
     }
-    constexpr void setTimeStamp(TimeStamp ts) noexcept { stamp = ts; }
+    constexpr void setTimeStamp(TimeStamp ts) noexcept
+    {
+        stamp = ts;
+        stampSubMicroSeconds = 0;
+    }
+    constexpr void setTimeStamp(qint64 seconds, qint64 nanoSeconds,
+                                TimeStampSource source) noexcept
+    {
+        stamp = TimeStamp(seconds + nanoSeconds / 1000000000,
+                          (nanoSeconds % 1000000000) / 1000);
+        stampSubMicroSeconds = quint16(nanoSeconds % 1000);
+        setTimeStampSource(source);
+    }
 
     QByteArray payload() const { return load; }
     constexpr TimeStamp timeStamp() const noexcept { return stamp; }
+    constexpr qint64 timeStampNanoSeconds() const noexcept
+    {
+        return stamp.microSeconds() * 1000 + stampSubMicroSeconds;
+    }
+
+    constexpr TimeStampSource timeStampSource() const noexcept
+    {
+        return TimeStampSource(stampSource);
+    }
+    constexpr void setTimeStampSource(TimeStampSource source) noexcept
+    {
+        stampSource = quint8(source) & 0x3;
+    }
 
     constexpr FrameErrors error() const noexcept
     {
@@ -234,7 +268,8 @@ private:
     enum Version {
         Qt_5_8 = 0x0,
         Qt_5_9 = 0x1,
-        Qt_5_10 = 0x2
+        Qt_5_10 = 0x2,
+        Qt_6_7 = 0x3
     };
 
     quint32 canId:29; // acts as container for error codes too
@@ -248,10 +283,11 @@ private:
     quint8 isBitrateSwitch:1;
     quint8 isErrorStateIndicator:1;
     quint8 isLocalEcho:1;
-    quint8 reserved0:5;
+    quint8 stampSource:2;
+    quint8 reserved0:3;
 
-    // reserved for future use
-    quint8 reserved[2];
+    // nanoseconds in addition to the microseconds of stamp
+    quint16 stampSubMicroSeconds;
 
     QByteArray load;
     TimeStamp stamp;
@@ -261,6 +297,7 @@ Q_DECLARE_TYPEINFO(QCanBusFrame, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusFrame::FrameError, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusFrame::FrameType, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QCanBusFrame::TimeStamp, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QCanBusFrame::TimeStampSource, Q_PRIMITIVE_TYPE);
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCanBusFrame::FrameErrors)
 
@@ -273,5 +310,6 @@ QT_END_NAMESPACE
 
 Q_DECLARE_METATYPE(QCanBusFrame::FrameType)
 Q_DECLARE_METATYPE(QCanBusFrame::FrameErrors)
+Q_DECLARE_METATYPE(QCanBusFrame::TimeStampSource)
 
 #endif // QCANBUSFRAME_H
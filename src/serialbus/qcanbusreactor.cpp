@@ -0,0 +1,354 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qcanbusreactor.h"
+#include "qcanbusreactor_p.h"
+
+#include <QtCore/qloggingcategory.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_CANBUS)
+
+/*!
+    \class QCanBusReactor
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QCanBusReactor class serves multiple CAN bus devices from one
+    dedicated thread and delivers their received frames as merged batches.
+
+    Each QCanBusDevice waits for its CAN driver on its own, e.g. the SocketCAN
+    plugin uses one socket notifier per device and the VirtualCAN plugin one
+    TCP socket per device. Applications that bridge or log many CAN channels
+    therefore see many independent wake-ups and signals.
+
+    A QCanBusReactor adopts any number of devices with addDevice() and moves
+    them into a thread owned by the reactor. The event dispatcher of that thread
+    then waits for all devices in a single poll call. Frames received by the
+    devices during one event loop iteration are collected, sorted by their
+    timestamps and made available via readAllFrames() together with the channel
+    they were received on. The \l framesReceived() signal is emitted once per
+    batch.
+
+    The adopted devices must not be used directly from other threads, as
+    QCanBusDevice is not thread-safe. Use writeFrame() to send frames on a
+    channel, and removeDevice() to return a device to the calling thread.
+
+    addDevice() and removeDevice() must be called from the thread the reactor
+    lives in. All other functions are thread-safe.
+
+    \sa QCanBusDevice
+*/
+
+/*!
+    \class QCanBusReactor::Frame
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QCanBusReactor::Frame struct holds a received frame together
+    with the channel it was received on.
+*/
+
+/*!
+    \variable QCanBusReactor::Frame::channel
+
+    \brief The channel of the device that received the frame, as returned by
+    \l QCanBusReactor::addDevice().
+*/
+
+/*!
+    \variable QCanBusReactor::Frame::frame
+
+    \brief The received CAN frame.
+*/
+
+/*!
+    \fn void QCanBusReactor::framesReceived()
+
+    This signal is emitted when a new batch of frames has been received by
+    the adopted devices. The frames should be read using \l readAllFrames().
+*/
+
+void QCanBusReactorPrivate::collectFrames(QCanBusDevice *device, qsizetype channel)
+{
+    device->processFrames([this, channel](const QCanBusFrame *frames, qsizetype count) {
+        batch.reserve(batch.size() + count);
+        for (qsizetype i = 0; i < count; ++i)
+            batch.append({channel, frames[i]});
+        return count;
+    });
+
+    // devices that become ready in the same iteration end up in the same batch
+    if (!deliveryScheduled && !batch.isEmpty()) {
+        deliveryScheduled = true;
+        QMetaObject::invokeMethod(context, [this]() { deliverFrames(); }, Qt::QueuedConnection);
+    }
+}
+
+void QCanBusReactorPrivate::deliverFrames()
+{
+    Q_Q(QCanBusReactor);
+
+    deliveryScheduled = false;
+    if (batch.isEmpty())
+        return;
+
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const QCanBusReactor::Frame &a, const QCanBusReactor::Frame &b) {
+        const QCanBusFrame::TimeStamp stampA = a.frame.timeStamp();
+        const QCanBusFrame::TimeStamp stampB = b.frame.timeStamp();
+        if (stampA.seconds() != stampB.seconds())
+            return stampA.seconds() < stampB.seconds();
+        return a.frame.timeStampNanoSeconds() < b.frame.timeStampNanoSeconds();
+    });
+
+    {
+        QMutexLocker locker(&incomingFramesGuard);
+        if (incomingFrames.isEmpty())
+            incomingFrames.swap(batch);
+        else
+            incomingFrames.append(std::move(batch));
+    }
+    batch.clear();
+
+    emit q->framesReceived();
+}
+
+void QCanBusReactorPrivate::releaseDevice(QCanBusDevice *device, QThread *targetThread)
+{
+    QMetaObject::invokeMethod(context, [this, device, targetThread]() {
+        QObject::disconnect(device, nullptr, context, nullptr);
+        // Frames collected already are delivered with the pending batch. Frames
+        // not collected yet stay in the device's own queue.
+        device->moveToThread(targetThread);
+    }, Qt::BlockingQueuedConnection);
+}
+
+/*!
+    Constructs a CAN bus reactor with the given \a parent and starts its thread.
+*/
+QCanBusReactor::QCanBusReactor(QObject *parent)
+    : QObject(*new QCanBusReactorPrivate, parent)
+{
+    Q_D(QCanBusReactor);
+
+    d->thread.setObjectName(QStringLiteral("QCanBusReactor"));
+    d->context = new QObject;
+    d->context->moveToThread(&d->thread);
+    d->thread.start();
+}
+
+/*!
+    Destroys the CAN bus reactor. All adopted devices are moved back to the
+    thread of the reactor before the reactor thread is stopped. The devices
+    themselves are not deleted.
+*/
+QCanBusReactor::~QCanBusReactor()
+{
+    Q_D(QCanBusReactor);
+
+    QList<QPointer<QCanBusDevice>> devices;
+    {
+        QMutexLocker locker(&d->devicesGuard);
+        devices.swap(d->devices);
+    }
+    for (const QPointer<QCanBusDevice> &device : std::as_const(devices)) {
+        if (device)
+            d->releaseDevice(device, thread());
+    }
+
+    d->thread.quit();
+    d->thread.wait();
+    delete d->context;
+}
+
+/*!
+    Adopts \a device and returns the channel used to identify it, or \c -1 if
+    the device cannot be adopted.
+
+    The device is moved into the reactor thread. It must therefore live in the
+    thread the reactor lives in, from which this function must be called, and
+    it must not have a parent. The device may be
+    connected already; otherwise it must be connected from within the reactor
+    thread, e.g. using QMetaObject::invokeMethod().
+
+    The reactor does not take ownership of \a device.
+
+    \sa removeDevice(), device()
+*/
+qsizetype QCanBusReactor::addDevice(QCanBusDevice *device)
+{
+    Q_D(QCanBusReactor);
+
+    if (Q_UNLIKELY(!device)) {
+        qCWarning(QT_CANBUS, "QCanBusReactor::addDevice(): Cannot add a null device.");
+        return -1;
+    }
+    if (Q_UNLIKELY(devices().contains(device))) {
+        qCWarning(QT_CANBUS, "QCanBusReactor::addDevice(): The device is already added.");
+        return -1;
+    }
+    if (Q_UNLIKELY(QThread::currentThread() != thread())) {
+        qCWarning(QT_CANBUS, "QCanBusReactor::addDevice(): Must be called from the thread "
+                             "of the reactor.");
+        return -1;
+    }
+    if (Q_UNLIKELY(device->parent() || device->thread() != thread())) {
+        qCWarning(QT_CANBUS, "QCanBusReactor::addDevice(): The device must not have a parent "
+                             "and must live in the thread of the reactor.");
+        return -1;
+    }
+
+    // the device is moved before it is published, so writeFrame() never posts
+    // to a device that is still moving
+    device->moveToThread(&d->thread);
+    qsizetype channel;
+    {
+        QMutexLocker locker(&d->devicesGuard);
+        channel = d->devices.size();
+        d->devices.append(device);
+    }
+
+    // direct call if emitted in the reactor thread, queued if a plugin uses a worker thread
+    connect(device, &QCanBusDevice::framesReceived, d->context, [d, device, channel]() {
+        d->collectFrames(device, channel);
+    });
+    // frames may have arrived before the device was adopted, the device may be
+    // deleted before the call is processed
+    QMetaObject::invokeMethod(d->context, [d, guard = QPointer(device), channel]() {
+        if (guard && guard->state() == QCanBusDevice::ConnectedState)
+            d->collectFrames(guard, channel);
+    });
+
+    return channel;
+}
+
+/*!
+    Removes \a device from the reactor and moves it back to the thread of
+    the reactor. Returns \c true on success; otherwise \c false.
+
+    Frames the reactor collected from \a device before remain available via
+    readAllFrames(). Frames \a device received, but the reactor did not
+    collect yet, stay in the device and can be read with
+    QCanBusDevice::readAllFrames().
+
+    \sa addDevice()
+*/
+bool QCanBusReactor::removeDevice(QCanBusDevice *device)
+{
+    Q_D(QCanBusReactor);
+
+    {
+        QMutexLocker locker(&d->devicesGuard);
+        const qsizetype channel = device ? d->devices.indexOf(device) : -1;
+        if (Q_UNLIKELY(channel < 0)) {
+            qCWarning(QT_CANBUS, "QCanBusReactor::removeDevice(): Unknown device.");
+            return false;
+        }
+        d->devices[channel] = nullptr;
+    }
+
+    d->releaseDevice(device, thread());
+    return true;
+}
+
+/*!
+    Returns the device adopted as \a channel, or \c nullptr if there is
+    no such device.
+
+    \sa addDevice(), devices()
+*/
+QCanBusDevice *QCanBusReactor::device(qsizetype channel) const
+{
+    Q_D(const QCanBusReactor);
+
+    QMutexLocker locker(&d->devicesGuard);
+    if (channel < 0 || channel >= d->devices.size())
+        return nullptr;
+    return d->devices.at(channel);
+}
+
+/*!
+    Returns the adopted devices. The index of a device in the returned list
+    equals its channel; channels of removed devices hold \c nullptr.
+
+    \sa device()
+*/
+QList<QCanBusDevice *> QCanBusReactor::devices() const
+{
+    Q_D(const QCanBusReactor);
+
+    QMutexLocker locker(&d->devicesGuard);
+    QList<QCanBusDevice *> result;
+    result.reserve(d->devices.size());
+    for (const QPointer<QCanBusDevice> &device : d->devices)
+        result.append(device.data());
+    return result;
+}
+
+/*!
+    Schedules \a frame to be written by the device adopted as \a channel.
+    The frame is passed to QCanBusDevice::writeFrame() in the reactor thread.
+
+    Returns \c true if the frame was scheduled; otherwise \c false, i.e. if
+    there is no device for \a channel. Errors occurring during the write
+    operation are reported by the device's QCanBusDevice::errorOccurred() signal.
+
+    This function is thread-safe.
+*/
+bool QCanBusReactor::writeFrame(qsizetype channel, const QCanBusFrame &frame)
+{
+    Q_D(QCanBusReactor);
+
+    // locked while posting, so that the device cannot be removed meanwhile
+    QMutexLocker locker(&d->devicesGuard);
+    QCanBusDevice *canDevice = channel >= 0 && channel < d->devices.size()
+            ? d->devices.at(channel).data() : nullptr;
+    if (Q_UNLIKELY(!canDevice))
+        return false;
+
+    QMetaObject::invokeMethod(canDevice, [canDevice, frame]() {
+        canDevice->writeFrame(frame);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+/*!
+    Returns the number of received frames that are available for reading.
+
+    \sa readAllFrames()
+*/
+qsizetype QCanBusReactor::framesAvailable() const
+{
+    Q_D(const QCanBusReactor);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    return d->incomingFrames.size();
+}
+
+/*!
+    Returns all received frames and removes them from the reactor.
+
+    Within each batch announced by \l framesReceived(), frames are ordered by
+    their timestamps, regardless of the channel they were received on.
+
+    This function is thread-safe.
+
+    \sa framesAvailable(), framesReceived()
+*/
+QList<QCanBusReactor::Frame> QCanBusReactor::readAllFrames()
+{
+    Q_D(QCanBusReactor);
+
+    QMutexLocker locker(&d->incomingFramesGuard);
+    QList<Frame> result;
+    result.swap(d->incomingFrames);
+    return result;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qcanbusreactor.cpp"
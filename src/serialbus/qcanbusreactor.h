@@ -0,0 +1,50 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCANBUSREACTOR_H
+#define QCANBUSREACTOR_H
+
+#include <QtCore/qobject.h>
+#include <QtSerialBus/qcanbusframe.h>
+#include <QtSerialBus/qtserialbusglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+class QCanBusDevice;
+class QCanBusReactorPrivate;
+
+class Q_SERIALBUS_EXPORT QCanBusReactor : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QCanBusReactor)
+    Q_DISABLE_COPY(QCanBusReactor)
+
+public:
+    struct Frame
+    {
+        qsizetype channel = -1;
+        QCanBusFrame frame;
+    };
+
+    explicit QCanBusReactor(QObject *parent = nullptr);
+    ~QCanBusReactor() override;
+
+    qsizetype addDevice(QCanBusDevice *device);
+    bool removeDevice(QCanBusDevice *device);
+    QCanBusDevice *device(qsizetype channel) const;
+    QList<QCanBusDevice *> devices() const;
+
+    bool writeFrame(qsizetype channel, const QCanBusFrame &frame);
+
+    qsizetype framesAvailable() const;
+    QList<Frame> readAllFrames();
+
+Q_SIGNALS:
+    void framesReceived();
+};
+
+Q_DECLARE_TYPEINFO(QCanBusReactor::Frame, Q_RELOCATABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QCANBUSREACTOR_H
@@ -0,0 +1,59 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCANBUSREACTOR_P_H
+#define QCANBUSREACTOR_P_H
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+#include <QtSerialBus/qcanbusdevice.h>
+#include <QtSerialBus/qcanbusreactor.h>
+
+#include <private/qobject_p.h>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QCanBusReactorPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QCanBusReactor)
+public:
+    QCanBusReactorPrivate() {}
+
+    // called in the reactor thread only
+    void collectFrames(QCanBusDevice *device, qsizetype channel);
+    void deliverFrames();
+
+    void releaseDevice(QCanBusDevice *device, QThread *targetThread);
+
+    QThread thread;
+    // lives in the reactor thread and receives the signals of all devices
+    QObject *context = nullptr;
+
+    // index is the channel, removed devices leave a null entry behind
+    QList<QPointer<QCanBusDevice>> devices;
+    // written by the owner thread, read by writeFrame() and device() from any thread
+    mutable QMutex devicesGuard;
+
+    // frames of the current event loop iteration, reactor thread only
+    QList<QCanBusReactor::Frame> batch;
+    bool deliveryScheduled = false;
+
+    QList<QCanBusReactor::Frame> incomingFrames;
+    mutable QMutex incomingFramesGuard;
+};
+
+QT_END_NAMESPACE
+
+#endif // QCANBUSREACTOR_P_H
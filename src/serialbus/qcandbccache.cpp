@@ -0,0 +1,428 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qcandbccache_p.h"
+#include "qcandbcfileparser_p.h"
+#include "private/qcanmessagedescription_p.h"
+#include "private/qcansignaldescription_p.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/qendian.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The layout of a cache file:
+
+    Header:
+        char[8]     magic "QtDbcCa\0"
+        quint32     format version
+        quint8[32]  BLAKE2b-256 hash of the names and contents of the DBC files
+        quint32     number of strings, n
+        quint32     number of messages
+        quint32     number of messages with value descriptions
+        quint32     number of warnings
+
+    String table:
+        quint32[n]  end offset of each string, in UTF-16 code units
+        char16_t[]  UTF-16 data of all strings
+
+    Records:
+        messages, each followed by its signals and their multiplexor values
+        value descriptions, grouped by message and signal
+        warnings
+
+    String index 0 is reserved for the empty string, so string i is stored
+    as entry i - 1 of the string table.
+*/
+
+static constexpr char kMagic[8] = { 'Q', 't', 'D', 'b', 'c', 'C', 'a', '\0' };
+static constexpr qsizetype kHashSize = 32;
+static constexpr auto kHashAlgorithm = QCryptographicHash::Blake2b_256;
+static constexpr qsizetype kMinMessageSize = 5 * sizeof(quint32) + sizeof(quint8);
+
+namespace {
+
+class CacheWriter
+{
+public:
+    template <typename T>
+    void append(T value)
+    {
+        const T le = qToLittleEndian(value);
+        m_records.append(reinterpret_cast<const char *>(&le), sizeof(T));
+    }
+
+    void appendDouble(double value)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        append(bits);
+    }
+
+    void appendString(const QString &str)
+    {
+        if (str.isEmpty()) {
+            append(quint32(0));
+            return;
+        }
+        auto it = m_stringIndexes.constFind(str);
+        if (it == m_stringIndexes.constEnd()) {
+            m_strings.append(str);
+            it = m_stringIndexes.insert(str, quint32(m_strings.size()));
+        }
+        append(it.value());
+    }
+
+    QByteArray finish(QByteArrayView contentHash, quint32 messageCount,
+                      quint32 valueDescriptionCount, quint32 warningCount) const
+    {
+        QByteArray result;
+        const auto appendValue = [&result](quint32 value) {
+            const quint32 le = qToLittleEndian(value);
+            result.append(reinterpret_cast<const char *>(&le), sizeof(le));
+        };
+
+        result.append(kMagic, sizeof(kMagic));
+        appendValue(QCanDbcCache::Version);
+        result.append(contentHash);
+        appendValue(quint32(m_strings.size()));
+        appendValue(messageCount);
+        appendValue(valueDescriptionCount);
+        appendValue(warningCount);
+
+        quint32 end = 0;
+        for (const QString &str : m_strings) {
+            end += quint32(str.size());
+            appendValue(end);
+        }
+        for (const QString &str : m_strings) {
+            const qsizetype pos = result.size();
+            result.resize(pos + str.size() * sizeof(char16_t));
+            qToLittleEndian<char16_t>(str.utf16(), str.size(), result.data() + pos);
+        }
+
+        result.append(m_records);
+        return result;
+    }
+
+private:
+    QByteArray m_records;
+    QStringList m_strings;
+    QHash<QString, quint32> m_stringIndexes;
+};
+
+class CacheReader
+{
+public:
+    CacheReader(QByteArrayView data) : m_pos(data.data()), m_end(data.data() + data.size()) {}
+
+    bool isValid() const { return m_valid; }
+
+    template <typename T>
+    T read()
+    {
+        if (Q_UNLIKELY(m_end - m_pos < qsizetype(sizeof(T)))) {
+            m_valid = false;
+            return T{};
+        }
+        const T value = qFromLittleEndian<T>(m_pos);
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    double readDouble()
+    {
+        const quint64 bits = read<quint64>();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    QByteArrayView readBytes(qsizetype size)
+    {
+        if (Q_UNLIKELY(m_end - m_pos < size)) {
+            m_valid = false;
+            return {};
+        }
+        const QByteArrayView result(m_pos, size);
+        m_pos += size;
+        return result;
+    }
+
+    bool readStringTable(quint32 count)
+    {
+        const QByteArrayView ends = readBytes(qsizetype(count) * sizeof(quint32));
+        if (!m_valid)
+            return false;
+        m_stringEnds = ends.data();
+        const quint32 totalSize = count ? qFromLittleEndian<quint32>(
+                m_stringEnds + (count - 1) * sizeof(quint32)) : 0;
+        m_stringData = readBytes(qsizetype(totalSize) * sizeof(char16_t)).data();
+        m_strings.resize(count);
+        return m_valid;
+    }
+
+    // The strings are only converted when they are referenced for the first
+    // time. Repeated references, e.g. to units or receivers, share the data.
+    QString readString()
+    {
+        const quint32 idx = read<quint32>();
+        if (idx == 0)
+            return {};
+        if (Q_UNLIKELY(idx > quint32(m_strings.size()))) {
+            m_valid = false;
+            return {};
+        }
+        QString &str = m_strings[idx - 1];
+        if (str.isNull()) {
+            const auto endAt = [this](quint32 i) {
+                return qFromLittleEndian<quint32>(m_stringEnds + i * sizeof(quint32));
+            };
+            const quint32 begin = idx > 1 ? endAt(idx - 2) : 0;
+            const quint32 end = endAt(idx - 1);
+            const quint32 total = endAt(quint32(m_strings.size()) - 1);
+            if (Q_UNLIKELY(begin >= end || end > total)) {
+                m_valid = false;
+                return {};
+            }
+            str.resize(end - begin);
+            qFromLittleEndian<char16_t>(m_stringData + begin * sizeof(char16_t), end - begin,
+                                        str.data());
+        }
+        return str;
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+    const char *m_stringEnds = nullptr;
+    const char *m_stringData = nullptr;
+    QList<QString> m_strings;
+    bool m_valid = true;
+};
+
+} // namespace
+
+/*!
+    \internal
+    Returns the hash of the \a fileNames and \a contents of the DBC files,
+    which is used to detect a stale cache. The names are part of the hash,
+    since the cached results refer to the files they were parsed from.
+*/
+QByteArray QCanDbcCache::contentHash(const QStringList &fileNames,
+                                     const QList<QByteArrayView> &contents)
+{
+    Q_ASSERT(fileNames.size() == contents.size());
+
+    QCryptographicHash hash(kHashAlgorithm);
+    // include the sizes, so that the boundaries are part of the hash
+    auto addData = [&hash](QByteArrayView data) {
+        const quint64 size = qToLittleEndian(quint64(data.size()));
+        hash.addData(QByteArrayView(reinterpret_cast<const char *>(&size), sizeof(size)));
+        hash.addData(data);
+    };
+    for (qsizetype i = 0; i < contents.size(); ++i) {
+        addData(fileNames.at(i).toUtf8());
+        addData(contents.at(i));
+    }
+    return hash.result();
+}
+
+/*!
+    \internal
+    Writes the results of \a parser to the cache file \a fileName. Returns
+    \c false if the file cannot be written, or if the results contain data
+    that the cache does not support.
+*/
+bool QCanDbcCache::write(const QString &fileName, QByteArrayView contentHash,
+                         const QCanDbcFileParserPrivate &parser)
+{
+    Q_ASSERT(contentHash.size() == kHashSize);
+
+    CacheWriter writer;
+    for (const QCanMessageDescription &message : parser.m_messageDescriptions) {
+        const auto *messageData = QCanMessageDescriptionPrivate::get(message);
+        writer.append(quint32(qToUnderlying(messageData->id)));
+        writer.append(messageData->size);
+        writer.appendString(messageData->name);
+        writer.appendString(messageData->transmitter);
+        writer.appendString(messageData->comment);
+        writer.append(quint32(messageData->messageSignals.size()));
+        for (const QCanSignalDescription &signal : messageData->messageSignals) {
+            const auto *signalData = QCanSignalDescriptionPrivate::get(signal);
+            writer.appendString(signalData->name);
+            writer.appendString(signalData->unit);
+            writer.appendString(signalData->receiver);
+            writer.appendString(signalData->comment);
+            writer.append(quint8(signalData->source));
+            writer.append(quint8(signalData->endian));
+            writer.append(quint8(signalData->format));
+            writer.append(quint8(signalData->muxState));
+            writer.append(signalData->startBit);
+            writer.append(signalData->dataLength);
+            writer.appendDouble(signalData->factor);
+            writer.appendDouble(signalData->offset);
+            writer.appendDouble(signalData->scaling);
+            writer.appendDouble(signalData->minimum);
+            writer.appendDouble(signalData->maximum);
+            writer.append(quint32(signalData->muxSignals.size()));
+            for (auto it = signalData->muxSignals.cbegin(); it != signalData->muxSignals.cend();
+                 ++it) {
+                writer.appendString(it.key());
+                writer.append(quint32(it.value().size()));
+                for (const auto &range : it.value()) {
+                    // the parser only creates unsigned integer ranges
+                    if (range.minimum.typeId() != QMetaType::UInt
+                            || range.maximum.typeId() != QMetaType::UInt) {
+                        return false;
+                    }
+                    writer.append(range.minimum.toUInt());
+                    writer.append(range.maximum.toUInt());
+                }
+            }
+        }
+    }
+
+    for (auto it = parser.m_valueDescriptions.cbegin(); it != parser.m_valueDescriptions.cend();
+         ++it) {
+        writer.append(quint32(qToUnderlying(it.key())));
+        writer.append(quint32(it.value().size()));
+        for (auto sigIt = it.value().cbegin(); sigIt != it.value().cend(); ++sigIt) {
+            writer.appendString(sigIt.key());
+            writer.append(quint32(sigIt.value().size()));
+            for (auto valIt = sigIt.value().cbegin(); valIt != sigIt.value().cend(); ++valIt) {
+                writer.append(valIt.key());
+                writer.appendString(valIt.value());
+            }
+        }
+    }
+
+    for (const QString &warning : parser.m_warnings)
+        writer.appendString(warning);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(writer.finish(contentHash, quint32(parser.m_messageDescriptions.size()),
+                             quint32(parser.m_valueDescriptions.size()),
+                             quint32(parser.m_warnings.size())));
+    return file.commit();
+}
+
+/*!
+    \internal
+    Reads the cache file \a fileName into \a parser. Returns \c false and
+    leaves \a parser unchanged if the file does not exist, is corrupted, or
+    does not match \a contentHash.
+*/
+bool QCanDbcCache::read(const QString &fileName, QByteArrayView contentHash,
+                        QCanDbcFileParserPrivate *parser)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray fileData;
+    QByteArrayView data;
+    if (const uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr) {
+        data = QByteArrayView(mapped, file.size());
+    } else {
+        fileData = file.readAll();
+        data = fileData;
+    }
+
+    CacheReader reader(data);
+    if (reader.readBytes(sizeof(kMagic)) != QByteArrayView(kMagic, sizeof(kMagic))
+            || reader.read<quint32>() != Version
+            || reader.readBytes(kHashSize) != contentHash) {
+        return false;
+    }
+
+    const quint32 stringCount = reader.read<quint32>();
+    const quint32 messageCount = reader.read<quint32>();
+    const quint32 valueDescriptionCount = reader.read<quint32>();
+    const quint32 warningCount = reader.read<quint32>();
+    if (!reader.readStringTable(stringCount))
+        return false;
+
+    // the counts are not trusted before the data is read completely
+    QHash<QtCanBus::UniqueId, QCanMessageDescription> messages;
+    messages.reserve(qMin(qsizetype(messageCount), data.size() / kMinMessageSize));
+    for (quint32 i = 0; i < messageCount && reader.isValid(); ++i) {
+        QCanMessageDescription message;
+        auto *messageData = QCanMessageDescriptionPrivate::get(message);
+        messageData->id = QtCanBus::UniqueId{reader.read<quint32>()};
+        messageData->size = reader.read<quint8>();
+        messageData->name = reader.readString();
+        messageData->transmitter = reader.readString();
+        messageData->comment = reader.readString();
+        const quint32 signalCount = reader.read<quint32>();
+        for (quint32 j = 0; j < signalCount && reader.isValid(); ++j) {
+            QCanSignalDescription signal;
+            auto *signalData = QCanSignalDescriptionPrivate::get(signal);
+            signalData->name = reader.readString();
+            signalData->unit = reader.readString();
+            signalData->receiver = reader.readString();
+            signalData->comment = reader.readString();
+            signalData->source = QtCanBus::DataSource(reader.read<quint8>());
+            signalData->endian = QSysInfo::Endian(reader.read<quint8>());
+            signalData->format = QtCanBus::DataFormat(reader.read<quint8>());
+            signalData->muxState = QtCanBus::MultiplexState(reader.read<quint8>());
+            signalData->startBit = reader.read<quint16>();
+            signalData->dataLength = reader.read<quint16>();
+            signalData->factor = reader.readDouble();
+            signalData->offset = reader.readDouble();
+            signalData->scaling = reader.readDouble();
+            signalData->minimum = reader.readDouble();
+            signalData->maximum = reader.readDouble();
+            const quint32 muxCount = reader.read<quint32>();
+            for (quint32 k = 0; k < muxCount && reader.isValid(); ++k) {
+                const QString name = reader.readString();
+                const quint32 rangeCount = reader.read<quint32>();
+                QCanSignalDescription::MultiplexValues ranges;
+                for (quint32 r = 0; r < rangeCount && reader.isValid(); ++r) {
+                    const quint32 min = reader.read<quint32>();
+                    const quint32 max = reader.read<quint32>();
+                    ranges.push_back({ min, max });
+                }
+                signalData->muxSignals.insert(name, ranges);
+            }
+            messageData->insertSignal(signal);
+        }
+        messages.insert(messageData->id, message);
+    }
+
+    QCanDbcFileParser::MessageValueDescriptions valueDescriptions;
+    for (quint32 i = 0; i < valueDescriptionCount && reader.isValid(); ++i) {
+        auto &signalDescriptions = valueDescriptions[QtCanBus::UniqueId{reader.read<quint32>()}];
+        const quint32 signalCount = reader.read<quint32>();
+        for (quint32 j = 0; j < signalCount && reader.isValid(); ++j) {
+            auto &values = signalDescriptions[reader.readString()];
+            const quint32 valueCount = reader.read<quint32>();
+            for (quint32 k = 0; k < valueCount && reader.isValid(); ++k) {
+                const quint32 value = reader.read<quint32>();
+                values.insert(value, reader.readString());
+            }
+        }
+    }
+
+    QStringList warnings;
+    for (quint32 i = 0; i < warningCount && reader.isValid(); ++i)
+        warnings.append(reader.readString());
+
+    if (!reader.isValid())
+        return false;
+
+    parser->m_messageDescriptions = std::move(messages);
+    parser->m_valueDescriptions = std::move(valueDescriptions);
+    parser->m_warnings = std::move(warnings);
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,53 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCANDBCCACHE_P_H
+#define QCANDBCCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+QT_BEGIN_NAMESPACE
+
+class QCanDbcFileParserPrivate;
+
+/*
+    Binary cache of the results of QCanDbcFileParser.
+
+    The cache file starts with a header, that contains a format version and
+    a hash of the parsed DBC files. All strings are stored once in a string
+    table, and the records refer to them by index. All values are stored in
+    little endian byte order.
+*/
+class QCanDbcCache
+{
+public:
+    // Increase the version whenever the format or the output of the parser
+    // changes, so that existing caches are considered stale.
+    static constexpr quint32 Version = 1;
+
+    static QByteArray contentHash(const QStringList &fileNames,
+                                  const QList<QByteArrayView> &contents);
+    static bool write(const QString &fileName, QByteArrayView contentHash,
+                      const QCanDbcFileParserPrivate &parser);
+    static bool read(const QString &fileName, QByteArrayView contentHash,
+                     QCanDbcFileParserPrivate *parser);
+};
+
+QT_END_NAMESPACE
+
+#endif // QCANDBCCACHE_P_H
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qcandbcfileparser.h"
+#include "qcandbccache_p.h"
 #include "qcandbcfileparser_p.h"
 #include "qcanmessagedescription.h"
 #include "qcansignaldescription.h"
@@ -10,12 +11,22 @@
 #include "private/qcansignaldescription_p.h"
 
 #include <QtCore/QFile>
-#include <QtCore/QRegularExpression>
-
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVarLengthArray>
+
+#include <atomic>
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
+Q_DECLARE_LOGGING_CATEGORY(QT_CANBUS)
+
 /*!
     \class QCanDbcFileParser
     \inmodule QtSerialBus
@@ -56,6 +67,13 @@ QT_BEGIN_NAMESPACE
     Use the static \l uniqueIdDescription() function to get a
     \l QCanUniqueIdDescription for the DBC format.
 
+    Large databases often describe many more messages than a single
+    application needs. Enable \l {setLazyLoading()}{lazy loading} to only
+    index the messages while parsing, and to parse their signals, comments and
+    value descriptions on first use. Pass the \l messageDescriptionProvider()
+    to \l QCanFrameProcessor to do this for the messages of the processed
+    frames.
+
     \code
     QCanDbcFileParser fileParser;
     const bool result = fileParser.parse(u"path/to/file.dbc"_s);
@@ -93,7 +111,8 @@ QT_BEGIN_NAMESPACE
 /*!
     \typealias QCanDbcFileParser::ValueDescriptions
 
-    This is a type alias for \c {QHash<quint32, QString>}.
+    This is a type alias for \c {QHash<quint32, QString>}, the same type as
+    \l QCanFrameProcessor::ValueDescriptions.
 
     The keys of the hash represent raw signal values, and the values of the
     hash represent corresponding string descriptions.
@@ -170,7 +189,7 @@ QCanDbcFileParser::~QCanDbcFileParser() = default;
 bool QCanDbcFileParser::parse(const QString &fileName)
 {
     d->reset();
-    return d->parseFile(fileName);
+    return d->parseFiles({ fileName });
 }
 
 /*!
@@ -197,11 +216,7 @@ bool QCanDbcFileParser::parse(const QString &fileName)
 bool QCanDbcFileParser::parse(const QStringList &fileNames)
 {
     d->reset();
-    for (const auto &fileName : fileNames) {
-        if (!d->parseFile(fileName))
-            return false;
-    }
-    return true;
+    return d->parseFiles(fileNames);
 }
 
 /*!
@@ -241,11 +256,109 @@ bool QCanDbcFileParser::parseData(QStringView data)
     return d->parseData(data);
 }
 
+/*!
+    \since 6.7
+
+    Returns the name of the cache file used by \l parse(), or an empty string
+    if no cache is used.
+
+    \sa setCacheFileName()
+*/
+QString QCanDbcFileParser::cacheFileName() const
+{
+    return d->m_cacheFileName;
+}
+
+/*!
+    \since 6.7
+
+    Sets the name of the cache file used by \l parse() to \a fileName. Pass
+    an empty string to disable the cache, which is the default.
+
+    Parsing large DBC files can take a significant amount of time. If a cache
+    file is set, \l parse() stores its results, including the value
+    descriptions and the warnings, in a compact binary form in this file.
+    The next \l parse() call with the same input files reads the results
+    from the cache instead of parsing the files again.
+
+    The cache file contains a hash of the names and contents of the parsed
+    files. If any of the files changed, or other files are parsed, the
+    cache is considered stale. The files are
+    then parsed again and the cache file is replaced. A cache file that
+    cannot be read is handled the same way.
+
+    The cache is not used by \l parseData().
+
+    \code
+    QCanDbcFileParser parser;
+    parser.setCacheFileName(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                            + u"/vehicle.dbccache"_s);
+    const bool result = parser.parse(fileNames);
+    \endcode
+
+    \sa cacheFileName(), parse()
+*/
+void QCanDbcFileParser::setCacheFileName(const QString &fileName)
+{
+    d->m_cacheFileName = fileName;
+}
+
+/*!
+    \since 6.7
+
+    Returns \c true if lazy loading is enabled; otherwise \c false.
+
+    \sa setLazyLoading()
+*/
+bool QCanDbcFileParser::lazyLoading() const
+{
+    return d->m_lazyLoading;
+}
+
+/*!
+    \since 6.7
+
+    Enables lazy loading if \a enabled is \c true, and disables it otherwise.
+    Lazy loading is disabled by default. The setting is used by the following
+    \l parse() and \l parseData() calls.
+
+    With lazy loading, parsing only reads the message definitions (\c BO_)
+    and records which lines of the input belong to each message. The signals,
+    comments, value descriptions and multiplexing descriptions of a message
+    are parsed when its description is requested for the first time, e.g. by
+    a \l QCanFrameProcessor that uses the \l messageDescriptionProvider().
+    The startup cost then depends on the number of messages that are actually
+    used, rather than on the size of the database. The parser keeps the input
+    files open and memory-mapped, or keeps a copy of the input data, as long
+    as the results of the parsing are in use.
+
+    The hard errors, like misplaced sections, are detected while parsing, as
+    usual. The \l warnings() only contain the problems that are found while
+    indexing, like malformed message definitions or repeated unique ids. The
+    first definition of a unique id is used, even if it turns out to be
+    invalid. Problems with the remaining contents of a message are logged
+    using the \c qt.canbus logging category when the message is parsed.
+
+    \l messageDescriptions() and \l messageValueDescriptions() still return
+    the results for all messages. Calling them parses all remaining messages.
+
+    The \l {setCacheFileName()}{cache} is not used with lazy loading.
+
+    \sa lazyLoading(), messageDescriptionProvider()
+*/
+void QCanDbcFileParser::setLazyLoading(bool enabled)
+{
+    d->m_lazyLoading = enabled;
+}
+
 /*!
     Returns the list of message descriptions that were extracted during the
     last \l parse() call.
 
-    \sa parse(), error()
+    With \l {setLazyLoading()}{lazy loading}, this method parses all messages
+    that were not used so far.
+
+    \sa parse(), error(), messageDescriptionProvider()
 */
 QList<QCanMessageDescription> QCanDbcFileParser::messageDescriptions() const
 {
@@ -264,15 +377,48 @@ QList<QCanMessageDescription> QCanDbcFileParser::messageDescriptions() const
     message unique id and the signal name, as well as the actual value
     descriptions.
 
+    The result can be passed to \l QCanFrameProcessor::setValueDescriptions()
+    to look up the descriptions of decoded signal values.
+
     \sa QCanDbcFileParser::MessageValueDescriptions,
     QCanDbcFileParser::SignalValueDescriptions,
     QCanDbcFileParser::ValueDescriptions
 */
 QCanDbcFileParser::MessageValueDescriptions QCanDbcFileParser::messageValueDescriptions() const
 {
+    if (d->m_lazyIndex)
+        return d->m_lazyIndex->messageValueDescriptions();
     return d->m_valueDescriptions;
 }
 
+/*!
+    \since 6.7
+
+    Returns a function that provides the message descriptions that were
+    extracted during the last \l parse() call, one unique id at a time.
+
+    Pass it to \l QCanFrameProcessor::setMessageDescriptionProvider() to
+    load the message descriptions into the frame processor on demand. With
+    \l {setLazyLoading()}{lazy loading}, each message is only parsed when it
+    is requested for the first time.
+
+    The function stays valid if this parser is destroyed or used for parsing
+    other files. It may be called from several threads at the same time.
+
+    \sa setLazyLoading(), messageDescriptions()
+*/
+QCanFrameProcessor::MessageDescriptionProvider QCanDbcFileParser::messageDescriptionProvider() const
+{
+    if (d->m_lazyIndex) {
+        return [index = d->m_lazyIndex](QtCanBus::UniqueId uid) {
+            return index->messageDescription(uid);
+        };
+    }
+    return [messages = d->m_messageDescriptions](QtCanBus::UniqueId uid) {
+        return messages.value(uid);
+    };
+}
+
 /*!
     Returns the last error which occurred during the parsing.
 
@@ -343,16 +489,325 @@ static constexpr auto kCommentDef = "CM_ "_L1;
 static constexpr auto kExtendedMuxDef = "SG_MUL_VAL_ "_L1;
 static constexpr auto kValDef = "VAL_ "_L1;
 
-static constexpr auto kUnsignedIntRegExp = "\\d+"_L1;
-static constexpr auto kDoubleRegExp = "[+-]?\\d+(.\\d+([eE][+-]?\\d+)?)?"_L1;
-static constexpr auto kDbcIdentRegExp = "[_[:alpha:]][_[:alnum:]]+"_L1;
-static constexpr auto kOneOrMoreSpaceRegExp = "[ ]+"_L1;
-static constexpr auto kMaybeSpaceRegExp = "[ ]*"_L1;
-static constexpr auto kMuxIndicatorRegExp = "M|m\\d+M?"_L1;
-static constexpr auto kByteOrderRegExp = "0|1"_L1;
-static constexpr auto kValueTypeRegExp = "\\+|\\-"_L1;
-// The pattern matches all printable characters, except double-quote (") and backslash (\).
-static constexpr auto kCharStrRegExp = "((?![\\\"\\\\])\\P{Cc})*"_L1;
+// The parser works on two kinds of input. Files are memory-mapped and parsed
+// as raw UTF-8 bytes (QByteArrayView), and parseData() passes the UTF-16
+// input (QStringView). Only the final strings, like the names, units and
+// comments, are converted to QString.
+
+static QString toQString(QStringView view)
+{
+    return view.toString();
+}
+
+static QString toQString(QByteArrayView view)
+{
+    return QString::fromUtf8(view);
+}
+
+static bool startsWith(QStringView view, QLatin1StringView prefix)
+{
+    return view.startsWith(prefix);
+}
+
+static bool startsWith(QByteArrayView view, QLatin1StringView prefix)
+{
+    return view.startsWith(QByteArrayView(prefix.data(), prefix.size()));
+}
+
+template <typename View>
+static char16_t charAt(View view, qsizetype idx)
+{
+    if constexpr (std::is_same_v<View, QStringView>)
+        return view[idx].unicode();
+    else
+        return static_cast<uchar>(view[idx]);
+}
+
+// Letters and digits are ASCII only, like the \d, [:alpha:] and [:alnum:]
+// classes of QRegularExpression without UseUnicodePropertiesOption, which
+// the parser used before.
+static constexpr bool isDigit(char16_t c)
+{
+    return c >= u'0' && c <= u'9';
+}
+
+static constexpr bool isIdentifierStart(char16_t c)
+{
+    return (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') || c == u'_';
+}
+
+static constexpr bool isIdentifierChar(char16_t c)
+{
+    return isIdentifierStart(c) || isDigit(c);
+}
+
+/*!
+    \internal
+    A single-pass tokenizer for one line of a DBC file.
+
+    Each method consumes one token and returns \c true, or returns \c false
+    and leaves the current position unchanged if the input does not start with
+    such a token. This allows to express the grammar of each DBC section as a
+    sequence of calls joined by \c{&&}. The grammar used to be expressed with
+    regular expressions, so the comments keep the equivalent patterns.
+*/
+template <typename View>
+class DbcTokenizer
+{
+public:
+    explicit DbcTokenizer(View data) : m_data(data) {}
+
+    qsizetype position() const { return m_pos; }
+    void setPosition(qsizetype pos) { m_pos = pos; }
+
+    View sliced(qsizetype from, qsizetype to) const { return m_data.sliced(from, to - from); }
+
+    // "[ ]*"
+    bool maybeSpaces()
+    {
+        while (m_pos < m_data.size() && at(m_pos) == u' ')
+            ++m_pos;
+        return true;
+    }
+
+    // "[ ]+"
+    bool spaces()
+    {
+        const qsizetype start = m_pos;
+        maybeSpaces();
+        return m_pos > start;
+    }
+
+    bool character(char16_t c)
+    {
+        if (m_pos >= m_data.size() || at(m_pos) != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    // any single character of chars, e.g. "0|1"
+    bool oneOf(QLatin1StringView chars, View *result)
+    {
+        if (m_pos >= m_data.size())
+            return false;
+        const char16_t c = at(m_pos);
+        for (qsizetype i = 0; i < chars.size(); ++i) {
+            if (c == static_cast<uchar>(chars.data()[i])) {
+                *result = sliced(m_pos, m_pos + 1);
+                ++m_pos;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool keyword(QLatin1StringView text)
+    {
+        if (m_data.size() - m_pos < text.size())
+            return false;
+        for (qsizetype i = 0; i < text.size(); ++i) {
+            if (at(m_pos + i) != static_cast<uchar>(text.data()[i]))
+                return false;
+        }
+        m_pos += text.size();
+        return true;
+    }
+
+    // "\d+"
+    bool unsignedInt(View *result)
+    {
+        const qsizetype start = m_pos;
+        skipDigits();
+        return finish(start, m_pos > start, result);
+    }
+
+    // "[_[:alpha:]][_[:alnum:]]+"
+    bool identifier(View *result)
+    {
+        const qsizetype start = m_pos;
+        if (m_pos < m_data.size() && isIdentifierStart(at(m_pos))) {
+            ++m_pos;
+            while (m_pos < m_data.size() && isIdentifierChar(at(m_pos)))
+                ++m_pos;
+        }
+        return finish(start, m_pos - start > 1, result);
+    }
+
+    // "[+-]?\d+(\.\d+([eE][+-]?\d+)?)?"
+    bool number(View *result)
+    {
+        const qsizetype start = m_pos;
+        if (m_pos < m_data.size() && (at(m_pos) == u'+' || at(m_pos) == u'-'))
+            ++m_pos;
+        const qsizetype digitsStart = m_pos;
+        skipDigits();
+        if (m_pos == digitsStart)
+            return finish(start, false, result);
+
+        if (m_pos + 1 < m_data.size() && at(m_pos) == u'.' && isDigit(at(m_pos + 1))) {
+            ++m_pos;
+            skipDigits();
+            // the exponent is only consumed if it is complete
+            const qsizetype exponentStart = m_pos;
+            if (m_pos < m_data.size() && (at(m_pos) == u'e' || at(m_pos) == u'E')) {
+                ++m_pos;
+                if (m_pos < m_data.size() && (at(m_pos) == u'+' || at(m_pos) == u'-'))
+                    ++m_pos;
+                const qsizetype exponentDigits = m_pos;
+                skipDigits();
+                if (m_pos == exponentDigits)
+                    m_pos = exponentStart;
+            }
+        }
+        return finish(start, true, result);
+    }
+
+    // "M|m\d+M?"
+    bool muxIndicator(View *result)
+    {
+        const qsizetype start = m_pos;
+        if (character(u'M'))
+            return finish(start, true, result);
+        if (!character(u'm'))
+            return false;
+        const qsizetype digitsStart = m_pos;
+        skipDigits();
+        if (m_pos == digitsStart)
+            return finish(start, false, result);
+        character(u'M');
+        return finish(start, true, result);
+    }
+
+    // "\"((?![\"\\\\])\P{Cc})*\"", the result does not include the quotes
+    bool charString(View *result)
+    {
+        const qsizetype start = m_pos;
+        if (!character(u'"'))
+            return false;
+        const qsizetype contentStart = m_pos;
+        while (m_pos < m_data.size() && isCharStringChar(m_pos))
+            ++m_pos;
+        const qsizetype contentEnd = m_pos;
+        if (!character(u'"'))
+            return finish(start, false, result);
+        *result = sliced(contentStart, contentEnd);
+        return true;
+    }
+
+private:
+    char16_t at(qsizetype idx) const { return charAt(m_data, idx); }
+
+    void skipDigits()
+    {
+        while (m_pos < m_data.size() && isDigit(at(m_pos)))
+            ++m_pos;
+    }
+
+    bool finish(qsizetype start, bool matched, View *result)
+    {
+        if (!matched) {
+            m_pos = start;
+            return false;
+        }
+        *result = sliced(start, m_pos);
+        return true;
+    }
+
+    // All printable characters, except double-quote (") and backslash (\).
+    bool isCharStringChar(qsizetype idx) const
+    {
+        const char16_t c = at(idx);
+        if (c < 0x20 || c == 0x7F || c == u'"' || c == u'\\')
+            return false;
+        if constexpr (std::is_same_v<View, QStringView>) {
+            return c < 0x80 || c > 0x9F; // C1 control characters
+        } else {
+            // C1 control characters are encoded as 0xC2 0x80..0x9F
+            if (c != 0xC2 || idx + 1 >= m_data.size())
+                return true;
+            const char16_t next = at(idx + 1);
+            return next < 0x80 || next > 0x9F;
+        }
+    }
+
+    View m_data;
+    qsizetype m_pos = 0;
+};
+
+template <typename View>
+static bool isExtraData(View view)
+{
+    return startsWith(view, kSigValTypeDef) || startsWith(view, kCommentDef)
+            || startsWith(view, kExtendedMuxDef) || startsWith(view, kValDef);
+}
+
+static qsizetype indexOfNewline(QStringView view, qsizetype from)
+{
+    return view.indexOf(u'\n', from);
+}
+
+static qsizetype indexOfNewline(QByteArrayView view, qsizetype from)
+{
+    return view.indexOf('\n', from);
+}
+
+/*!
+    \internal
+    Calls \a func for each trimmed line of \a content in the range
+    [\a from, \a to), together with the offset of the line. Stops and returns
+    \c false as soon as \a func returns \c false.
+*/
+template <typename View, typename Func>
+static bool forEachLine(View content, qsizetype from, qsizetype to, Func func)
+{
+    while (from < to) {
+        const qsizetype idx = indexOfNewline(content, from);
+        const qsizetype lineEnd = (idx == -1 || idx > to) ? to : idx;
+        if (!func(content.sliced(from, lineEnd - from).trimmed(), from))
+            return false;
+        from = lineEnd + 1;
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Runs \a job for each index in [0, \a count) using the global thread pool.
+    The calling thread takes part in the work, so that the jobs are finished
+    even if all threads of the pool are busy.
+*/
+template <typename Job>
+static void runConcurrently(qsizetype count, Job job)
+{
+    if (count <= 1) {
+        if (count == 1)
+            job(0);
+        return;
+    }
+
+    // Helpers that start after all jobs are taken return immediately, so
+    // they must not refer to the stack of this function.
+    struct State
+    {
+        std::atomic<qsizetype> next = 0;
+        QSemaphore done;
+    };
+    const auto state = std::make_shared<State>();
+    const auto run = [state, count, &job]() {
+        for (qsizetype i = state->next++; i < count; i = state->next++) {
+            job(i);
+            state->done.release();
+        }
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype helpers = qMin(count, qsizetype(pool->maxThreadCount())) - 1;
+    for (qsizetype i = 0; i < helpers; ++i)
+        pool->start(run);
+    run();
+    state->done.acquire(int(count));
+}
 
 void QCanDbcFileParserPrivate::reset()
 {
@@ -366,54 +821,84 @@ void QCanDbcFileParserPrivate::reset()
     m_currentMessage = {};
     m_messageDescriptions.clear();
     m_valueDescriptions.clear();
+    m_stringPool.clear();
+    m_lazyIndex.reset();
 }
 
 /*!
     \internal
     Returns \c false only in case of hard error. Returns \c true even if some
     warnings occurred during parsing.
+
+    The files are parsed in place if they can be memory-mapped.
 */
-bool QCanDbcFileParserPrivate::parseFile(const QString &fileName)
+bool QCanDbcFileParserPrivate::parseFiles(const QStringList &fileNames)
 {
-    QFile f(fileName);
-    if (!f.open(QIODevice::ReadOnly)) {
-        m_error = QCanDbcFileParser::Error::FileReading;
-        m_errorString = f.errorString();
-        return false;
+    // The files must stay open until the parsing is finished
+    std::vector<std::unique_ptr<QFile>> files;
+    QList<QByteArray> fileData;
+    QList<QByteArrayView> contents;
+    QString openErrorString;
+    for (const QString &fileName : fileNames) {
+        auto f = std::make_unique<QFile>(fileName);
+        if (!f->open(QIODevice::ReadOnly)) {
+            openErrorString = f->errorString();
+            break;
+        }
+        // Fall back to reading the whole file if it cannot be mapped (e.g.
+        // for empty files or special file systems).
+        if (const uchar *mapped = f->size() > 0 ? f->map(0, f->size()) : nullptr) {
+            contents.append(QByteArrayView(mapped, f->size()));
+        } else {
+            fileData.append(f->readAll());
+            contents.append(fileData.constLast());
+        }
+        files.push_back(std::move(f));
     }
-    m_fileName = fileName;
-    m_seenExtraData = false;
 
-    while (!f.atEnd()) {
-        const QString str = QString::fromUtf8(f.readLine().trimmed());
-        if (!processLine({str.constData(), str.size()})) // also sets the error properly
-            return false;
+    QByteArray contentHash;
+    const bool useCache = !m_lazyLoading && !m_cacheFileName.isEmpty()
+            && contents.size() == fileNames.size();
+    if (useCache) {
+        contentHash = QCanDbcCache::contentHash(fileNames, contents);
+        if (QCanDbcCache::read(m_cacheFileName, contentHash, this)) {
+            m_fileName = fileNames.isEmpty() ? QString() : fileNames.constLast();
+            return true;
+        }
     }
-    addCurrentMessage(); // check if we need to add the message
-    // now when we parsed the whole file, we can verify the signal multiplexing
-    postProcessSignalMultiplexing();
 
-    return true;
-}
-
-struct ReadData
-{
-    qsizetype index;
-    QStringView result;
-};
+    // The files that were opened before the failing one are still parsed.
+    const QStringList openedFileNames = fileNames.first(contents.size());
+    if (m_lazyLoading) {
+        // The messages are parsed later, so the index takes over the files.
+        m_lazyIndex = std::make_shared<QCanDbcLazyIndex>();
+        m_lazyIndex->fileNames = openedFileNames;
+        m_lazyIndex->files = std::move(files);
+        m_lazyIndex->fileData = std::move(fileData);
+        m_lazyIndex->contents = contents;
+        if (!indexContents(contents))
+            return false;
+    } else if (!parseContents(contents, openedFileNames)) {
+        return false;
+    }
 
-static ReadData readUntilNewline(QStringView in, qsizetype from)
-{
-    const qsizetype idx = in.indexOf('\n'_L1, from);
+    if (contents.size() < fileNames.size()) {
+        m_error = QCanDbcFileParser::Error::FileReading;
+        m_errorString = openErrorString;
+        return false;
+    }
 
-    return (idx == -1) ? ReadData{idx, in.sliced(from).trimmed()}
-                       : ReadData{idx, in.sliced(from, idx - from).trimmed()};
+    if (useCache && !QCanDbcCache::write(m_cacheFileName, contentHash, *this)) {
+        qCWarning(QT_CANBUS, "QCanDbcFileParser: Failed to write the cache file %ls.",
+                  qUtf16Printable(m_cacheFileName));
+    }
+    return true;
 }
 
 /*!
     \internal
-    The implementation basically copies parseFile(), including all
-    post-processing. The only difference is in extracting the data.
+    Returns \c false only in case of hard error. Returns \c true even if some
+    warnings occurred during parsing.
 */
 bool QCanDbcFileParserPrivate::parseData(QStringView data)
 {
@@ -422,29 +907,153 @@ bool QCanDbcFileParserPrivate::parseData(QStringView data)
         m_errorString = QObject::tr("Empty input data.");
         return false;
     }
-    m_seenExtraData = false;
-    qsizetype from = 0;
-    while (true) {
-        const auto [idx, sv] = readUntilNewline(data, from);
-        if (!processLine(sv))
+    if (m_lazyLoading) {
+        // The messages are parsed later, so the index needs its own copy.
+        m_lazyIndex = std::make_shared<QCanDbcLazyIndex>();
+        m_lazyIndex->fileNames = QStringList{ QString() };
+        m_lazyIndex->data = data.toString();
+        return indexContents(QList<QStringView>{ m_lazyIndex->data });
+    }
+    return parseContents(QList<QStringView>{ data }, QStringList{ QString() });
+}
+
+/*!
+    \internal
+    Parses the \a contents of several DBC files, named \a fileNames.
+
+    The message definitions (\c BO_ and \c SG_) of all files make up most of
+    the data, and are parsed in parallel. Each file is split into chunks at
+    the \c BO_ lines that precede the first line with extra data, like
+    comments or value descriptions. The chunks are parsed by separate worker
+    instances, which record the completed messages and the warnings in order.
+
+    Afterwards the results are merged file by file, in the same order as a
+    sequential parser would produce them. This detects duplicate unique ids
+    deterministically. The extra data refers to the merged messages, so it is
+    parsed sequentially after merging the chunks of the file.
+
+    Returns \c false only in case of hard error.
+*/
+template <typename View>
+bool QCanDbcFileParserPrivate::parseContents(const QList<View> &contents,
+                                             const QStringList &fileNames)
+{
+    qsizetype totalSize = 0;
+    for (const View &content : contents)
+        totalSize += content.size();
+    const qsizetype chunkSize =
+            qMax(kMinChunkSize,
+                 totalSize / (qMax(QThreadPool::globalInstance()->maxThreadCount(), 1) * 4));
+
+    QList<MessageChunk> chunks;
+    QList<qsizetype> extraDataStarts(contents.size(), 0);
+    for (qsizetype i = 0; i < contents.size(); ++i) {
+        const View content = contents.at(i);
+        MessageChunk chunk;
+        chunk.file = i;
+        chunk.end = content.size();
+        forEachLine(content, 0, content.size(), [&](View line, qsizetype lineStart) {
+            if (startsWith(line, kMessageDef)) {
+                if (lineStart - chunk.begin >= chunkSize) {
+                    chunk.end = lineStart;
+                    chunks.append(std::exchange(chunk, MessageChunk{}));
+                    chunk.file = i;
+                    chunk.begin = lineStart;
+                    chunk.end = content.size();
+                }
+            } else if (isExtraData(line)) {
+                chunk.end = lineStart;
+                return false;
+            }
+            return true;
+        });
+        extraDataStarts[i] = chunk.end;
+        chunks.append(std::move(chunk));
+    }
+
+    runConcurrently(chunks.size(), [&](qsizetype i) {
+        MessageChunk &chunk = chunks[i];
+        QCanDbcFileParserPrivate worker;
+        worker.m_fileName = fileNames.at(chunk.file);
+        worker.m_chunk = &chunk;
+        worker.parseChunk(contents.at(chunk.file));
+    });
+
+    auto chunk = chunks.begin();
+    for (qsizetype i = 0; i < contents.size(); ++i) {
+        const View content = contents.at(i);
+        m_fileName = fileNames.at(i);
+        m_seenExtraData = false;
+
+        qsizetype extraDataStart = extraDataStarts.at(i);
+        for (; chunk != chunks.end() && chunk->file == i; ++chunk) {
+            qsizetype warningIdx = 0;
+            for (auto &[warningCount, message] : chunk->messages) {
+                while (warningIdx < warningCount)
+                    m_warnings.append(chunk->warnings.at(warningIdx++));
+                insertMessage(std::move(message));
+            }
+            while (warningIdx < chunk->warnings.size())
+                m_warnings.append(chunk->warnings.at(warningIdx++));
+
+            if (chunk->error != QCanDbcFileParser::Error::None) {
+                m_error = chunk->error;
+                m_errorString = chunk->errorString;
+                return false;
+            }
+            if (chunk->extraDataOffset >= 0) {
+                // the results of the following chunks are not needed
+                extraDataStart = chunk->extraDataOffset;
+                while (chunk + 1 != chunks.end() && (chunk + 1)->file == i)
+                    ++chunk;
+            }
+        }
+
+        const auto processExtraData = [this](View line, qsizetype) {
+            return processLine(line); // also sets the error properly
+        };
+        if (!forEachLine(content, extraDataStart, content.size(), processExtraData))
             return false;
-        if (idx == -1) // reached the end of the string
-            break;
-        from = idx + 1;
+        addCurrentMessage(); // check if we need to add the message
+        // now when we parsed the whole file, we can verify the signal multiplexing
+        postProcessSignalMultiplexing();
     }
-    addCurrentMessage();
-    postProcessSignalMultiplexing();
     return true;
 }
 
+/*!
+    \internal
+    Parses the lines of m_chunk in \a content. Runs in a worker thread.
+*/
+template <typename View>
+void QCanDbcFileParserPrivate::parseChunk(const View content)
+{
+    forEachLine(content, m_chunk->begin, m_chunk->end, [this, content](View line, qsizetype) {
+        if (!processLine(line))
+            return false;
+        if (m_chunk->extraDataOffset >= 0) {
+            // make the offset relative to the whole content
+            m_chunk->extraDataOffset += line.data() - content.data();
+            return false;
+        }
+        return true;
+    });
+    addCurrentMessage();
+
+    m_chunk->warnings = std::move(m_warnings);
+    m_chunk->error = m_error;
+    m_chunk->errorString = std::move(m_errorString);
+}
+
 /*!
     \internal
     Returns \c false only in case of hard error. Returns \c true even if some
     warnings occurred during parsing.
 */
-bool QCanDbcFileParserPrivate::processLine(const QStringView line)
+template <typename View>
+bool QCanDbcFileParserPrivate::processLine(const View line)
 {
-    QStringView data = line;
+    View data = line;
     m_lineOffset = 0;
 
     auto handleParsingError = [this](QLatin1StringView section) {
@@ -456,7 +1065,7 @@ bool QCanDbcFileParserPrivate::processLine(const QStringView line)
                               "of %1 section.").arg(section);
     };
 
-    if (data.startsWith(kMessageDef)) {
+    if (startsWith(data, kMessageDef)) {
         if (m_seenExtraData) {
             // Unexpected position of message description
             handleParsingError(kMessageDef);
@@ -469,7 +1078,7 @@ bool QCanDbcFileParserPrivate::processLine(const QStringView line)
     // signal definitions can be on the same line as message definition,
     // or on a separate line
     data = data.sliced(m_lineOffset).trimmed();
-    while (data.startsWith(kSignalDef)) {
+    while (startsWith(data, kSignalDef)) {
         if (!m_isProcessingMessage || m_seenExtraData) {
             // Unexpected position of signal description
             handleParsingError(kSignalDef);
@@ -481,19 +1090,24 @@ bool QCanDbcFileParserPrivate::processLine(const QStringView line)
     }
     // If we detect one of the following lines, then message description is
     // finished. We also assume that we can have only one key at each line.
-    if (data.startsWith(kSigValTypeDef)) {
+    if (m_chunk && isExtraData(data)) {
+        // The extra data refers to the messages of all chunks, so it is
+        // parsed after merging them. Only remember where it starts.
+        addCurrentMessage();
+        m_chunk->extraDataOffset = line.size() - data.size();
+    } else if (startsWith(data, kSigValTypeDef)) {
         m_seenExtraData = true;
         addCurrentMessage();
         parseSignalType(data);
-    } else if (data.startsWith(kCommentDef)) {
+    } else if (startsWith(data, kCommentDef)) {
         m_seenExtraData = true;
         addCurrentMessage();
         parseComment(data);
-    } else if (data.startsWith(kExtendedMuxDef)) {
+    } else if (startsWith(data, kExtendedMuxDef)) {
         m_seenExtraData = true;
         addCurrentMessage();
         parseExtendedMux(data);
-    } else if (data.startsWith(kValDef)) {
+    } else if (startsWith(data, kValDef)) {
         m_seenExtraData = true;
         addCurrentMessage();
         parseValueDescriptions(data);
@@ -501,7 +1115,8 @@ bool QCanDbcFileParserPrivate::processLine(const QStringView line)
     return true;
 }
 
-static std::optional<QtCanBus::UniqueId> extractUniqueId(QStringView view)
+template <typename View>
+static std::optional<QtCanBus::UniqueId> extractUniqueId(View view)
 {
     bool ok = false;
     const uint value = view.toUInt(&ok);
@@ -510,56 +1125,155 @@ static std::optional<QtCanBus::UniqueId> extractUniqueId(QStringView view)
     return std::nullopt;
 }
 
+// Returns the unique id of the message that a line with extra data refers to.
+template <typename View>
+static std::optional<QtCanBus::UniqueId> extraDataUniqueId(View line)
+{
+    DbcTokenizer<View> tokenizer(line);
+    bool matched = tokenizer.keyword(kSigValTypeDef) || tokenizer.keyword(kExtendedMuxDef)
+            || tokenizer.keyword(kValDef);
+    if (!matched && tokenizer.keyword(kCommentDef) && tokenizer.maybeSpaces())
+        matched = tokenizer.keyword(kMessageDef) || tokenizer.keyword(kSignalDef);
+    View messageId;
+    if (matched && tokenizer.maybeSpaces() && tokenizer.unsignedInt(&messageId))
+        return extractUniqueId(messageId);
+    return std::nullopt;
+}
+
+/*!
+    \internal
+    Builds the m_lazyIndex for the \a contents. Only the message definitions
+    are parsed. The lines with extra data are assigned to the messages they
+    refer to, and are parsed together with the message when it is used.
+
+    The order of the sections is checked in the same way as in
+    parseContents(), so that the same hard errors are reported.
+
+    Returns \c false only in case of hard error.
+*/
+template <typename View>
+bool QCanDbcFileParserPrivate::indexContents(const QList<View> &contents)
+{
+    auto &entries = m_lazyIndex->entries;
+    for (qsizetype i = 0; i < contents.size(); ++i) {
+        const View content = contents.at(i);
+        m_fileName = m_lazyIndex->fileNames.at(i);
+        m_isProcessingMessage = false;
+        m_seenExtraData = false;
+
+        // the message whose lines are currently indexed
+        std::optional<QtCanBus::UniqueId> currentUid;
+        const auto finishMessage = [&](qsizetype end) {
+            if (currentUid)
+                entries[*currentUid].message.end = end;
+            currentUid.reset();
+        };
+
+        const auto indexLine = [&](View line, qsizetype lineStart) {
+            if (startsWith(line, kMessageDef)) {
+                if (m_seenExtraData)
+                    return processLine(line); // reports the error
+                finishMessage(lineStart);
+                parseMessage(line);
+                if (!m_isProcessingMessage)
+                    return true;
+                const auto uid = m_currentMessage.uniqueId();
+                m_currentMessage = {};
+                if (entries.contains(uid)) {
+                    addWarning(QObject::tr("Message description with unique id %1 is skipped "
+                                           "because such unique id is already used.").
+                               arg(qToUnderlying(uid)));
+                    return true;
+                }
+                QCanDbcLazyIndex::Entry entry;
+                entry.message = { i, lineStart, content.size() };
+                entries.insert(uid, std::move(entry));
+                currentUid = uid;
+            } else if (startsWith(line, kSignalDef)) {
+                if (!m_isProcessingMessage)
+                    return processLine(line); // reports the error
+            } else if (isExtraData(line)) {
+                finishMessage(lineStart);
+                m_isProcessingMessage = false;
+                m_seenExtraData = true;
+                const auto uid = extraDataUniqueId(line);
+                const auto it = uid ? entries.find(*uid) : entries.end();
+                if (it == entries.end()) {
+                    // there is nothing to refer to, so parse the line now
+                    // to report the warnings
+                    return processLine(line);
+                }
+                const qsizetype begin = line.data() - content.data();
+                const qsizetype end = begin + line.size();
+                it->extraData.append(QCanDbcLazyIndex::LineRange{ i, begin, end });
+            }
+            return true;
+        };
+        if (!forEachLine(content, 0, content.size(), indexLine))
+            return false;
+        finishMessage(content.size());
+    }
+    return true;
+}
+
+template <typename View>
+struct DbcMessageTokens
+{
+    View messageId;
+    View name;
+    View size;
+    View transmitter;
+};
+
 /*!
     \internal
     Returns \c false only in case of hard error. Returns \c true even if some
     warnings occurred during parsing.
 */
-bool QCanDbcFileParserPrivate::parseMessage(const QStringView data)
+template <typename View>
+bool QCanDbcFileParserPrivate::parseMessage(const View data)
 {
-    // The regexp matches the following definition:
+    // The tokenizer matches the following definition:
     // BO_ message_id message_name ':' message_size transmitter
     // also considering the fact that spaces around ':' seem to be optional, and
     // allowing more than one space between parts.
-
-    // %1 - messageDef
-    // %2 - maybeSpace
-    // %3 - unsignedInt
-    // %4 - oneOrMoreSpace
-    // %5 - DbcIdentifier
-    static const QString regExStr =
-            "%1%2(?<messageId>%3)%4(?<name>%5)%2:%2(?<size>%3)%4(?<transmitter>%5)"_L1.
-            arg(kMessageDef, kMaybeSpaceRegExp, kUnsignedIntRegExp, kOneOrMoreSpaceRegExp,
-                kDbcIdentRegExp);
-    static const QRegularExpression messageRegExp(regExStr);
+    // Equivalent regexp:
+    // "BO_ [ ]*(?<messageId>\d+)[ ]+(?<name>ident)[ ]*:[ ]*(?<size>\d+)[ ]+(?<transmitter>ident)"
+    DbcTokenizer<View> tokenizer(data);
+    DbcMessageTokens<View> tokens;
+    const bool matched = tokenizer.keyword(kMessageDef) && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&tokens.messageId) && tokenizer.spaces()
+            && tokenizer.identifier(&tokens.name) && tokenizer.maybeSpaces()
+            && tokenizer.character(u':') && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&tokens.size) && tokenizer.spaces()
+            && tokenizer.identifier(&tokens.transmitter);
 
     m_isProcessingMessage = false;
-    const auto match = messageRegExp.matchView(data);
-    if (match.hasMatch()) {
-        m_currentMessage = extractMessage(match);
+    if (matched) {
+        m_currentMessage = extractMessage(tokens);
         // can't check for isValid() here, because demands signal descriptions
         if (!m_currentMessage.name().isEmpty()) {
             m_isProcessingMessage = true;
         } else {
             addWarning(QObject::tr("Failed to parse message description from "
-                                   "string %1").arg(data));
+                                   "string %1").arg(toQString(data)));
         }
-        m_lineOffset = match.capturedEnd(0);
+        m_lineOffset = tokenizer.position();
     } else {
-        addWarning(QObject::tr("Failed to find message description in string %1").arg(data));
+        addWarning(QObject::tr("Failed to find message description in string %1").
+                   arg(toQString(data)));
         m_lineOffset = data.size(); // skip this string
     }
     return true;
 }
 
-QCanMessageDescription
-QCanDbcFileParserPrivate::extractMessage(const QRegularExpressionMatch &match)
+template <typename Tokens>
+QCanMessageDescription QCanDbcFileParserPrivate::extractMessage(const Tokens &tokens)
 {
-    Q_ASSERT(match.hasMatch());
     QCanMessageDescription desc;
-    desc.setName(match.captured(u"name"_s));
+    desc.setName(toQString(tokens.name));
 
-    const auto id = extractUniqueId(match.capturedView(u"messageId"_s));
+    const auto id = extractUniqueId(tokens.messageId);
     if (id.has_value()) {
         desc.setUniqueId(id.value());
     } else {
@@ -568,7 +1282,7 @@ QCanDbcFileParserPrivate::extractMessage(const QRegularExpressionMatch &match)
     }
 
     bool ok = false;
-    const auto size = match.capturedView(u"size"_s).toUInt(&ok);
+    const auto size = tokens.size.toUInt(&ok);
     if (ok) {
         desc.setSize(size);
     } else {
@@ -576,78 +1290,121 @@ QCanDbcFileParserPrivate::extractMessage(const QRegularExpressionMatch &match)
         return {};
     }
 
-    desc.setTransmitter(match.captured(u"transmitter"_s));
+    desc.setTransmitter(toQString(tokens.transmitter));
 
     return desc;
 }
 
+template <typename View>
+struct DbcSignalTokens
+{
+    View name;
+    View mux;
+    View startBit;
+    View sigSize;
+    View byteOrder;
+    View valueType;
+    View factor;
+    View offset;
+    View min;
+    View max;
+    View unit;
+    View receiver;
+    bool hasMux = false;
+};
+
 /*!
     \internal
     Returns \c false only in case of hard error. Returns \c true even if some
     warnings occurred during parsing.
 */
-bool QCanDbcFileParserPrivate::parseSignal(const QStringView data)
+template <typename View>
+bool QCanDbcFileParserPrivate::parseSignal(const View data)
 {
-    // The regexp should match the following pattern:
+    // The tokenizer matches the following pattern:
     //      SG_ signal_name multiplexer_indicator : start_bit |
     //      signal_size @ byte_order value_type ( factor , offset )
     //      [ minimum | maximum ] unit receiver {, receiver}
     // We also need to consider the fact that some of the spaces might be
     // optional, and we can potentially allow more spaces between parts.
     // Note that the end of the signal description can contain multiple
-    // receivers. The regexp is supposed to extract all of them, but we use
-    // only the first one for now.
-
-    // %1 - SignalDef
-    // %2 - MaybeSpace
-    // %3 - DbcIdentifier
-    // %4 - OneOrMoreSpace
-    // %5 - MuxIndicator
-    // %6 - unsignedInt
-    // %7 - byteOrder
-    // %8 - valueType
-    // %9 - double
-    // %10 - charStr
-    static const QString regExStr =
-            "%1%2(?<name>%3)(%4(?<mux>%5))?%2:%2(?<startBit>%6)%2\\|%2(?<sigSize>%6)%2@%2"
-            "(?<byteOrder>%7)%2(?<valueType>%8)%4\\(%2(?<factor>%9)%2,%2(?<offset>%9)%2\\)"
-            "%4\\[%2(?<min>%9)%2\\|%2(?<max>%9)%2\\]%4\"(?<unit>%10)\""
-            "%4(?<receiver>%3)(%2,%2%3)*"_L1.
-            arg(kSignalDef, kMaybeSpaceRegExp, kDbcIdentRegExp, kOneOrMoreSpaceRegExp,
-                kMuxIndicatorRegExp, kUnsignedIntRegExp, kByteOrderRegExp, kValueTypeRegExp,
-                kDoubleRegExp, kCharStrRegExp);
-    static const QRegularExpression signalRegExp(regExStr);
-
-    const auto match = signalRegExp.matchView(data);
-    if (match.hasMatch()) {
-        QCanSignalDescription desc = extractSignal(match);
+    // receivers. All of them are consumed, but we use only the first one
+    // for now.
+    DbcTokenizer<View> tokenizer(data);
+    DbcSignalTokens<View> tokens;
+
+    bool matched = tokenizer.keyword(kSignalDef) && tokenizer.maybeSpaces()
+            && tokenizer.identifier(&tokens.name);
+    if (matched) {
+        // optional "[ ]+(?<mux>M|m\d+M?)"
+        const qsizetype nameEnd = tokenizer.position();
+        tokens.hasMux = tokenizer.spaces() && tokenizer.muxIndicator(&tokens.mux);
+        if (!tokens.hasMux)
+            tokenizer.setPosition(nameEnd);
+    }
+    matched = matched && tokenizer.maybeSpaces() && tokenizer.character(u':')
+            && tokenizer.maybeSpaces() && tokenizer.unsignedInt(&tokens.startBit)
+            && tokenizer.maybeSpaces() && tokenizer.character(u'|')
+            && tokenizer.maybeSpaces() && tokenizer.unsignedInt(&tokens.sigSize)
+            && tokenizer.maybeSpaces() && tokenizer.character(u'@')
+            && tokenizer.maybeSpaces() && tokenizer.oneOf("01"_L1, &tokens.byteOrder)
+            && tokenizer.maybeSpaces() && tokenizer.oneOf("+-"_L1, &tokens.valueType)
+            && tokenizer.spaces() && tokenizer.character(u'(')
+            && tokenizer.maybeSpaces() && tokenizer.number(&tokens.factor)
+            && tokenizer.maybeSpaces() && tokenizer.character(u',')
+            && tokenizer.maybeSpaces() && tokenizer.number(&tokens.offset)
+            && tokenizer.maybeSpaces() && tokenizer.character(u')')
+            && tokenizer.spaces() && tokenizer.character(u'[')
+            && tokenizer.maybeSpaces() && tokenizer.number(&tokens.min)
+            && tokenizer.maybeSpaces() && tokenizer.character(u'|')
+            && tokenizer.maybeSpaces() && tokenizer.number(&tokens.max)
+            && tokenizer.maybeSpaces() && tokenizer.character(u']')
+            && tokenizer.spaces() && tokenizer.charString(&tokens.unit)
+            && tokenizer.spaces() && tokenizer.identifier(&tokens.receiver);
+    if (matched) {
+        // "([ ]*,[ ]*ident)*"
+        while (true) {
+            const qsizetype pos = tokenizer.position();
+            View receiver;
+            if (!(tokenizer.maybeSpaces() && tokenizer.character(u',')
+                  && tokenizer.maybeSpaces() && tokenizer.identifier(&receiver))) {
+                tokenizer.setPosition(pos);
+                break;
+            }
+        }
+    }
+
+    if (matched) {
+        QCanSignalDescription desc = extractSignal(tokens);
 
         if (desc.isValid())
             m_currentMessage.addSignalDescription(desc);
         else
-            addWarning(QObject::tr("Failed to parse signal description from string %1").arg(data));
+            addWarning(QObject::tr("Failed to parse signal description from string %1").
+                       arg(toQString(data)));
 
-        m_lineOffset = match.capturedEnd(0);
+        m_lineOffset = tokenizer.position();
     } else {
-        addWarning(QObject::tr("Failed to find signal description in string %1").arg(data));
+        addWarning(QObject::tr("Failed to find signal description in string %1").
+                   arg(toQString(data)));
         m_lineOffset = data.size(); // skip this string
     }
     return true;
 }
 
-QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpressionMatch &match)
+template <typename Tokens>
+QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const Tokens &tokens)
 {
-    Q_ASSERT(match.hasMatch());
     QCanSignalDescription desc;
-    desc.setName(match.captured(u"name"_s));
+    desc.setName(toQString(tokens.name));
 
     bool ok = false;
 
-    if (match.hasCaptured(u"mux"_s)) {
-        const auto muxStr = match.capturedView(u"mux"_s);
-        if (muxStr == u"M"_s) {
+    if (tokens.hasMux) {
+        const auto muxStr = tokens.mux;
+        if (muxStr.size() == 1) { // "M"
             desc.setMultiplexState(QtCanBus::MultiplexState::MultiplexorSwitch);
-        } else if (muxStr.endsWith(u"M"_s, Qt::CaseSensitive)) {
+        } else if (charAt(muxStr, muxStr.size() - 1) == u'M') {
             desc.setMultiplexState(QtCanBus::MultiplexState::SwitchAndSignal);
             const auto val = muxStr.sliced(1, muxStr.size() - 2).toUInt(&ok);
             if (!ok) {
@@ -673,7 +1430,7 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
         }
     }
 
-    const uint startBit = match.capturedView(u"startBit"_s).toUInt(&ok);
+    const uint startBit = tokens.startBit.toUInt(&ok);
     if (ok) {
         desc.setStartBit(startBit);
     } else {
@@ -681,7 +1438,7 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
         return {};
     }
 
-    const uint bitLength = match.capturedView(u"sigSize"_s).toUInt(&ok);
+    const uint bitLength = tokens.sigSize.toUInt(&ok);
     if (ok) {
         desc.setBitLength(bitLength);
     } else {
@@ -690,16 +1447,16 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
     }
 
     // 0 = BE; 1 = LE
-    const auto endian = match.capturedView(u"byteOrder"_s) == u"0"_s
+    const auto endian = charAt(tokens.byteOrder, 0) == u'0'
             ? QSysInfo::Endian::BigEndian : QSysInfo::Endian::LittleEndian;
     desc.setDataEndian(endian);
 
     // + = unsigned; - = signed
-    const auto dataFormat = match.capturedView(u"valueType"_s) == u"+"_s
+    const auto dataFormat = charAt(tokens.valueType, 0) == u'+'
             ? QtCanBus::DataFormat::UnsignedInteger : QtCanBus::DataFormat::SignedInteger;
     desc.setDataFormat(dataFormat);
 
-    const double factor = match.capturedView(u"factor"_s).toDouble(&ok);
+    const double factor = tokens.factor.toDouble(&ok);
     if (ok) {
         desc.setFactor(factor);
     } else {
@@ -707,7 +1464,7 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
         return {};
     }
 
-    const double offset = match.capturedView(u"offset"_s).toDouble(&ok);
+    const double offset = tokens.offset.toDouble(&ok);
     if (ok) {
         desc.setOffset(offset);
     } else {
@@ -715,9 +1472,9 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
         return {};
     }
 
-    const double min = match.capturedView(u"min"_s).toDouble(&ok);
+    const double min = tokens.min.toDouble(&ok);
     if (ok) {
-        const double max = match.capturedView(u"max"_s).toDouble(&ok);
+        const double max = tokens.max.toDouble(&ok);
         if (ok)
             desc.setRange(min, max);
     }
@@ -726,54 +1483,54 @@ QCanSignalDescription QCanDbcFileParserPrivate::extractSignal(const QRegularExpr
         return {};
     }
 
-    desc.setPhysicalUnit(match.captured(u"unit"_s));
-    desc.setReceiver(match.captured(u"receiver"_s));
+    desc.setPhysicalUnit(toQString(tokens.unit));
+    desc.setReceiver(toQString(tokens.receiver));
 
     return desc;
 }
 
-void QCanDbcFileParserPrivate::parseSignalType(const QStringView data)
+template <typename View>
+void QCanDbcFileParserPrivate::parseSignalType(const View data)
 {
-    // The regexp should match the following pattern:
+    // The tokenizer matches the following pattern:
     //      SIG_VALTYPE_ message_id signal_name signal_extended_value_type ;
     // We also need to consider the fact that we can potentially allow more
     // spaces between parts.
-
-    // %1 sigValTypeDef
-    // %2 maybeSpace
-    // %3 unsignedInt
-    // %4 oneOrMoreSpace
-    // %5 DbcIdentifier
-    const QString regExStr =
-            "%1%2(?<messageId>%3)%4(?<sigName>%5)%2:%2(?<type>%3)%2;"_L1.
-            arg(kSigValTypeDef, kMaybeSpaceRegExp, kUnsignedIntRegExp,
-                kOneOrMoreSpaceRegExp, kDbcIdentRegExp);
-    const QRegularExpression sigValTypeRegEx(regExStr);
-
-    const auto match = sigValTypeRegEx.matchView(data);
-    if (!match.hasMatch()) {
+    // Equivalent regexp:
+    // "SIG_VALTYPE_ [ ]*(?<messageId>\d+)[ ]+(?<sigName>ident)[ ]*:[ ]*(?<type>\d+)[ ]*;"
+    DbcTokenizer<View> tokenizer(data);
+    View messageId;
+    View sigNameView;
+    View typeView;
+    const bool matched = tokenizer.keyword(kSigValTypeDef) && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&messageId) && tokenizer.spaces()
+            && tokenizer.identifier(&sigNameView) && tokenizer.maybeSpaces()
+            && tokenizer.character(u':') && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&typeView) && tokenizer.maybeSpaces()
+            && tokenizer.character(u';');
+    if (!matched) {
         m_lineOffset = data.size();
         addWarning(QObject::tr("Failed to find signal value type description in string %1").
-                   arg(data));
+                   arg(toQString(data)));
         return;
     }
 
-    m_lineOffset = match.capturedEnd(0);
+    m_lineOffset = tokenizer.position();
 
-    const auto uidOptional = extractUniqueId(match.capturedView(u"messageId"_s));
+    const auto uidOptional = extractUniqueId(messageId);
     if (!uidOptional) {
-        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(data));
+        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(toQString(data)));
         return;
     }
 
     const QtCanBus::UniqueId uid = uidOptional.value();
     auto msgDesc = m_messageDescriptions.value(uid);
     if (msgDesc.isValid()) {
-        const QString sigName = match.captured(u"sigName"_s);
+        const QString sigName = toQString(sigNameView);
         auto sigDesc = msgDesc.signalDescriptionForName(sigName);
         if (sigDesc.isValid()) {
             bool ok = false;
-            const auto type = match.capturedView(u"type").toUInt(&ok);
+            const auto type = typeView.toUInt(&ok);
             if (ok) {
                 bool sigDescChanged = false;
                 switch (type) {
@@ -800,53 +1557,62 @@ void QCanDbcFileParserPrivate::parseSignalType(const QStringView data)
                     m_messageDescriptions.insert(msgDesc.uniqueId(), msgDesc);
                 }
             } else {
-                addWarning(QObject::tr("Failed to parse data type from string %1").arg(data));
+                addWarning(QObject::tr("Failed to parse data type from string %1").
+                           arg(toQString(data)));
             }
         } else {
             addWarning(QObject::tr("Failed to find signal description for signal %1. "
-                                   "Skipping string %2").arg(sigName, data));
+                                   "Skipping string %2").arg(sigName, toQString(data)));
         }
     } else {
         addWarning(QObject::tr("Failed to find message description for unique id %1. "
-                               "Skipping string %2").arg(qToUnderlying(uid)).arg(data));
+                               "Skipping string %2").arg(qToUnderlying(uid)).
+                   arg(toQString(data)));
     }
 }
 
-void QCanDbcFileParserPrivate::parseComment(const QStringView data)
+template <typename View>
+void QCanDbcFileParserPrivate::parseComment(const View data)
 {
     // The comment for message or signal description is represented by the
     // following pattern:
     //      CM_ (BO_ message_id char_string | SG_ message_id signal_name char_string);
-
-    // %1 commentDef
-    // %2 maybeSpace
-    // %3 messageDef
-    // %4 signalDef
-    // %5 oneOrMoreSpace
-    // %6 unsignedInt
-    // %7 DbcIdentifier
-    // %8 charStr
-    const QString regExStr =
-            "%1%2(?<type>(%3|%4))%2(?<messageId>%6)%5((?<sigName>%7)%5)?\"(?<comment>%8)\"%2;"_L1.
-            arg(kCommentDef, kMaybeSpaceRegExp, kMessageDef, kSignalDef, kOneOrMoreSpaceRegExp,
-                kUnsignedIntRegExp, kDbcIdentRegExp, kCharStrRegExp);
-    const QRegularExpression commentRegExp(regExStr);
-
-    const auto match = commentRegExp.matchView(data);
-    if (!match.hasMatch()) {
+    // Equivalent regexp:
+    // "CM_ [ ]*(?<type>(BO_ |SG_ ))[ ]*(?<messageId>\d+)[ ]+((?<sigName>ident)[ ]+)?
+    //  \"(?<comment>charStr)\"[ ]*;"
+    DbcTokenizer<View> tokenizer(data);
+    View messageId;
+    View sigNameView;
+    View commentView;
+    bool isMessageComment = false;
+    bool matched = tokenizer.keyword(kCommentDef) && tokenizer.maybeSpaces();
+    if (matched) {
+        isMessageComment = tokenizer.keyword(kMessageDef);
+        matched = isMessageComment || tokenizer.keyword(kSignalDef);
+    }
+    matched = matched && tokenizer.maybeSpaces() && tokenizer.unsignedInt(&messageId)
+            && tokenizer.spaces();
+    if (matched) {
+        const qsizetype pos = tokenizer.position();
+        if (!(tokenizer.identifier(&sigNameView) && tokenizer.spaces())) {
+            sigNameView = {};
+            tokenizer.setPosition(pos);
+        }
+    }
+    matched = matched && tokenizer.charString(&commentView) && tokenizer.maybeSpaces()
+            && tokenizer.character(u';');
+    if (!matched) {
         // no warning here, as we ignore some "general" comments, and parse only
         // comments related to messages and signals
         m_lineOffset = data.size();
         return;
     }
 
-    m_lineOffset = match.capturedEnd(0);
+    m_lineOffset = tokenizer.position();
 
-    const auto type = match.capturedView(u"type"_s);
-
-    const auto uidOptional = extractUniqueId(match.capturedView(u"messageId"_s));
+    const auto uidOptional = extractUniqueId(messageId);
     if (!uidOptional) {
-        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(data));
+        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(toQString(data)));
         return;
     }
 
@@ -854,63 +1620,88 @@ void QCanDbcFileParserPrivate::parseComment(const QStringView data)
     auto messageDesc = m_messageDescriptions.value(uid);
     if (!messageDesc.isValid()) {
         addWarning(QObject::tr("Failed to find message description for unique id %1. "
-                               "Skipping string %2").arg(qToUnderlying(uid)).arg(data));
+                               "Skipping string %2").arg(qToUnderlying(uid)).
+                   arg(toQString(data)));
         return;
     }
 
-    if (type == kMessageDef) {
-        const QString comment = match.captured(u"comment"_s);
+    if (isMessageComment) {
+        const QString comment = toQString(commentView);
         messageDesc.setComment(comment);
         m_messageDescriptions.insert(uid, messageDesc);
-    } else if (type == kSignalDef) {
-        const QString sigName = match.captured(u"sigName"_s);
+    } else {
+        const QString sigName = toQString(sigNameView);
         auto signalDesc = messageDesc.signalDescriptionForName(sigName);
         if (signalDesc.isValid()) {
-            const QString comment = match.captured(u"comment"_s);
+            const QString comment = toQString(commentView);
             signalDesc.setComment(comment);
             messageDesc.addSignalDescription(signalDesc);
             m_messageDescriptions.insert(uid, messageDesc);
         } else {
             addWarning(QObject::tr("Failed to find signal description for signal %1. "
-                                   "Skipping string %2").arg(sigName, data));
+                                   "Skipping string %2").arg(sigName, toQString(data)));
         }
     }
 }
 
-void QCanDbcFileParserPrivate::parseExtendedMux(const QStringView data)
+template <typename View>
+void QCanDbcFileParserPrivate::parseExtendedMux(const View data)
 {
     // The extended multiplexing is defined by the following pattern:
     //      SG_MUL_VAL_ message_id multiplexed_signal_name
     //      multiplexor_switch_name multiplexor_value_ranges ;
     // Here multiplexor_value_ranges consists of multiple ranges, separated
-    // by a whitespace, and one range is defined as follows:
+    // by a comma, and one range is defined as follows:
     //      multiplexor_value_range = unsigned_integer - unsigned_integer
+    // Equivalent regexp:
+    // "SG_MUL_VAL_ [ ]*(?<messageId>\d+)[ ]+(?<multiplexedSignal>ident)[ ]+
+    //  (?<multiplexorSwitch>ident)[ ]+(\d+[ ]*-[ ]*\d+)([ ]*,[ ]*\d+[ ]*-[ ]*\d+)*[ ]*;"
+    DbcTokenizer<View> tokenizer(data);
+    View messageId;
+    View multiplexedSignalView;
+    View multiplexorSwitchView;
+
+    // The ranges are only used if the whole string is matched
+    QCanSignalDescription::MultiplexValues rangeValues;
+    auto range = [&tokenizer, &rangeValues]() {
+        View min;
+        View max;
+        if (tokenizer.unsignedInt(&min) && tokenizer.maybeSpaces() && tokenizer.character(u'-')
+                && tokenizer.maybeSpaces() && tokenizer.unsignedInt(&max)) {
+            rangeValues.push_back({min.toUInt(), max.toUInt()});
+            return true;
+        }
+        return false;
+    };
 
-    // %1 extendedMuxDef
-    // %2 maybeSpace
-    // %3 unsignedInt
-    // %4 oneOrMoreSpace
-    // %5 DbcIdentifier
-    const QString regExStr =
-            "%1%2(?<messageId>%3)%4(?<multiplexedSignal>%5)%4(?<multiplexorSwitch>%5)%4"
-            "(?<firstRange>%3%2-%2%3)(%2,%2%3%2-%2%3)*%2;"_L1.
-            arg(kExtendedMuxDef, kMaybeSpaceRegExp, kUnsignedIntRegExp, kOneOrMoreSpaceRegExp,
-                kDbcIdentRegExp);
-    const QRegularExpression extendedMuxRegExp(regExStr);
-
-    const auto match = extendedMuxRegExp.matchView(data);
-    if (!match.hasMatch()) {
+    bool matched = tokenizer.keyword(kExtendedMuxDef) && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&messageId) && tokenizer.spaces()
+            && tokenizer.identifier(&multiplexedSignalView) && tokenizer.spaces()
+            && tokenizer.identifier(&multiplexorSwitchView) && tokenizer.spaces()
+            && range();
+    if (matched) {
+        while (true) {
+            const qsizetype pos = tokenizer.position();
+            if (!(tokenizer.maybeSpaces() && tokenizer.character(u',')
+                  && tokenizer.maybeSpaces() && range())) {
+                tokenizer.setPosition(pos);
+                break;
+            }
+        }
+        matched = tokenizer.maybeSpaces() && tokenizer.character(u';');
+    }
+    if (!matched) {
         m_lineOffset = data.size();
         addWarning(QObject::tr("Failed to find extended multiplexing description in string %1").
-                   arg(data));
+                   arg(toQString(data)));
         return;
     }
 
-    m_lineOffset = match.capturedEnd(0);
+    m_lineOffset = tokenizer.position();
 
-    const auto uidOptional = extractUniqueId(match.capturedView(u"messageId"_s));
+    const auto uidOptional = extractUniqueId(messageId);
     if (!uidOptional) {
-        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(data));
+        addWarning(QObject::tr("Failed to parse frame id from string %1").arg(toQString(data)));
         return;
     }
 
@@ -918,12 +1709,14 @@ void QCanDbcFileParserPrivate::parseExtendedMux(const QStringView data)
     auto messageDesc = m_messageDescriptions.value(uid);
     if (!messageDesc.isValid()) {
         addWarning(QObject::tr("Failed to find message description for unique id %1. "
-                               "Skipping string %2").arg(qToUnderlying(uid)).arg(data));
+                               "Skipping string %2").arg(qToUnderlying(uid)).
+                   arg(toQString(data)));
         return;
     }
 
-    const QString multiplexedSignalName = match.captured(u"multiplexedSignal"_s);
-    const QString multiplexorSwitchName = match.captured(u"multiplexorSwitch"_s);
+    const QString multiplexedSignalName = toQString(multiplexedSignalView);
+    // used as a key of the multiplex signals of the multiplexed signal
+    const QString multiplexorSwitchName = intern(toQString(multiplexorSwitchView));
 
     auto multiplexedSignal = messageDesc.signalDescriptionForName(multiplexedSignalName);
     auto multiplexorSwitch = messageDesc.signalDescriptionForName(multiplexorSwitchName);
@@ -932,42 +1725,13 @@ void QCanDbcFileParserPrivate::parseExtendedMux(const QStringView data)
         const QString invalidName = multiplexedSignal.isValid() ? multiplexorSwitchName
                                                                 : multiplexedSignalName;
         addWarning(QObject::tr("Failed to find signal description for signal %1. "
-                               "Skipping string %2").arg(invalidName, data));
+                               "Skipping string %2").arg(invalidName, toQString(data)));
         return;
     }
 
     auto signalRanges = multiplexedSignal.multiplexSignals();
     signalRanges.remove(kQtDummySignal); // dummy signal not needed anymore
 
-    QCanSignalDescription::MultiplexValues rangeValues;
-    auto rangeView = match.capturedView(u"firstRange"_s);
-    const auto sepIdx = rangeView.indexOf(u'-');
-    if (sepIdx != -1) {
-        const auto min = rangeView.first(sepIdx).trimmed().toUInt();
-        const auto max = rangeView.sliced(sepIdx + 1).trimmed().toUInt();
-        rangeValues.push_back({min, max});
-    }
-
-    // We can have an arbitrary amount of ranges, so we can't use capture groups
-    // to capture them. But we know that they follow a specific pattern (because
-    // the full string matched the regexp). So we need to parse the rest of the
-    // matched string manually
-    const auto totalEnd = match.capturedEnd(0); // including the ';'
-    const auto firstRangeEnd = match.capturedEnd(u"firstRange"_s);
-    const auto len = totalEnd - firstRangeEnd - 1;
-    if (len > 0) {
-        const auto otherRangesView = data.sliced(firstRangeEnd, len).trimmed();
-        const QStringTokenizer parts = otherRangesView.tokenize(u',', Qt::SkipEmptyParts);
-        for (const QStringView range : parts) {
-            const auto sepIdx = range.indexOf(u'-');
-            if (sepIdx != -1) {
-                const auto min = range.first(sepIdx).trimmed().toUInt();
-                const auto max = range.sliced(sepIdx + 1).trimmed().toUInt();
-                rangeValues.push_back({min, max});
-            }
-        }
-    }
-
     if (!rangeValues.isEmpty())
         signalRanges.insert(multiplexorSwitchName, rangeValues);
     else
@@ -979,38 +1743,54 @@ void QCanDbcFileParserPrivate::parseExtendedMux(const QStringView data)
     m_messageDescriptions.insert(uid, messageDesc);
 }
 
-void QCanDbcFileParserPrivate::parseValueDescriptions(const QStringView data)
+template <typename View>
+void QCanDbcFileParserPrivate::parseValueDescriptions(const View data)
 {
-    // The regexp should match the following pattern:
+    // The tokenizer matches the following pattern:
     //      VAL_ message_id signal_name { value_description };
     // Here the value_description is defined as follows
     //      value_description = unsigned_int char_string
+    // Equivalent regexp:
+    // "VAL_ [ ]*(?<messageId>\d+)[ ]+(?<signalName>ident)([ ]+\d+[ ]+\"charStr\")+[ ]*;"
+    DbcTokenizer<View> tokenizer(data);
+    View messageId;
+    View signalNameView;
+
+    // The descriptions are only used if the whole string is matched
+    QVarLengthArray<std::pair<View, View>, 16> descriptions;
+    auto valueDescription = [&tokenizer, &descriptions]() {
+        const qsizetype pos = tokenizer.position();
+        View value;
+        View description;
+        if (tokenizer.spaces() && tokenizer.unsignedInt(&value) && tokenizer.spaces()
+                && tokenizer.charString(&description)) {
+            descriptions.push_back({value, description});
+            return true;
+        }
+        tokenizer.setPosition(pos);
+        return false;
+    };
 
-    // %1 valDef
-    // %2 maybeSpace
-    // %3 unsignedInt
-    // %4 oneOrMoreSpace
-    // %5 DbcIdentifier
-    // %6 charStr
-    const QString regExStr =
-            "%1%2(?<messageId>%3)%4(?<signalName>%5)(%4%3%4\"(%6)\")+%2;"_L1.
-            arg(kValDef, kMaybeSpaceRegExp, kUnsignedIntRegExp, kOneOrMoreSpaceRegExp,
-                kDbcIdentRegExp, kCharStrRegExp);
-
-    const QRegularExpression valueDescRegExp(regExStr);
-
-    const auto match = valueDescRegExp.matchView(data);
-    if (!match.hasMatch()) {
+    bool matched = tokenizer.keyword(kValDef) && tokenizer.maybeSpaces()
+            && tokenizer.unsignedInt(&messageId) && tokenizer.spaces()
+            && tokenizer.identifier(&signalNameView) && valueDescription();
+    if (matched) {
+        while (valueDescription()) {}
+        matched = tokenizer.maybeSpaces() && tokenizer.character(u';');
+    }
+    if (!matched) {
         m_lineOffset = data.size();
-        addWarning(QObject::tr("Failed to parse value description from string %1").arg(data));
+        addWarning(QObject::tr("Failed to parse value description from string %1").
+                   arg(toQString(data)));
         return;
     }
 
-    m_lineOffset = match.capturedEnd(0);
+    m_lineOffset = tokenizer.position();
 
-    const auto uidOptional = extractUniqueId(match.capturedView(u"messageId"_s));
+    const auto uidOptional = extractUniqueId(messageId);
     if (!uidOptional) {
-        addWarning(QObject::tr("Failed to parse value description from string %1").arg(data));
+        addWarning(QObject::tr("Failed to parse value description from string %1").
+                   arg(toQString(data)));
         return;
     }
 
@@ -1019,47 +1799,26 @@ void QCanDbcFileParserPrivate::parseValueDescriptions(const QStringView data)
     const auto messageDesc = m_messageDescriptions.value(uid);
     if (!messageDesc.isValid()) {
         addWarning(QObject::tr("Failed to find message description for unique id %1. "
-                               "Skipping string %2").arg(qToUnderlying(uid)).arg(data));
+                               "Skipping string %2").arg(qToUnderlying(uid)).
+                   arg(toQString(data)));
         return;
     }
 
     // Check if the signal exists within the message
-    const QString signalName = match.captured(u"signalName"_s);
+    const QString signalName = toQString(signalNameView);
     if (!messageDesc.signalDescriptionForName(signalName).isValid()) {
         addWarning(QObject::tr("Failed to find signal description for signal %1. "
-                               "Skipping string %2").arg(signalName, data));
+                               "Skipping string %2").arg(signalName, toQString(data)));
         return;
     }
 
-    // We can have an arbitrary amount of value descriptions, so we can't use
-    // capture groups to capture them. But we know that they follow a specific
-    // pattern (because the full string matched the regexp). So we need to parse
-    // the rest of the matched string manually
-    const auto totalEnd = match.capturedEnd(0); // including the ';'
-    const auto signalNameEnd = match.capturedEnd(u"signalName"_s);
-    const auto len = totalEnd - signalNameEnd - 1;
-    if (len > 0) {
-        auto signalDescriptionsView = data.sliced(signalNameEnd, len).trimmed();
-        while (signalDescriptionsView.size()) {
-            const auto spacePos = signalDescriptionsView.indexOf(u' ');
-            if (spacePos == -1)
-                break;
-            bool ok = false;
-            const auto value = signalDescriptionsView.sliced(0, spacePos).toUInt(&ok);
-            if (!ok)
-                break;
-            const auto firstQuotePos = signalDescriptionsView.indexOf(u'"', spacePos + 1);
-            if (firstQuotePos == -1)
-                break;
-            const auto nextQuotePos = signalDescriptionsView.indexOf(u'"', firstQuotePos + 1);
-            if (nextQuotePos == -1)
-                break;
-            const auto description = signalDescriptionsView.sliced(
-                        firstQuotePos + 1, nextQuotePos - firstQuotePos - 1);
-
-            m_valueDescriptions[uid][signalName].insert(value, description.toString());
-            signalDescriptionsView = signalDescriptionsView.sliced(nextQuotePos + 1).trimmed();
-        }
+    auto &signalValueDescriptions = m_valueDescriptions[uid][signalName];
+    for (const auto &[valueView, description] : descriptions) {
+        bool ok = false;
+        const auto value = valueView.toUInt(&ok);
+        if (!ok)
+            break;
+        signalValueDescriptions.insert(value, intern(toQString(description)));
     }
 }
 
@@ -1140,22 +1899,144 @@ void QCanDbcFileParserPrivate::addCurrentMessage()
         if (!m_currentMessage.isValid()) {
             addWarning(QObject::tr("Message description with unique id %1 is skipped "
                                    "because it's not valid.").arg(qToUnderlying(uid)));
-        } else if (m_messageDescriptions.contains(uid)) {
-            addWarning(QObject::tr("Message description with unique id %1 is skipped "
-                                   "because such unique id is already used.").
-                       arg(qToUnderlying(uid)));
+        } else if (m_chunk) {
+            // duplicates are detected when merging the chunks
+            m_chunk->messages.emplace_back(m_warnings.size(), m_currentMessage);
         } else {
-            m_messageDescriptions.insert(uid, m_currentMessage);
+            insertMessage(std::move(m_currentMessage));
         }
         m_currentMessage = {};
         m_isProcessingMessage = false;
     }
 }
 
+void QCanDbcFileParserPrivate::insertMessage(QCanMessageDescription &&message)
+{
+    const auto uid = message.uniqueId();
+    if (m_messageDescriptions.contains(uid)) {
+        addWarning(QObject::tr("Message description with unique id %1 is skipped "
+                               "because such unique id is already used.").
+                   arg(qToUnderlying(uid)));
+        return;
+    }
+
+    // The strings are interned in place, which is only possible if the
+    // message is not shared.
+    auto *messageData = QCanMessageDescriptionPrivate::get(message);
+    if (!messageData->isShared()) {
+        messageData->transmitter = intern(messageData->transmitter);
+        for (QCanSignalDescription &signalDesc : messageData->messageSignals) {
+            auto *signalData = QCanSignalDescriptionPrivate::get(signalDesc);
+            if (signalData->isShared())
+                continue;
+            signalData->name = intern(signalData->name);
+            signalData->unit = intern(signalData->unit);
+            signalData->receiver = intern(signalData->receiver);
+        }
+    }
+    m_messageDescriptions.insert(uid, std::move(message));
+}
+
+/*!
+    \internal
+    Returns a string equal to \a str, which shares its data with all other
+    equal strings passed to this method since the last reset().
+*/
+QString QCanDbcFileParserPrivate::intern(const QString &str)
+{
+    if (str.isEmpty())
+        return str;
+    // QSet keeps the existing element, if an equal one is inserted
+    return *m_stringPool.insert(str);
+}
+
 QList<QCanMessageDescription> QCanDbcFileParserPrivate::getMessages() const
 {
+    if (m_lazyIndex)
+        return m_lazyIndex->messageDescriptions();
     return QList<QCanMessageDescription>(m_messageDescriptions.cbegin(),
                                          m_messageDescriptions.cend());
 }
 
+/* QCanDbcLazyIndex implementation */
+
+QCanDbcLazyIndex::~QCanDbcLazyIndex() = default;
+
+QCanMessageDescription QCanDbcLazyIndex::messageDescription(QtCanBus::UniqueId uid)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = entries.find(uid);
+    if (it == entries.end())
+        return {};
+    materialize(uid, &it.value());
+    return it->description;
+}
+
+QList<QCanMessageDescription> QCanDbcLazyIndex::messageDescriptions()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<QCanMessageDescription> result;
+    result.reserve(entries.size());
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        materialize(it.key(), &it.value());
+        if (it->description.isValid())
+            result.append(it->description);
+    }
+    return result;
+}
+
+QCanDbcFileParser::MessageValueDescriptions QCanDbcLazyIndex::messageValueDescriptions()
+{
+    QMutexLocker locker(&m_mutex);
+    QCanDbcFileParser::MessageValueDescriptions result;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        materialize(it.key(), &it.value());
+        if (!it->valueDescriptions.isEmpty())
+            result.insert(it.key(), it->valueDescriptions);
+    }
+    return result;
+}
+
+/*!
+    \internal
+    Parses the lines of the message \a uid, followed by its extra data, as if
+    they were the only lines of the file. The structure was already checked
+    by indexContents(), so no hard errors can occur. The warnings are logged.
+*/
+template <typename View>
+void QCanDbcLazyIndex::parseEntry(QtCanBus::UniqueId uid, Entry *entry,
+                                  const QList<View> &views)
+{
+    QCanDbcFileParserPrivate parser;
+    parser.m_stringPool = std::move(m_stringPool);
+
+    const auto processLines = [&](const LineRange &range) {
+        parser.m_fileName = fileNames.at(range.file);
+        forEachLine(views.at(range.file), range.begin, range.end,
+                    [&parser](View line, qsizetype) { return parser.processLine(line); });
+    };
+    processLines(entry->message);
+    parser.addCurrentMessage();
+    for (const LineRange &range : std::as_const(entry->extraData))
+        processLines(range);
+    parser.postProcessSignalMultiplexing();
+
+    entry->description = parser.m_messageDescriptions.value(uid);
+    entry->valueDescriptions = parser.m_valueDescriptions.value(uid);
+    for (const QString &warning : std::as_const(parser.m_warnings))
+        qCWarning(QT_CANBUS, "QCanDbcFileParser: %ls", qUtf16Printable(warning));
+    m_stringPool = std::move(parser.m_stringPool);
+}
+
+void QCanDbcLazyIndex::materialize(QtCanBus::UniqueId uid, Entry *entry)
+{
+    if (entry->materialized)
+        return;
+    if (contents.isEmpty())
+        parseEntry(uid, entry, QList<QStringView>{ data });
+    else
+        parseEntry(uid, entry, contents);
+    entry->materialized = true;
+}
+
 QT_END_NAMESPACE
@@ -7,6 +7,7 @@
 #include <QtCore/QList>
 
 #include <QtSerialBus/qcancommondefinitions.h>
+#include <QtSerialBus/qcanframeprocessor.h>
 #include <QtSerialBus/qtserialbusglobal.h>
 
 #include <memory>
@@ -29,9 +30,11 @@ public:
     // The DBC protocol uses unsigned_integer to describe the supported values.
     // Do we need to use QVariant instead of quint32? Or qint64 for better BC
     // guarantees?
-    using ValueDescriptions = QHash<quint32, QString>;
-    using SignalValueDescriptions = QHash<QString, ValueDescriptions>;
-    using MessageValueDescriptions = QHash<QtCanBus::UniqueId, SignalValueDescriptions>;
+    // The types are shared with QCanFrameProcessor, so that the parsed value
+    // descriptions can be passed to it.
+    using ValueDescriptions = QCanFrameProcessor::ValueDescriptions;
+    using SignalValueDescriptions = QCanFrameProcessor::SignalValueDescriptions;
+    using MessageValueDescriptions = QCanFrameProcessor::MessageValueDescriptions;
 
     Q_SERIALBUS_EXPORT QCanDbcFileParser();
     Q_SERIALBUS_EXPORT ~QCanDbcFileParser();
@@ -40,8 +43,16 @@ public:
     Q_SERIALBUS_EXPORT bool parse(const QStringList &fileNames);
     Q_SERIALBUS_EXPORT bool parseData(QStringView data);
 
+    Q_SERIALBUS_EXPORT QString cacheFileName() const;
+    Q_SERIALBUS_EXPORT void setCacheFileName(const QString &fileName);
+
+    Q_SERIALBUS_EXPORT bool lazyLoading() const;
+    Q_SERIALBUS_EXPORT void setLazyLoading(bool enabled);
+
     Q_SERIALBUS_EXPORT QList<QCanMessageDescription> messageDescriptions() const;
     Q_SERIALBUS_EXPORT MessageValueDescriptions messageValueDescriptions() const;
+    Q_SERIALBUS_EXPORT
+    QCanFrameProcessor::MessageDescriptionProvider messageDescriptionProvider() const;
 
     Q_SERIALBUS_EXPORT Error error() const;
     Q_SERIALBUS_EXPORT QString errorString() const;
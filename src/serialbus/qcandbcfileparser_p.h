@@ -19,33 +19,111 @@
 #include "qcanmessagedescription.h"
 
 #include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+
+#include <memory>
+#include <utility>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
 class QCanSignalDescription;
+class QFile;
+
+// The result of parsing in lazy mode. It records where the lines of each
+// message are, and parses them on first use. It is shared with the message
+// description providers, so it keeps the parsed contents alive.
+class QCanDbcLazyIndex
+{
+public:
+    struct LineRange
+    {
+        qsizetype file = 0;
+        qsizetype begin = 0;
+        qsizetype end = 0;
+    };
+
+    struct Entry
+    {
+        // the BO_ line and the following SG_ lines
+        LineRange message;
+        // the lines with extra data (comments, value descriptions, ...)
+        // that refer to the message
+        QList<LineRange> extraData;
+        bool materialized = false;
+        QCanMessageDescription description;
+        QCanDbcFileParser::SignalValueDescriptions valueDescriptions;
+    };
+
+    ~QCanDbcLazyIndex();
+
+    QCanMessageDescription messageDescription(QtCanBus::UniqueId uid);
+    QList<QCanMessageDescription> messageDescriptions();
+    QCanDbcFileParser::MessageValueDescriptions messageValueDescriptions();
+
+    QStringList fileNames;
+    // Either the memory-mapped (or read) files, or the input of parseData()
+    std::vector<std::unique_ptr<QFile>> files;
+    QList<QByteArray> fileData;
+    QList<QByteArrayView> contents;
+    QString data;
+    QHash<QtCanBus::UniqueId, Entry> entries;
+
+private:
+    void materialize(QtCanBus::UniqueId uid, Entry *entry);
+    template <typename View>
+    void parseEntry(QtCanBus::UniqueId uid, Entry *entry, const QList<View> &views);
+
+    QMutex m_mutex;
+    QSet<QString> m_stringPool;
+};
 
 class QCanDbcFileParserPrivate
 {
 public:
     void reset();
-    bool parseFile(const QString &fileName);
+    bool parseFiles(const QStringList &fileNames);
     bool parseData(QStringView data);
-    bool processLine(const QStringView line);
-    bool parseMessage(const QStringView data);
-    QCanMessageDescription extractMessage(const QRegularExpressionMatch &match);
-    bool parseSignal(const QStringView data);
-    QCanSignalDescription extractSignal(const QRegularExpressionMatch &match);
-    void parseSignalType(const QStringView data);
-    void parseComment(const QStringView data);
-    void parseExtendedMux(const QStringView data);
-    void parseValueDescriptions(const QStringView data);
+    template <typename View>
+    bool parseContents(const QList<View> &contents, const QStringList &fileNames);
+    template <typename View>
+    void parseChunk(const View content);
+    template <typename View>
+    bool indexContents(const QList<View> &contents);
+    // The parsing functions are instantiated for QStringView (parseData())
+    // and QByteArrayView (UTF-8 contents of a memory-mapped file).
+    template <typename View>
+    bool processLine(const View line);
+    template <typename View>
+    bool parseMessage(const View data);
+    template <typename Tokens>
+    QCanMessageDescription extractMessage(const Tokens &tokens);
+    template <typename View>
+    bool parseSignal(const View data);
+    template <typename Tokens>
+    QCanSignalDescription extractSignal(const Tokens &tokens);
+    template <typename View>
+    void parseSignalType(const View data);
+    template <typename View>
+    void parseComment(const View data);
+    template <typename View>
+    void parseExtendedMux(const View data);
+    template <typename View>
+    void parseValueDescriptions(const View data);
     void postProcessSignalMultiplexing();
 
     void addWarning(QString &&warning);
     void addCurrentMessage();
+    void insertMessage(QCanMessageDescription &&message);
+    QString intern(const QString &str);
 
     QList<QCanMessageDescription> getMessages() const;
 
+    QString m_cacheFileName;
+    bool m_lazyLoading = false;
+    std::shared_ptr<QCanDbcLazyIndex> m_lazyIndex;
     QString m_fileName;
     QCanDbcFileParser::Error m_error = QCanDbcFileParser::Error::None;
     QString m_errorString;
@@ -56,6 +134,27 @@ public:
     QCanMessageDescription m_currentMessage;
     QHash<QtCanBus::UniqueId, QCanMessageDescription> m_messageDescriptions;
     QCanDbcFileParser::MessageValueDescriptions m_valueDescriptions;
+    // Equal strings of all descriptions created from one database share
+    // their data, e.g. the units, receivers and value descriptions.
+    QSet<QString> m_stringPool;
+
+    // A part of the message section of a file, parsed by a worker instance.
+    struct MessageChunk
+    {
+        qsizetype file = 0;
+        qsizetype begin = 0;
+        qsizetype end = 0;
+        // completed messages, each with the number of warnings added before it
+        QList<std::pair<qsizetype, QCanMessageDescription>> messages;
+        QStringList warnings;
+        QCanDbcFileParser::Error error = QCanDbcFileParser::Error::None;
+        QString errorString;
+        // start of extra data on the same line as a message definition
+        qsizetype extraDataOffset = -1;
+    };
+    static constexpr qsizetype kMinChunkSize = 64 * 1024;
+    // only set for worker instances
+    MessageChunk *m_chunk = nullptr;
 };
 
 QT_END_NAMESPACE
@@ -11,9 +11,15 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QMap>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/QVariant>
 #include <QtCore/QtEndian>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
 QT_BEGIN_NAMESPACE
 
 // The initial revision of QCanFrameProcessor introduced the BE data processing
@@ -77,6 +83,8 @@ static quint16 extractMaxBitNum(quint16 startBit, quint16 bitLength, QSysInfo::E
             All message descriptions \e must have distinct unique identifiers.
             Each message can contain multiple signal descriptions, but signal
             names within one message \e must be unique as well.
+            Alternatively, use the \l setMessageDescriptionProvider() method
+            to load the message descriptions on demand.
     \endlist
 
     The \l parseFrame() method can be used to process the incoming
@@ -123,6 +131,108 @@ static quint16 extractMaxBitNum(quint16 startBit, quint16 bitLength, QSysInfo::E
                          of the error.
 */
 
+/*!
+    \typealias QCanFrameProcessor::MessageDescriptionProvider
+    \since 6.7
+
+    This is a type alias for
+    \c {std::function<QCanMessageDescription(QtCanBus::UniqueId)>}.
+
+    The function returns the message description for the given unique
+    identifier, or an invalid description if there is no such message.
+
+    \sa setMessageDescriptionProvider()
+*/
+
+/*!
+    \typealias QCanFrameProcessor::ValueDescriptions
+    \since 6.7
+
+    This is a type alias for \c {QHash<quint32, QString>}.
+
+    The keys of the hash represent raw signal values, and the values of the
+    hash represent corresponding string descriptions.
+*/
+
+/*!
+    \typealias QCanFrameProcessor::SignalValueDescriptions
+    \since 6.7
+
+    This is a type alias for \c {QHash<QString, ValueDescriptions>}.
+
+    The keys of the hash represent signal names, and the values of the
+    hash contain the corresponding \l QCanFrameProcessor::ValueDescriptions
+    entries.
+*/
+
+/*!
+    \typealias QCanFrameProcessor::MessageValueDescriptions
+    \since 6.7
+
+    This is a type alias for
+    \c {QHash<QtCanBus::UniqueId, SignalValueDescriptions>}.
+
+    The keys of the hash represent message unique ids, and the values of the
+    hash contain the corresponding
+    \l QCanFrameProcessor::SignalValueDescriptions entries.
+*/
+
+/*!
+    \typealias QCanFrameProcessor::ValueTextHandle
+    \since 6.7
+
+    A handle of a value text, as returned by \l decodeFrame(). Negative
+    values mean that there is no text.
+
+    \sa valueText()
+*/
+
+/*!
+    \struct QCanFrameProcessor::DecodedSignal
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The struct holds one decoded signal of the result of
+    \l QCanFrameProcessor::decodeFrame().
+*/
+
+/*!
+    \variable QCanFrameProcessor::DecodedSignal::name
+    \brief the \l {QCanSignalDescription::name}{name} of the signal.
+*/
+
+/*!
+    \variable QCanFrameProcessor::DecodedSignal::value
+    \brief the decoded value of the signal.
+*/
+
+/*!
+    \variable QCanFrameProcessor::DecodedSignal::valueText
+    \brief the handle of the text that describes the raw value of the
+    signal, or a negative value if there is no such text.
+
+    \sa QCanFrameProcessor::valueText()
+*/
+
+/*!
+    \struct QCanFrameProcessor::DecodeResult
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The struct is used as a return value for the
+    \l QCanFrameProcessor::decodeFrame() method.
+*/
+
+/*!
+    \variable QCanFrameProcessor::DecodeResult::uniqueId
+    \brief the value of the unique identifier of the decoded frame.
+*/
+
+/*!
+    \variable QCanFrameProcessor::DecodeResult::signalValues
+    \brief the list of the decoded signals.
+*/
+
 /*!
     \struct QCanFrameProcessor::ParseResult
     \inmodule QtSerialBus
@@ -200,16 +310,16 @@ QCanBusFrame QCanFrameProcessor::prepareFrame(QtCanBus::UniqueId uniqueId,
         return QCanBusFrame(QCanBusFrame::InvalidFrame);
     }
 
-    if (!d->messages.contains(uniqueId)) {
+    const QCanMessageDescription *message = d->findMessage(uniqueId);
+    if (!message) {
         d->setError(Error::Encoding,
                     QObject::tr("Failed to find message description for unique id %1.").
                     arg(qToUnderlying(uniqueId)));
         return QCanBusFrame(QCanBusFrame::InvalidFrame);
     }
 
-    const auto message = d->messages.value(uniqueId);
     QCanBusFrame::FrameId canFrameId = 0; // may be modified by the signal values
-    QByteArray payload(message.size(), 0x00);
+    QByteArray payload(message->size(), 0x00);
 
     // encode the uniqueId value into the frame on the proper position
     {
@@ -244,17 +354,18 @@ QCanBusFrame QCanFrameProcessor::prepareFrame(QtCanBus::UniqueId uniqueId,
         return true;
     };
 
-    auto descriptionsHash = QCanMessageDescriptionPrivate::get(message)->messageSignals;
+    const auto *messagePrivate = QCanMessageDescriptionPrivate::get(*message);
     for (auto it = signalValues.cbegin(); it != signalValues.cend(); ++it) {
         const QString &signalName = it.key();
-        if (!descriptionsHash.contains(signalName)) {
+        const QCanSignalDescription *signalDescPtr = messagePrivate->signalForName(signalName);
+        if (!signalDescPtr) {
             d->addWarning(QObject::tr("Skipping signal %1. It is not found in "
                                       "message description for unique id %2.").
                           arg(signalName, QString::number(qToUnderlying(uniqueId))));
             continue;
         }
 
-        const auto &signalDesc = descriptionsHash.value(signalName);
+        const auto &signalDesc = *signalDescPtr;
         if (!signalDesc.isValid()) {
             d->addWarning(QObject::tr("Skipping signal %1. Its description is invalid.").
                           arg(signalName));
@@ -323,6 +434,9 @@ QStringList QCanFrameProcessor::warnings() const
     Returns all the message descriptions that are currently used by this frame
     processor.
 
+    The list includes the descriptions that were loaded from the
+    \l messageDescriptionProvider() so far.
+
     \sa addMessageDescriptions(), setMessageDescriptions(),
     clearMessageDescriptions()
 */
@@ -348,8 +462,12 @@ QList<QCanMessageDescription> QCanFrameProcessor::messageDescriptions() const
 */
 void QCanFrameProcessor::addMessageDescriptions(const QList<QCanMessageDescription> &descriptions)
 {
-    for (const auto &desc : descriptions)
+    for (const auto &desc : descriptions) {
         d->messages.insert(desc.uniqueId(), desc);
+        if (!d->valueDescriptions.isEmpty())
+            d->updateValueTables(desc);
+    }
+    d->updateMessageLookup();
 }
 
 /*!
@@ -362,6 +480,7 @@ void QCanFrameProcessor::addMessageDescriptions(const QList<QCanMessageDescripti
 void QCanFrameProcessor::setMessageDescriptions(const QList<QCanMessageDescription> &descriptions)
 {
     d->messages.clear();
+    d->valueTables.clear();
     addMessageDescriptions(descriptions);
 }
 
@@ -374,6 +493,120 @@ void QCanFrameProcessor::setMessageDescriptions(const QList<QCanMessageDescripti
 void QCanFrameProcessor::clearMessageDescriptions()
 {
     d->messages.clear();
+    d->valueTables.clear();
+    d->updateMessageLookup();
+}
+
+/*!
+    \since 6.7
+
+    Returns the function that is used to load message descriptions on demand.
+
+    \sa setMessageDescriptionProvider()
+*/
+QCanFrameProcessor::MessageDescriptionProvider
+QCanFrameProcessor::messageDescriptionProvider() const
+{
+    return d->messageProvider;
+}
+
+/*!
+    \since 6.7
+
+    Sets the function that is used to load message descriptions on demand to
+    \a provider.
+
+    If \l prepareFrame(), \l parseFrame() or \l createFrameBuilder() need a
+    unique identifier that has no message description, \a provider is called
+    with this unique identifier. A valid description with the same unique
+    identifier is added to the \l messageDescriptions(), so the provider is
+    called at most once for each message. Unique identifiers for which the
+    provider returns an invalid description are remembered as well, and are
+    not requested again until a new provider is set.
+
+    This allows to start processing frames without creating the descriptions
+    of all messages of a large database up front. Use
+    \l QCanDbcFileParser::messageDescriptionProvider() to get a provider that
+    parses the messages of a DBC file only when they are needed.
+
+    \code
+    QCanDbcFileParser fileParser;
+    fileParser.setLazyLoading(true);
+    const bool result = fileParser.parse(u"path/to/file.dbc"_s);
+    // Check result, call error() and warnings() if needed
+
+    QCanFrameProcessor frameProcessor;
+    frameProcessor.setUniqueIdDescription(QCanDbcFileParser::uniqueIdDescription());
+    frameProcessor.setMessageDescriptionProvider(fileParser.messageDescriptionProvider());
+    \endcode
+
+    Pass an empty function to disable the on-demand loading. The descriptions
+    that were already loaded are kept.
+
+    \sa messageDescriptionProvider(), addMessageDescriptions()
+*/
+void QCanFrameProcessor::setMessageDescriptionProvider(const MessageDescriptionProvider &provider)
+{
+    d->messageProvider = provider;
+    d->unavailableMessages.clear();
+}
+
+/*!
+    \since 6.7
+
+    Returns the textual descriptions of the raw signal values that are used by
+    \l decodeFrame().
+
+    \sa setValueDescriptions()
+*/
+QCanFrameProcessor::MessageValueDescriptions QCanFrameProcessor::valueDescriptions() const
+{
+    return d->valueDescriptions;
+}
+
+/*!
+    \since 6.7
+
+    Sets the textual descriptions of the raw signal values to \a descriptions.
+    The keys of the outer hash are the unique ids of the messages, and the
+    keys of the inner hash are the names of the signals. Such descriptions can
+    be extracted from DBC files using
+    \l QCanDbcFileParser::messageValueDescriptions().
+
+    The descriptions of each signal are compiled into a lookup table, which is
+    indexed directly by the raw value if the values cover a small range, and
+    searched otherwise. \l decodeFrame() uses the tables to find the text for
+    each decoded signal value. The descriptions only apply to integer signals.
+
+    Setting new descriptions invalidates all value text handles that were
+    returned so far.
+
+    \sa valueDescriptions(), decodeFrame(), valueText()
+*/
+void QCanFrameProcessor::setValueDescriptions(const MessageValueDescriptions &descriptions)
+{
+    d->valueDescriptions = descriptions;
+    d->valueTables.clear();
+    d->valueTexts.clear();
+    d->valueTextHandles.clear();
+    for (auto it = descriptions.cbegin(); it != descriptions.cend(); ++it) {
+        const auto messageIt = d->messages.constFind(it.key());
+        if (messageIt != d->messages.cend())
+            d->updateValueTables(messageIt.value());
+    }
+}
+
+/*!
+    \since 6.7
+
+    Returns the text for the value text \a handle, which was returned by
+    \l decodeFrame(). Returns an empty string if the handle is invalid.
+
+    \sa decodeFrame(), setValueDescriptions()
+*/
+QString QCanFrameProcessor::valueText(ValueTextHandle handle) const
+{
+    return d->valueTexts.value(handle);
 }
 
 /*!
@@ -402,6 +635,7 @@ QCanUniqueIdDescription QCanFrameProcessor::uniqueIdDescription() const
 void QCanFrameProcessor::setUniqueIdDescription(const QCanUniqueIdDescription &description)
 {
     d->uidDescription = description;
+    d->updateUniqueIdExtractor();
 }
 
 /*!
@@ -437,101 +671,367 @@ QCanFrameProcessor::ParseResult QCanFrameProcessor::parseFrame(const QCanBusFram
 {
     d->resetErrors();
 
-    if (!frame.isValid()) {
-        d->setError(Error::InvalidFrame, QObject::tr("Invalid frame."));
+    // The unique id and all signals are extracted from one padded copy of the frame data.
+    const QCanFrameProcessorPrivate::FrameData frameData(frame);
+    QtCanBus::UniqueId uniqueId = QtCanBus::UniqueId{0};
+    const QCanMessageDescription *message = d->findMessageForFrame(frame, frameData, &uniqueId);
+    if (!message)
         return {};
+
+    QVariantMap parsedSignals;
+    d->decodeSignals(frameData, *message, &parsedSignals, [](qsizetype, const QVariant &) {});
+    return {uniqueId, parsedSignals};
+}
+
+/*!
+    \since 6.7
+
+    Decodes the frame \a frame using the specified message descriptions, like
+    \l parseFrame() does.
+
+    The signals are returned as a list of
+    \l {QCanFrameProcessor::}{DecodedSignal} entries instead of a map. The
+    names of the signals share their data with the signal descriptions, so
+    no strings are created or compared for the signals that are not
+    multiplexed.
+
+    If \l valueDescriptions() are available for a signal, the raw value of the
+    signal is looked up in them, and the handle of the matching text is
+    returned in \l {QCanFrameProcessor::DecodedSignal::}{valueText}. Use
+    \l valueText() to get the text. Equal texts share one handle, so
+    applications that display many frames can cache whatever they render for
+    a handle.
+
+    \code
+    const QCanFrameProcessor::DecodeResult result = frameProcessor.decodeFrame(frame);
+    for (const QCanFrameProcessor::DecodedSignal &signal : result.signalValues) {
+        if (signal.valueText >= 0)
+            show(signal.name, frameProcessor.valueText(signal.valueText));
+        else
+            show(signal.name, signal.value.toString());
     }
-    if (frame.frameType() != QCanBusFrame::DataFrame) {
-        d->setError(Error::UnsupportedFrameFormat, QObject::tr("Unsupported frame format."));
+    \endcode
+
+    \note Calling this method clears all previous errors and warnings.
+
+    \sa parseFrame(), setValueDescriptions()
+*/
+QCanFrameProcessor::DecodeResult QCanFrameProcessor::decodeFrame(const QCanBusFrame &frame)
+{
+    d->resetErrors();
+
+    const QCanFrameProcessorPrivate::FrameData frameData(frame);
+    DecodeResult result;
+    const QCanMessageDescription *message =
+            d->findMessageForFrame(frame, frameData, &result.uniqueId);
+    if (!message)
         return {};
-    }
+
+    const auto &messageSignals = QCanMessageDescriptionPrivate::get(*message)->messageSignals;
+    const auto tablesIt = d->valueTables.constFind(result.uniqueId);
+    const auto *tables = tablesIt != d->valueTables.cend() ? &tablesIt.value() : nullptr;
+    result.signalValues.reserve(messageSignals.size());
+    d->decodeSignals(frameData, *message, nullptr, [&](qsizetype index, const QVariant &value) {
+        const QCanSignalDescription &signalDesc = messageSignals.at(index);
+        ValueTextHandle handle = -1;
+        if (tables) {
+            handle = QCanFrameProcessorPrivate::findValueText(tables->at(index), value,
+                                                              signalDesc);
+        }
+        result.signalValues.append({signalDesc.name(), value, handle});
+    });
+    return result;
+}
+
+/*!
+    \since 6.7
+
+    Creates a \l {QCanFrameProcessor::}{FrameBuilder} for the message
+    described by \a uniqueId.
+
+    The builder holds a copy of the message description and a preallocated
+    frame with \a uniqueId already encoded, so it can be used to update and
+    send periodic messages without looking up the message description or the
+    signal names again. Later changes to the message descriptions of this
+    processor do not affect already created builders.
+
+    Signals whose description is invalid or does not fit into the message are
+    skipped, and a warning is added for each of them.
+
+    If no suitable message description is found, or the unique identifier
+    cannot be encoded, an invalid builder is returned. In such cases, the
+    \l error() and \l errorString() methods can be used to get information
+    about the errors.
+
+    \note Calling this method clears all previous errors and warnings.
+
+    \sa prepareFrame(), FrameBuilder
+*/
+QCanFrameProcessor::FrameBuilder QCanFrameProcessor::createFrameBuilder(QtCanBus::UniqueId uniqueId)
+{
+    d->resetErrors();
+
     if (!d->uidDescription.isValid()) {
-        d->setError(Error::Decoding,
+        d->setError(Error::Encoding,
                     QObject::tr("No valid unique identifier description is specified."));
         return {};
     }
 
-    const auto uidOpt = d->extractUniqueId(frame);
-    if (!uidOpt.has_value()) {
-        d->setError(Error::Decoding,
-                    QObject::tr("Failed to extract unique id from the frame."));
-        return {};
-    }
-
-    const auto uniqueId = uidOpt.value();
-    if (!d->messages.contains(uniqueId)) {
-        d->setError(Error::Decoding,
-                    QObject::tr("Could not find a message description for unique id %1.").
+    const QCanMessageDescription *message = d->findMessage(uniqueId);
+    if (!message) {
+        d->setError(Error::Encoding,
+                    QObject::tr("Failed to find message description for unique id %1.").
                     arg(qToUnderlying(uniqueId)));
         return {};
     }
 
-    const auto message = d->messages.value(uniqueId);
-    if (message.size() != frame.payload().size()) {
-        d->setError(Error::Decoding,
-                    QObject::tr("Payload size does not match message description. "
-                                "Actual size = %1, expected size = %2.").
-                    arg(frame.payload().size()).arg(message.size()));
-        return {};
+    auto builderPrivate = std::make_unique<QCanFrameBuilderPrivate>();
+    builderPrivate->uniqueId = uniqueId;
+    builderPrivate->payload = QByteArray(message->size(), 0x00);
+
+    {
+        const bool uidInPayload = d->uidDescription.source() == QtCanBus::DataSource::Payload;
+        QByteArray &payload = builderPrivate->payload;
+        const quint16 bitsSize = uidInPayload ? payload.size() * 8 : 29;
+        unsigned char *data = uidInPayload
+                ? reinterpret_cast<unsigned char *>(payload.data())
+                : reinterpret_cast<unsigned char *>(&builderPrivate->frameId);
+        if (!d->fillUniqueId(data, bitsSize, uniqueId)) {
+            d->setError(Error::Encoding,
+                        QObject::tr("Failed to encode unique id %1 into the frame").
+                        arg(qToUnderlying(uniqueId)));
+            return {};
+        }
     }
+    builderPrivate->initialFrameId = builderPrivate->frameId;
+    builderPrivate->initialPayload = builderPrivate->payload;
 
-    QVariantMap parsedSignals;
-    // The multiplexor signals can form a complex dependency, so we can't
-    // simply iterate through the signal descriptions in a natural order.
-    // Instead, we first need to process all signals with no dependency on
-    // other multiplexors, then handle the signals that have dependency on
-    // already parsed signals, and so on, until we parse all signals.
-    // One potential problem here is that the dependencies can be specified
-    // incorrectly (for example, we can have circular dependencies, or
-    // dependencies on non-existent signal), so we need to come up with a
-    // reasonable condition to stop.
+    const auto &descriptionsHash = QCanMessageDescriptionPrivate::get(*message)->messageSignals;
+    for (const auto &signalDesc : descriptionsHash) {
+        if (!signalDesc.isValid()) {
+            d->addWarning(QObject::tr("Skipping signal %1. Its description is invalid.").
+                          arg(signalDesc.name()));
+            continue;
+        }
+        const bool dataInPayload = signalDesc.dataSource() == QtCanBus::DataSource::Payload;
+        const quint16 maxDataLength = dataInPayload ? builderPrivate->payload.size() * 8 : 29;
+        const auto signalDataEnd = extractMaxBitNum(signalDesc.startBit(), signalDesc.bitLength(),
+                                                    signalDesc.dataEndian());
+        if (signalDataEnd >= maxDataLength) {
+            d->addWarning(QObject::tr("Skipping signal %1. Its length exceeds the expected "
+                                      "message length.").arg(signalDesc.name()));
+            continue;
+        }
+        builderPrivate->handles.insert(signalDesc.name(), builderPrivate->entries.size());
+        builderPrivate->entries.append({signalDesc, dataInPayload, {}, {}});
+    }
 
-    auto seenNeededSignals = [](const QCanSignalDescription &desc,
-                                const QVariantMap &parsedSignals) -> bool {
-        const auto muxSignals = desc.multiplexSignals();
-        if (muxSignals.isEmpty())
-            return true;
-        const auto *descPrivate = QCanSignalDescriptionPrivate::get(desc);
+    // resolve the multiplexor names once
+    for (auto &entry : builderPrivate->entries) {
+        const auto muxSignals = entry.description.multiplexSignals();
         for (auto it = muxSignals.cbegin(); it != muxSignals.cend(); ++it) {
-            const auto &name = it.key();
-            const auto &ranges = it.value();
-            if (!parsedSignals.contains(name)
-                    || !descPrivate->muxValueInRange(parsedSignals.value(name), ranges)) {
-                return false;
-            }
+            // an unknown multiplexor can never be set, keep it as an invalid handle
+            const qsizetype muxHandle = builderPrivate->handles.value(it.key(), -1);
+            entry.multiplexors.append({muxHandle, it.value()});
+            if (muxHandle >= 0)
+                builderPrivate->entries[muxHandle].isMultiplexor = true;
         }
+    }
+
+    FrameBuilder builder;
+    builder.d = std::move(builderPrivate);
+    return builder;
+}
+
+/*!
+    \class QCanFrameProcessor::FrameBuilder
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The FrameBuilder class encodes signal values into a preallocated
+    CAN frame of one message.
+
+    A frame builder is created by \l QCanFrameProcessor::createFrameBuilder().
+    It is meant for messages that are sent periodically, where only a few
+    signals change between two frames.
+
+    The signals are addressed by handles that are resolved once, using
+    \l signalHandle(). Calling \l setSignalValue() encodes only the bits of
+    the given signal. All other bits keep their previous values, so the
+    complete message does not need to be provided again.
+
+    \l frame() returns a frame that shares the payload with the builder, so
+    it does not allocate memory. The payload is only copied if the builder is
+    modified while a previously returned frame is still in use.
+
+    \sa QCanFrameProcessor::prepareFrame()
+*/
+
+/*!
+    \typealias QCanFrameProcessor::FrameBuilder::SignalHandle
+
+    The type used to address a signal of the builder's message. Negative
+    values represent invalid handles.
+*/
+
+/*!
+    Creates an invalid frame builder.
+
+    \sa QCanFrameProcessor::createFrameBuilder()
+*/
+QCanFrameProcessor::FrameBuilder::FrameBuilder() = default;
+
+/*!
+    Move-constructs a frame builder from \a other.
+*/
+QCanFrameProcessor::FrameBuilder::FrameBuilder(FrameBuilder &&other) noexcept = default;
+
+/*!
+    Move-assigns \a other to this frame builder.
+*/
+QCanFrameProcessor::FrameBuilder &
+QCanFrameProcessor::FrameBuilder::operator=(FrameBuilder &&other) noexcept = default;
+
+/*!
+    Destroys this frame builder.
+*/
+QCanFrameProcessor::FrameBuilder::~FrameBuilder() = default;
+
+/*!
+    Returns \c true if the builder was successfully created for a message;
+    otherwise \c false.
+*/
+bool QCanFrameProcessor::FrameBuilder::isValid() const
+{
+    return d != nullptr;
+}
+
+/*!
+    Returns the unique identifier of the builder's message.
+*/
+QtCanBus::UniqueId QCanFrameProcessor::FrameBuilder::uniqueId() const
+{
+    return d ? d->uniqueId : QtCanBus::UniqueId{0};
+}
+
+/*!
+    Returns the handle of the signal called \a name, or a negative value if
+    the message does not have such a signal, or if the signal was skipped when
+    creating the builder.
+
+    \sa setSignalValue()
+*/
+QCanFrameProcessor::FrameBuilder::SignalHandle
+QCanFrameProcessor::FrameBuilder::signalHandle(const QString &name) const
+{
+    return d ? d->handles.value(name, -1) : -1;
+}
+
+/*!
+    Encodes \a value into the frame at the position of the signal addressed
+    by \a handle. Only the bits of this signal are modified.
+
+    Multiplexed signals can only be set if the values of their multiplexor
+    signals are set and match the multiplexor ranges of the signal description.
+    If the value of a multiplexor signal changes, the multiplexed signals that
+    no longer match it are removed from the frame, and their values are reset.
+
+    Returns \c true if the value was encoded; otherwise \c false, i.e. if the
+    handle is invalid or the multiplexor preconditions are not met.
+
+    \sa signalHandle(), signalValue(), frame()
+*/
+bool QCanFrameProcessor::FrameBuilder::setSignalValue(SignalHandle handle, const QVariant &value)
+{
+    if (!d || handle < 0 || handle >= d->entries.size())
+        return false;
+
+    auto &entry = d->entries[handle];
+    if (!d->multiplexorsMatch(entry))
+        return false;
+
+    unsigned char *data = entry.inPayload ? reinterpret_cast<unsigned char *>(d->payload.data())
+                                          : reinterpret_cast<unsigned char *>(&d->frameId);
+    QCanFrameProcessorPrivate::encodeSignal(data, value, entry.description);
+    entry.value = value;
+    if (entry.isMultiplexor)
+        d->dropUnmatchedSignals();
+    return true;
+}
+
+/*!
+    Returns the last value set for the signal addressed by \a handle, or an
+    invalid QVariant if no value was set.
+
+    \sa setSignalValue()
+*/
+QVariant QCanFrameProcessor::FrameBuilder::signalValue(SignalHandle handle) const
+{
+    if (!d || handle < 0 || handle >= d->entries.size())
+        return {};
+    return d->entries.at(handle).value;
+}
+
+/*!
+    Returns the frame with the unique identifier and all signal values that
+    were set so far. The parts of the frame that are not covered by the unique
+    identifier or any set signal contain zeros.
+
+    Returns an invalid frame if the builder is invalid.
+*/
+QCanBusFrame QCanFrameProcessor::FrameBuilder::frame() const
+{
+    if (!d)
+        return QCanBusFrame(QCanBusFrame::InvalidFrame);
+    return QCanBusFrame(d->frameId, d->payload);
+}
+
+bool QCanFrameBuilderPrivate::multiplexorsMatch(const SignalEntry &entry) const
+{
+    if (entry.multiplexors.isEmpty())
         return true;
-    };
+    const auto *descPrivate = QCanSignalDescriptionPrivate::get(entry.description);
+    for (const auto &[handle, ranges] : entry.multiplexors) {
+        if (handle < 0)
+            return false;
+        const QVariant &muxValue = entries.at(handle).value;
+        if (!muxValue.isValid() || !descPrivate->muxValueInRange(muxValue, ranges))
+            return false;
+    }
+    return true;
+}
 
-    auto descriptionsHash = QCanMessageDescriptionPrivate::get(message)->messageSignals;
-    while (true) {
-        QList<QString> newNames;
-        for (const auto &desc : std::as_const(descriptionsHash)) {
-            if (seenNeededSignals(desc, parsedSignals)) {
-                newNames.push_back(desc.name());
-                if (!desc.isValid()) {
-                    d->addWarning(QObject::tr("Skipping signal %1 in message with unique id %2"
-                                              " because its description is invalid.").
-                                  arg(desc.name(), QString::number(qToUnderlying(uniqueId))));
-                    continue;
-                }
-                const QVariant value = d->decodeSignal(frame, desc);
-                if (value.isValid())
-                    parsedSignals.insert(desc.name(), value);
+/*
+    Resets the values of the multiplexed signals that do not match their
+    multiplexors any more. The signals may share bits with the signals that
+    match now, so the frame is encoded again from the remaining values.
+*/
+void QCanFrameBuilderPrivate::dropUnmatchedSignals()
+{
+    bool dropped = false;
+    // a dropped signal can be the multiplexor of other signals
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto &entry : entries) {
+            if (entry.value.isValid() && !multiplexorsMatch(entry)) {
+                entry.value = QVariant();
+                changed = true;
+                dropped = true;
             }
         }
-        for (const auto &name : std::as_const(newNames))
-            descriptionsHash.remove(name);
-        if (newNames.isEmpty() || descriptionsHash.isEmpty()) {
-            // We either processed all signals, or failed to process more during
-            // the last loop. The latter means that the multiplexor conditions
-            // do not match for the rest of the signals, which is fine and will
-            // always happen when multiplexing
-            break;
-        }
     }
+    if (!dropped)
+        return;
 
-    return {uniqueId, parsedSignals};
+    frameId = initialFrameId;
+    payload = initialPayload;
+    for (const auto &entry : std::as_const(entries)) {
+        if (!entry.value.isValid())
+            continue;
+        unsigned char *data = entry.inPayload ? reinterpret_cast<unsigned char *>(payload.data())
+                                              : reinterpret_cast<unsigned char *>(&frameId);
+        QCanFrameProcessorPrivate::encodeSignal(data, entry.value, entry.description);
+    }
 }
 
 /* QCanFrameProcessorPrivate implementation */
@@ -554,7 +1054,18 @@ void QCanFrameProcessorPrivate::addWarning(const QString &warning)
     warnings.push_back(warning);
 }
 
-QVariant QCanFrameProcessorPrivate::decodeSignal(const QCanBusFrame &frame,
+QCanFrameProcessorPrivate::FrameData::FrameData(const QCanBusFrame &frame)
+    : frameId(frame.frameId()), extendedFrameFormat(frame.hasExtendedFrameFormat())
+{
+    const QByteArray data = frame.payload();
+    payloadSize = data.size();
+    payload.resize(payloadSize + Padding);
+    memcpy(payload.data(), data.constData(), payloadSize);
+    memset(payload.data() + payloadSize, 0, Padding);
+    memcpy(frameIdData, &frameId, sizeof(frameId));
+}
+
+QVariant QCanFrameProcessorPrivate::decodeSignal(const FrameData &frameData,
                                                  const QCanSignalDescription &signalDesc)
 {
     const auto signalDataEnd = extractMaxBitNum(signalDesc.startBit(), signalDesc.bitLength(),
@@ -562,23 +1073,19 @@ QVariant QCanFrameProcessorPrivate::decodeSignal(const QCanBusFrame &frame,
     const bool dataFromPayload =
             signalDesc.dataSource() == QtCanBus::DataSource::Payload;
 
-    const auto frameIdLength = frame.hasExtendedFrameFormat() ? 29 : 11;
-    const auto maxDataLength = dataFromPayload ? frame.payload().size() * 8
+    const auto frameIdLength = frameData.extendedFrameFormat ? 29 : 11;
+    const auto maxDataLength = dataFromPayload ? frameData.payloadSize * 8
                                                : frameIdLength;
 
     if (signalDataEnd >= maxDataLength) {
         addWarning(QObject::tr("Skipping signal %1 in message with unique id %2. "
                                "Its expected length exceeds the data length.").
-                   arg(signalDesc.name(), QString::number(frame.frameId())));
+                   arg(signalDesc.name(), QString::number(frameData.frameId)));
         return QVariant();
     }
 
-    const QByteArray payload = frame.payload();
-    const auto frameId = frame.frameId();
-    const unsigned char *data = dataFromPayload
-            ? reinterpret_cast<const unsigned char *>(payload.data())
-            : reinterpret_cast<const unsigned char *>(&frameId);
-
+    const unsigned char *data = dataFromPayload ? frameData.payload.constData()
+                                                : frameData.frameIdData;
     return parseData(data, signalDesc);
 }
 
@@ -621,8 +1128,78 @@ static double convertToCanValue(const QVariant &value, const QCanSignalDescripti
     return result;
 }
 
+// The signal values are extracted with 64-bit loads, instead of handling each
+// bit separately. The data must be padded with FrameData::Padding bytes, so
+// that a word can be loaded starting from any byte of the data. A signal has
+// at most 64 bits, so it spans at most 9 bytes: the loaded word and the byte
+// after it.
+
+static quint64 maskBits(quint64 bits, quint16 bitLength)
+{
+    return bitLength < 64 ? bits & ((quint64(1) << bitLength) - 1) : bits;
+}
+
+// Little Endian - the start bit is the LSB, and the signal is a contiguous
+// range of bits in LE byte order.
+static quint64 extractLittleEndianBits(const unsigned char *data, quint16 startBit,
+                                       quint16 bitLength)
+{
+    const unsigned char *first = data + startBit / 8;
+    const auto shift = startBit % 8;
+    quint64 bits = qFromLittleEndian<quint64>(first) >> shift;
+    if (shift + bitLength > 64)
+        bits |= quint64(first[8]) << (64 - shift);
+    return maskBits(bits, bitLength);
+}
+
+template <typename T>
+static QVariant valueFromBits(quint64 bits, const QCanSignalDescription &signalDesc)
+{
+    T value = {};
+    if constexpr (std::is_floating_point_v<T>) {
+        using Bits = std::conditional_t<sizeof(T) == sizeof(quint32), quint32, quint64>;
+        const Bits rawBits = Bits(bits);
+        memcpy(&value, &rawBits, sizeof(T));
+    } else if constexpr (std::is_signed_v<T>) {
+        // fill the most significant bits with the sign bit
+        const quint64 signBit = quint64(1) << (signalDesc.bitLength() - 1);
+        value = T((bits ^ signBit) - signBit);
+    } else {
+        value = T(bits);
+    }
+    // perform value conversions, if needed
+    if (needValueConversion(signalDesc))
+        return QVariant::fromValue(convertFromCanValue(value, signalDesc));
+
+    return QVariant::fromValue(value);
+}
+
 #ifdef USE_DBC_COMPATIBLE_BE_HANDLING
 
+// Big Endian - the start bit is the MSB. The signal continues with the lower
+// bits of the start byte, and then with the following bytes, starting from
+// their MSBs. If we want to extract BE data from the middle 12 bits of a
+// 2-byte payload, we will need to read bits 5-0 and 15-10:
+// _________________________________________________________________
+// |7      |6      |5(MSB) |4      |3      |2      |1      |0      |
+// -----------------------------------------------------------------
+// |15     |14     |13     |12     |11     |10(LSB)|9      |8      |
+// -----------------------------------------------------------------
+// So the signal is a contiguous range of bits in BE byte order.
+static quint64 extractBigEndianBits(const unsigned char *data, quint16 startBit,
+                                    quint16 bitLength)
+{
+    const unsigned char *first = data + startBit / 8;
+    const quint64 word = qFromBigEndian<quint64>(first);
+    // the position of the LSB of the signal in the word, negative if the
+    // signal continues in the byte after the word
+    const int lsbPos = 56 + startBit % 8 - bitLength + 1;
+    const quint64 bits = lsbPos >= 0
+            ? word >> lsbPos
+            : (word << -lsbPos) | (quint64(first[8]) >> (8 + lsbPos));
+    return maskBits(bits, bitLength);
+}
+
 template <typename T>
 static QVariant extractValue(const unsigned char *data, const QCanSignalDescription &signalDesc)
 {
@@ -632,106 +1209,11 @@ static QVariant extractValue(const unsigned char *data, const QCanSignalDescript
         Q_ASSERT(tBitLength == length);
     else
         Q_ASSERT(tBitLength >= length);
-    const auto maxBytesToRead = (length % 8 == 0) ? length / 8 : length / 8 + 1;
     const auto start = signalDesc.startBit();
-    T value = {};
-    const bool isBigEndian = signalDesc.dataEndian() == QSysInfo::Endian::BigEndian;
-    if (isBigEndian) {
-        // Big Endian - start bit is MSB
-        if (start % 8 == 7 && length % 8 == 0) {
-            // The data is aligned at byte offset, we can simply memcpy
-            memcpy(&value, &data[(start - 7) / 8], maxBytesToRead);
-        } else {
-            // Data is not aligned at byte offset, we need to do some bit
-            // shifting. We cannot perform bit operations on float or double
-            // types, so we convert the value to uchar *.
-            // Because of how BE data is organized, the indices for reading
-            // would not be continuous. If we want to extract BE data from the
-            // middle 12 bits of a 2-byte payload, we will need to read bits 5-0
-            // and 15-10:
-            // _________________________________________________________________
-            // |7      |6      |5(MSB) |4      |3      |2      |1      |0      |
-            // -----------------------------------------------------------------
-            // |15     |14     |13     |12     |11     |10(LSB)|9      |8      |
-            // -----------------------------------------------------------------
-            unsigned char *valueData = reinterpret_cast<unsigned char *>(&value);
-            qsizetype bitIdx = start;
-            for (qsizetype processedBits = 0; processedBits < length; ++processedBits) {
-                const auto dataByteIdx = bitIdx / 8;
-                const auto dataBitIdx = bitIdx % 8;
-                if (data[dataByteIdx] & (0x01 << dataBitIdx)) {
-                    const auto byteIdx = processedBits / 8;
-                    // start filling each byte from MSB
-                    const auto bitIdx = 7 - (processedBits % 8);
-                    valueData[byteIdx] |= (0x01 << bitIdx);
-                }
-                // handle jump like 0 -> 15 from the example above
-                if (bitIdx % 8 == 0)
-                    bitIdx += 15;
-                else
-                    --bitIdx;
-            }
-        }
-    } else {
-        // Little Endian - start bit is LSB
-        if (start % 8 == 0 && length % 8 == 0) {
-            // The data is aligned at byte offset, we can simply memcpy
-            memcpy(&value, &data[start / 8], maxBytesToRead);
-        } else {
-            // Data is not aligned at byte offset, we need to do some bit
-            // shifting. We cannot perform bit operations on float or double
-            // types, so we convert the value to uchar *.
-            unsigned char *valueData = reinterpret_cast<unsigned char *>(&value);
-            quint16 valueIdx = 0;
-            for (auto i = start; i < start + length; ++i, ++valueIdx) {
-                const auto byteIdx = i / 8;
-                const auto bitIdx = i % 8;
-                if (data[byteIdx] & (0x01 << bitIdx))
-                    valueData[valueIdx / 8] |= 0x01 << (valueIdx % 8);
-            }
-        }
-    }
-    // check and convert endian
-    T convertedValue = {};
-    if (isBigEndian)
-        convertedValue = qFromBigEndian(value);
-    else
-        convertedValue = qFromLittleEndian(value);
-    const bool endianChanged = convertedValue != value;
-    value = convertedValue;
-    // for signed & unsigned fill the most significant bits with proper values
-    if constexpr (std::is_integral_v<T>) {
-        if (tBitLength > length) {
-            if (endianChanged) {
-                // After endian conversion we have unneeded bits in the end,
-                // so we need to cut them
-                value = value >> (tBitLength - length);
-            }
-            // value has more bits than we could actually read, so we need to
-            // fill the most significant bits properly
-            const auto dataFormat = signalDesc.dataFormat();
-            if (dataFormat == QtCanBus::DataFormat::SignedInteger) {
-                if (value & (0x01ULL << (length - 1))) {
-                    // msb = 1 -> negative value, fill the rest with 1's
-                    for (auto i = length; i < tBitLength; ++i)
-                        value |= (0x01ULL << i);
-                } else {
-                    // msb = 0 -> positive value, fill the rest with 0's
-                    for (auto i = length; i < tBitLength; ++i)
-                        value &= ~(0x01ULL << i);
-                }
-            } else if (dataFormat == QtCanBus::DataFormat::UnsignedInteger) {
-                // simply fill most significant bits with 0's
-                for (auto i = length; i < tBitLength; ++i)
-                    value &= ~(0x01ULL << i);
-            }
-        }
-    }
-    // perform value conversions, if needed
-    if (needValueConversion(signalDesc))
-        return QVariant::fromValue(convertFromCanValue(value, signalDesc));
-
-    return QVariant::fromValue(value);
+    const quint64 bits = signalDesc.dataEndian() == QSysInfo::Endian::BigEndian
+            ? extractBigEndianBits(data, start, length)
+            : extractLittleEndianBits(data, start, length);
+    return valueFromBits<T>(bits, signalDesc);
 }
 
 #else
@@ -747,6 +1229,9 @@ static QVariant extractValue(const unsigned char *data, const QCanSignalDescript
         Q_ASSERT(tBitLength >= length);
     const auto maxBytesToRead = (length % 8 == 0) ? length / 8 : length / 8 + 1;
     const auto start = signalDesc.startBit();
+    if (signalDesc.dataEndian() == QSysInfo::Endian::LittleEndian)
+        return valueFromBits<T>(extractLittleEndianBits(data, start, length), signalDesc);
+
     T value = {};
     if (start % 8 == 0 && length % 8 == 0) {
         // The data is aligned at byte offset, we can simply memcpy
@@ -866,7 +1351,7 @@ QVariant QCanFrameProcessorPrivate::parseData(const unsigned char *data,
 {
     // We assume that signal's length does not exceed data size.
     // That is checked as a precondition to calling this method, so we do not
-    // pass size for the data.
+    // pass size for the data. The data must be padded, see FrameData.
     switch (signalDesc.dataFormat()) {
     case QtCanBus::DataFormat::SignedInteger:
         return extractValue<qint64>(data, signalDesc);
@@ -1106,46 +1591,368 @@ void QCanFrameProcessorPrivate::encodeSignal(unsigned char *data, const QVariant
     }
 }
 
+void QCanFrameProcessorPrivate::updateMessageLookup()
+{
+    directMessageLookup.clear();
+    if (messages.isEmpty())
+        return;
+
+    for (auto it = messages.cbegin(); it != messages.cend(); ++it) {
+        if (qToUnderlying(it.key()) >= DirectLookupSize)
+            return; // sparse (29-bit) ids, use the hash
+    }
+
+    directMessageLookup.resize(DirectLookupSize);
+    for (auto it = messages.cbegin(); it != messages.cend(); ++it)
+        directMessageLookup[qToUnderlying(it.key())] = it.value();
+}
+
+const QCanMessageDescription *
+QCanFrameProcessorPrivate::findMessage(QtCanBus::UniqueId uniqueId)
+{
+    const QCanMessageDescription *message = nullptr;
+    if (!directMessageLookup.isEmpty()) {
+        const auto index = qToUnderlying(uniqueId);
+        if (index < DirectLookupSize) {
+            if (const auto &entry = directMessageLookup.at(index))
+                message = &*entry;
+        }
+    } else {
+        const auto it = messages.constFind(uniqueId);
+        if (it != messages.cend())
+            message = &it.value();
+    }
+    return message || !messageProvider ? message : requestMessage(uniqueId);
+}
+
+const QCanMessageDescription *
+QCanFrameProcessorPrivate::requestMessage(QtCanBus::UniqueId uniqueId)
+{
+    if (unavailableMessages.contains(uniqueId))
+        return nullptr;
+
+    QCanMessageDescription message = messageProvider(uniqueId);
+    if (!message.isValid() || message.uniqueId() != uniqueId) {
+        unavailableMessages.insert(uniqueId);
+        return nullptr;
+    }
+    const auto it = messages.insert(uniqueId, std::move(message));
+    // only the slot of the new message changes
+    const auto index = qToUnderlying(uniqueId);
+    if (index >= DirectLookupSize)
+        directMessageLookup.clear(); // sparse (29-bit) ids, use the hash
+    else if (!directMessageLookup.isEmpty())
+        directMessageLookup[index] = it.value();
+    else if (messages.size() == 1)
+        updateMessageLookup();
+    if (!valueDescriptions.isEmpty())
+        updateValueTables(it.value());
+    return &it.value();
+}
+
+const QCanMessageDescription *
+QCanFrameProcessorPrivate::findMessageForFrame(const QCanBusFrame &frame,
+                                               const FrameData &frameData,
+                                               QtCanBus::UniqueId *uniqueId)
+{
+    using Error = QCanFrameProcessor::Error;
+    if (!frame.isValid()) {
+        setError(Error::InvalidFrame, QObject::tr("Invalid frame."));
+        return nullptr;
+    }
+    if (frame.frameType() != QCanBusFrame::DataFrame) {
+        setError(Error::UnsupportedFrameFormat, QObject::tr("Unsupported frame format."));
+        return nullptr;
+    }
+    if (!uidDescription.isValid()) {
+        setError(Error::Decoding,
+                 QObject::tr("No valid unique identifier description is specified."));
+        return nullptr;
+    }
+
+    const auto uidOpt = extractUniqueId(frameData);
+    if (!uidOpt.has_value()) {
+        setError(Error::Decoding,
+                 QObject::tr("Failed to extract unique id from the frame."));
+        return nullptr;
+    }
+
+    *uniqueId = uidOpt.value();
+    const QCanMessageDescription *message = findMessage(*uniqueId);
+    if (!message) {
+        setError(Error::Decoding,
+                 QObject::tr("Could not find a message description for unique id %1.").
+                 arg(qToUnderlying(*uniqueId)));
+        return nullptr;
+    }
+
+    if (message->size() != frameData.payloadSize) {
+        setError(Error::Decoding,
+                 QObject::tr("Payload size does not match message description. "
+                             "Actual size = %1, expected size = %2.").
+                 arg(frameData.payloadSize).arg(message->size()));
+        return nullptr;
+    }
+    return message;
+}
+
+/*!
+    \internal
+    Decodes the signals of \a message from \a frameData, and calls \a handler
+    with the index of the signal description and the value for each signal.
+
+    The values are also inserted into \a values, if it is not \c nullptr.
+*/
+template <typename Handler>
+void QCanFrameProcessorPrivate::decodeSignals(const FrameData &frameData,
+                                              const QCanMessageDescription &message,
+                                              QVariantMap *values, Handler handler)
+{
+    const auto &messageSignals = QCanMessageDescriptionPrivate::get(message)->messageSignals;
+
+    // The multiplexor signals can form a complex dependency, so we can't
+    // simply iterate through the signal descriptions in a natural order.
+    // Instead, we first need to process all signals with no dependency on
+    // other multiplexors, then handle the signals that have dependency on
+    // already parsed signals, and so on, until we parse all signals.
+    // One potential problem here is that the dependencies can be specified
+    // incorrectly (for example, we can have circular dependencies, or
+    // dependencies on non-existent signal), so we need to come up with a
+    // reasonable condition to stop.
+
+    // The values of the multiplexors are looked up by name, so all values are
+    // collected if any signal is multiplexed.
+    QVariantMap muxValues;
+    if (!values) {
+        const bool hasMultiplexedSignals =
+                std::any_of(messageSignals.cbegin(), messageSignals.cend(),
+                            [](const QCanSignalDescription &desc) {
+            return !QCanSignalDescriptionPrivate::get(desc)->muxSignals.isEmpty();
+        });
+        if (hasMultiplexedSignals)
+            values = &muxValues;
+    }
+
+    auto seenNeededSignals = [](const QCanSignalDescription &desc,
+                                const QVariantMap *parsedSignals) -> bool {
+        const auto *descPrivate = QCanSignalDescriptionPrivate::get(desc);
+        const auto &muxSignals = descPrivate->muxSignals;
+        if (muxSignals.isEmpty())
+            return true;
+        for (auto it = muxSignals.cbegin(); it != muxSignals.cend(); ++it) {
+            const auto &name = it.key();
+            const auto &ranges = it.value();
+            if (!parsedSignals->contains(name)
+                    || !descPrivate->muxValueInRange(parsedSignals->value(name), ranges)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    QVarLengthArray<qsizetype, 32> pendingSignals(messageSignals.size());
+    std::iota(pendingSignals.begin(), pendingSignals.end(), 0);
+    while (true) {
+        const qsizetype pendingCount = pendingSignals.size();
+        pendingSignals.removeIf([&](qsizetype index) {
+            const QCanSignalDescription &desc = messageSignals.at(index);
+            if (!seenNeededSignals(desc, values))
+                return false;
+            if (!desc.isValid()) {
+                addWarning(QObject::tr("Skipping signal %1 in message with unique id %2"
+                                       " because its description is invalid.").
+                           arg(desc.name(), QString::number(qToUnderlying(message.uniqueId()))));
+                return true;
+            }
+            const QVariant value = decodeSignal(frameData, desc);
+            if (value.isValid()) {
+                if (values)
+                    values->insert(desc.name(), value);
+                handler(index, value);
+            }
+            return true;
+        });
+        if (pendingSignals.size() == pendingCount || pendingSignals.isEmpty()) {
+            // We either processed all signals, or failed to process more during
+            // the last loop. The latter means that the multiplexor conditions
+            // do not match for the rest of the signals, which is fine and will
+            // always happen when multiplexing
+            break;
+        }
+    }
+}
+
+void QCanFrameProcessorPrivate::updateValueTables(const QCanMessageDescription &message)
+{
+    const auto uid = message.uniqueId();
+    const auto descriptionsIt = valueDescriptions.constFind(uid);
+    if (descriptionsIt == valueDescriptions.cend()) {
+        valueTables.remove(uid);
+        return;
+    }
+
+    const auto &messageSignals = QCanMessageDescriptionPrivate::get(message)->messageSignals;
+    QList<ValueTable> tables(messageSignals.size());
+    for (qsizetype i = 0; i < messageSignals.size(); ++i) {
+        const auto it = descriptionsIt->constFind(messageSignals.at(i).name());
+        if (it == descriptionsIt->cend() || it->isEmpty())
+            continue;
+
+        QList<std::pair<quint32, QCanFrameProcessor::ValueTextHandle>> entries;
+        entries.reserve(it->size());
+        for (auto entryIt = it->cbegin(); entryIt != it->cend(); ++entryIt)
+            entries.emplace_back(entryIt.key(), internValueText(entryIt.value()));
+        std::sort(entries.begin(), entries.end());
+
+        // Use a dense array, unless most of its entries would be unused.
+        ValueTable &table = tables[i];
+        const quint64 range = quint64(entries.constLast().first) - entries.constFirst().first + 1;
+        if (range <= qMax(quint64(entries.size()) * 2, quint64(16))) {
+            table.first = entries.constFirst().first;
+            table.dense.resize(range, -1);
+            for (const auto &[value, handle] : std::as_const(entries))
+                table.dense[value - table.first] = handle;
+        } else {
+            table.sparse = std::move(entries);
+        }
+    }
+    valueTables.insert(uid, std::move(tables));
+}
+
+QCanFrameProcessor::ValueTextHandle QCanFrameProcessorPrivate::internValueText(const QString &text)
+{
+    const auto it = valueTextHandles.constFind(text);
+    if (it != valueTextHandles.cend())
+        return it.value();
+    const auto handle = QCanFrameProcessor::ValueTextHandle(valueTexts.size());
+    valueTexts.append(text);
+    valueTextHandles.insert(text, handle);
+    return handle;
+}
+
+QCanFrameProcessor::ValueTextHandle
+QCanFrameProcessorPrivate::ValueTable::find(quint32 value) const
+{
+    if (!dense.isEmpty()) {
+        return value >= first && value - first < quint32(dense.size())
+                ? dense.at(value - first) : -1;
+    }
+    const auto it = std::lower_bound(sparse.cbegin(), sparse.cend(), value,
+                                     [](const auto &entry, quint32 v) {
+        return entry.first < v;
+    });
+    return it != sparse.cend() && it->first == value ? it->second : -1;
+}
+
+QCanFrameProcessor::ValueTextHandle
+QCanFrameProcessorPrivate::findValueText(const ValueTable &table, const QVariant &value,
+                                         const QCanSignalDescription &signalDesc)
+{
+    // there are no value descriptions for floating point or string data
+    const auto format = signalDesc.dataFormat();
+    if (format != QtCanBus::DataFormat::SignedInteger
+            && format != QtCanBus::DataFormat::UnsignedInteger) {
+        return -1;
+    }
+
+    constexpr auto maxRawValue = std::numeric_limits<quint32>::max();
+    if (needValueConversion(signalDesc)) {
+        // The value descriptions refer to the raw values, so the conversion
+        // is reverted, as it is done for the encoding.
+        const double raw = std::round(convertToCanValue(value, signalDesc));
+        return raw >= 0 && raw <= maxRawValue ? table.find(quint32(raw)) : -1;
+    }
+    if (format == QtCanBus::DataFormat::SignedInteger) {
+        const qint64 raw = value.toLongLong();
+        return raw >= 0 && raw <= maxRawValue ? table.find(quint32(raw)) : -1;
+    }
+    const quint64 raw = value.toULongLong();
+    return raw <= maxRawValue ? table.find(quint32(raw)) : -1;
+}
+
+void QCanFrameProcessorPrivate::updateUniqueIdExtractor()
+{
+    using Extractor = UniqueIdExtractor;
+    using UnderlyingType = std::underlying_type_t<QtCanBus::UniqueId>;
+    constexpr auto uidBitLength = sizeof(UnderlyingType) * 8;
+
+    Extractor extractor;
+    extractor.dataEnd = extractMaxBitNum(uidDescription.startBit(),
+                                         uidDescription.bitLength(),
+                                         uidDescription.endian());
+    if (!uidDescription.isValid()) {
+        uidExtractor = extractor;
+        return;
+    }
+
+    if (uidDescription.endian() == QSysInfo::Endian::LittleEndian) {
+        // For LE data the unique id is a contiguous range of bits, so it
+        // can be extracted with a single shift and mask.
+        const bool dataFromPayload = uidDescription.source() == QtCanBus::DataSource::Payload;
+        const quint16 startBit = uidDescription.startBit();
+        extractor.kind = dataFromPayload ? Extractor::Kind::PayloadBits
+                                         : Extractor::Kind::FrameIdBits;
+        extractor.firstByte = dataFromPayload ? startBit / 8 : 0;
+        extractor.shift = dataFromPayload ? startBit % 8 : startBit;
+        extractor.mask = uidDescription.bitLength() == uidBitLength
+                ? ~UnderlyingType(0)
+                : (UnderlyingType(1) << uidDescription.bitLength()) - 1;
+    } else {
+        // Keep the generic code for BE data, but create the description only once.
+        extractor.description.setDataSource(uidDescription.source());
+        extractor.description.setDataEndian(uidDescription.endian());
+        extractor.description.setStartBit(uidDescription.startBit());
+        extractor.description.setBitLength(uidDescription.bitLength());
+        extractor.description.setDataFormat(QtCanBus::DataFormat::UnsignedInteger);
+        // other fields are unused, so default-initialized
+    }
+    uidExtractor = extractor;
+}
+
 std::optional<QtCanBus::UniqueId>
-QCanFrameProcessorPrivate::extractUniqueId(const QCanBusFrame &frame) const
+QCanFrameProcessorPrivate::extractUniqueId(const FrameData &frameData) const
 {
-    const auto signalDataEnd = extractMaxBitNum(uidDescription.startBit(),
-                                                uidDescription.bitLength(),
-                                                uidDescription.endian());
+    using Extractor = UniqueIdExtractor;
+    using UnderlyingType = std::underlying_type_t<QtCanBus::UniqueId>;
+
+    const Extractor &extractor = uidExtractor;
     const bool dataFromPayload = uidDescription.source() == QtCanBus::DataSource::Payload;
 
     // For the FrameId case we do not really care if the frame id is extended
     // or not, because QCanBusFrame::FrameId is anyway 32-bit unsigned.
-    const auto maxDataLength = dataFromPayload ? frame.payload().size() * 8 : 29;
+    const auto maxDataLength = dataFromPayload ? frameData.payloadSize * 8 : 29;
 
-    if (signalDataEnd >= maxDataLength)
+    if (extractor.dataEnd >= maxDataLength)
         return {}; // add a more specific error description?
 
-    const QByteArray payload = frame.payload();
-    const auto frameId = frame.frameId();
-    const unsigned char *data = dataFromPayload
-            ? reinterpret_cast<const unsigned char *>(payload.data())
-            : reinterpret_cast<const unsigned char *>(&frameId);
-
-    // Now we need to do the same as when extracting a value for a signal, but
-    // without additional value conversions. We have an extractValue() template
-    // function, but it takes a QCanSignalDescription as an input parameter.
-    // To reuse the code, we generate a dummy QCanSignalDescription based on the
-    // values of uidDescription and call extractValue().
-    // This approach introduces some unneeded checks and also result conversions
-    // to/from QVariant. If this becomes a problem, we can copy-paste the code
-    // from extractValue() and remove the unneeded parts.
+    switch (extractor.kind) {
+    case Extractor::Kind::FrameIdBits: {
+        // The generic code interprets the in-memory bytes of the frame id as
+        // LE data, so do the same to get identical results on BE hosts.
+        const quint32 frameId = qFromLittleEndian(frameData.frameId);
+        return QtCanBus::UniqueId{UnderlyingType((frameId >> extractor.shift) & extractor.mask)};
+    }
+    case Extractor::Kind::PayloadBits: {
+        // The unique id is at most 32 bits long and starts within the first
+        // byte, so it spans at most 5 bytes. The size check above guarantees
+        // that all of them are available.
+        const unsigned char *data = frameData.payload.constData();
+        const qsizetype lastByte = extractor.dataEnd / 8;
+        quint64 bits = 0;
+        for (qsizetype i = extractor.firstByte; i <= lastByte; ++i)
+            bits |= quint64(data[i]) << ((i - extractor.firstByte) * 8);
+        return QtCanBus::UniqueId{UnderlyingType((bits >> extractor.shift) & extractor.mask)};
+    }
+    case Extractor::Kind::Generic:
+        break;
+    }
 
-    QCanSignalDescription dummyDesc;
-    dummyDesc.setDataSource(uidDescription.source());
-    dummyDesc.setDataEndian(uidDescription.endian());
-    dummyDesc.setStartBit(uidDescription.startBit());
-    dummyDesc.setBitLength(uidDescription.bitLength());
-    dummyDesc.setDataFormat(QtCanBus::DataFormat::UnsignedInteger);
-    // other fields are unused, so default-initialized
+    const unsigned char *data = dataFromPayload ? frameData.payload.constData()
+                                                : frameData.frameIdData;
 
-    using UnderlyingType = std::underlying_type_t<QtCanBus::UniqueId>;
-    const QVariant val = extractValue<UnderlyingType>(data, dummyDesc);
+    // Do the same as when extracting a value for a signal, but without
+    // additional value conversions.
+    const QVariant val = extractValue<UnderlyingType>(data, extractor.description);
     return QtCanBus::UniqueId{val.value<UnderlyingType>()};
 }
 
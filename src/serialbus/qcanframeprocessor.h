@@ -4,11 +4,14 @@
 #ifndef QCANFRAMEPROCESSOR_H
 #define QCANFRAMEPROCESSOR_H
 
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QVariantMap>
 
 #include <QtSerialBus/qcancommondefinitions.h>
 #include <QtSerialBus/qtserialbusglobal.h>
 
+#include <functional>
 #include <memory>
 
 QT_BEGIN_NAMESPACE
@@ -17,6 +20,7 @@ class QCanBusFrame;
 class QCanMessageDescription;
 class QCanUniqueIdDescription;
 class QCanFrameProcessorPrivate;
+class QCanFrameBuilderPrivate;
 
 class QCanFrameProcessor
 {
@@ -34,12 +38,58 @@ public:
         QVariantMap signalValues;
     };
 
+    using MessageDescriptionProvider = std::function<QCanMessageDescription(QtCanBus::UniqueId)>;
+
+    using ValueDescriptions = QHash<quint32, QString>;
+    using SignalValueDescriptions = QHash<QString, ValueDescriptions>;
+    using MessageValueDescriptions = QHash<QtCanBus::UniqueId, SignalValueDescriptions>;
+    using ValueTextHandle = qint32;
+
+    struct DecodedSignal {
+        QString name;
+        QVariant value;
+        ValueTextHandle valueText = -1;
+    };
+
+    struct DecodeResult {
+        QtCanBus::UniqueId uniqueId = QtCanBus::UniqueId{0};
+        QList<DecodedSignal> signalValues;
+    };
+
+    class FrameBuilder
+    {
+    public:
+        using SignalHandle = qsizetype;
+
+        Q_SERIALBUS_EXPORT FrameBuilder();
+        Q_SERIALBUS_EXPORT FrameBuilder(FrameBuilder &&other) noexcept;
+        Q_SERIALBUS_EXPORT FrameBuilder &operator=(FrameBuilder &&other) noexcept;
+        Q_SERIALBUS_EXPORT ~FrameBuilder();
+
+        Q_SERIALBUS_EXPORT bool isValid() const;
+        Q_SERIALBUS_EXPORT QtCanBus::UniqueId uniqueId() const;
+
+        Q_SERIALBUS_EXPORT SignalHandle signalHandle(const QString &name) const;
+        Q_SERIALBUS_EXPORT bool setSignalValue(SignalHandle handle, const QVariant &value);
+        Q_SERIALBUS_EXPORT QVariant signalValue(SignalHandle handle) const;
+
+        Q_SERIALBUS_EXPORT QCanBusFrame frame() const;
+
+    private:
+        std::unique_ptr<QCanFrameBuilderPrivate> d;
+        friend class QCanFrameProcessor;
+
+        Q_DISABLE_COPY(FrameBuilder)
+    };
+
     Q_SERIALBUS_EXPORT QCanFrameProcessor();
     Q_SERIALBUS_EXPORT ~QCanFrameProcessor();
 
     Q_SERIALBUS_EXPORT QCanBusFrame prepareFrame(QtCanBus::UniqueId uniqueId,
                                                  const QVariantMap &signalValues);
     Q_SERIALBUS_EXPORT ParseResult parseFrame(const QCanBusFrame &frame);
+    Q_SERIALBUS_EXPORT DecodeResult decodeFrame(const QCanBusFrame &frame);
+    Q_SERIALBUS_EXPORT FrameBuilder createFrameBuilder(QtCanBus::UniqueId uniqueId);
 
     Q_SERIALBUS_EXPORT Error error() const;
     Q_SERIALBUS_EXPORT QString errorString() const;
@@ -52,6 +102,14 @@ public:
     void setMessageDescriptions(const QList<QCanMessageDescription> &descriptions);
     Q_SERIALBUS_EXPORT void clearMessageDescriptions();
 
+    Q_SERIALBUS_EXPORT MessageDescriptionProvider messageDescriptionProvider() const;
+    Q_SERIALBUS_EXPORT
+    void setMessageDescriptionProvider(const MessageDescriptionProvider &provider);
+
+    Q_SERIALBUS_EXPORT MessageValueDescriptions valueDescriptions() const;
+    Q_SERIALBUS_EXPORT void setValueDescriptions(const MessageValueDescriptions &descriptions);
+    Q_SERIALBUS_EXPORT QString valueText(ValueTextHandle handle) const;
+
     Q_SERIALBUS_EXPORT QCanUniqueIdDescription uniqueIdDescription() const;
     Q_SERIALBUS_EXPORT void setUniqueIdDescription(const QCanUniqueIdDescription &description);
 
@@ -16,13 +16,18 @@
 //
 
 #include "private/qtserialbusexports_p.h"
+#include "qcanbusframe.h"
 #include "qcanframeprocessor.h"
 #include "qcanmessagedescription.h"
+#include "qcansignaldescription.h"
 #include "qcanuniqueiddescription.h"
 
 #include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QSharedData>
+#include <QtCore/QVarLengthArray>
 
+#include <optional>
 #include <utility>
 
 QT_BEGIN_NAMESPACE
@@ -30,14 +35,43 @@ QT_BEGIN_NAMESPACE
 class QCanFrameProcessorPrivate
 {
 public:
+    // The data of a frame, copied once for all of its signals. The buffers
+    // are padded with zeros, so that the signal values can be extracted with
+    // 64-bit loads starting at any byte of the data.
+    struct FrameData
+    {
+        explicit FrameData(const QCanBusFrame &frame);
+
+        static constexpr qsizetype Padding = 8;
+        // CAN FD frames have up to 64 bytes of payload
+        QVarLengthArray<unsigned char, 64 + Padding> payload;
+        qsizetype payloadSize = 0;
+        // the in-memory representation of the frame id
+        unsigned char frameIdData[sizeof(QCanBusFrame::FrameId) + Padding] = {};
+        QCanBusFrame::FrameId frameId = 0;
+        bool extendedFrameFormat = false;
+    };
+
     void resetErrors();
     void setError(QCanFrameProcessor::Error err, const QString &desc);
     void addWarning(const QString &warning);
-    QVariant decodeSignal(const QCanBusFrame &frame, const QCanSignalDescription &signalDesc);
+    QVariant decodeSignal(const FrameData &frameData, const QCanSignalDescription &signalDesc);
     QVariant parseData(const unsigned char *data, const QCanSignalDescription &signalDesc);
-    void encodeSignal(unsigned char *data, const QVariant &value,
-                      const QCanSignalDescription &signalDesc);
-    std::optional<QtCanBus::UniqueId> extractUniqueId(const QCanBusFrame &frame) const;
+    static void encodeSignal(unsigned char *data, const QVariant &value,
+                             const QCanSignalDescription &signalDesc);
+    void updateMessageLookup();
+    const QCanMessageDescription *findMessage(QtCanBus::UniqueId uniqueId);
+    const QCanMessageDescription *requestMessage(QtCanBus::UniqueId uniqueId);
+    const QCanMessageDescription *findMessageForFrame(const QCanBusFrame &frame,
+                                                      const FrameData &frameData,
+                                                      QtCanBus::UniqueId *uniqueId);
+    template <typename Handler>
+    void decodeSignals(const FrameData &frameData, const QCanMessageDescription &message,
+                       QVariantMap *values, Handler handler);
+    void updateValueTables(const QCanMessageDescription &message);
+    QCanFrameProcessor::ValueTextHandle internValueText(const QString &text);
+    void updateUniqueIdExtractor();
+    std::optional<QtCanBus::UniqueId> extractUniqueId(const FrameData &frameData) const;
     bool fillUniqueId(unsigned char *data, quint16 sizeInBits, QtCanBus::UniqueId uniqueId);
 
     static QCanFrameProcessorPrivate *get(const QCanFrameProcessor &processor);
@@ -46,7 +80,90 @@ public:
     QString errorString;
     QStringList warnings;
     QHash<QtCanBus::UniqueId, QCanMessageDescription> messages;
+
+    // Direct-indexed view of messages, used if all unique ids fit into
+    // 11 bits, i.e. for standard frame ids. Empty otherwise. It holds shared
+    // copies, since inserting into the hash may move its values.
+    static constexpr quint32 DirectLookupSize = 2048;
+    QList<std::optional<QCanMessageDescription>> directMessageLookup;
+    QCanFrameProcessor::MessageDescriptionProvider messageProvider;
+    // unique ids for which the provider did not return a valid description
+    QSet<QtCanBus::UniqueId> unavailableMessages;
     QCanUniqueIdDescription uidDescription;
+
+    // Precomputed from uidDescription, so that extracting the unique id
+    // of a parsed frame does not need to inspect the description again.
+    struct UniqueIdExtractor
+    {
+        enum class Kind : quint8 {
+            // little endian: a single shift and mask of the raw bits
+            FrameIdBits,
+            PayloadBits,
+            // big endian: fall back to extractValue() with a cached description
+            Generic
+        };
+
+        Kind kind = Kind::Generic;
+        quint16 dataEnd = 0;
+        quint16 firstByte = 0;
+        quint8 shift = 0;
+        quint32 mask = 0;
+        QCanSignalDescription description;
+    };
+    UniqueIdExtractor uidExtractor;
+
+    // The value descriptions of one signal, compiled for the lookup of the
+    // decoded raw values.
+    struct ValueTable
+    {
+        // Small ranges of values are stored as a dense array, indexed by
+        // (value - first). Otherwise the (value, handle) pairs are sorted by
+        // value.
+        quint32 first = 0;
+        QList<QCanFrameProcessor::ValueTextHandle> dense;
+        QList<std::pair<quint32, QCanFrameProcessor::ValueTextHandle>> sparse;
+
+        QCanFrameProcessor::ValueTextHandle find(quint32 value) const;
+    };
+    static QCanFrameProcessor::ValueTextHandle
+    findValueText(const ValueTable &table, const QVariant &value,
+                  const QCanSignalDescription &signalDesc);
+
+    QCanFrameProcessor::MessageValueDescriptions valueDescriptions;
+    // The tables of each message, in the order of its signal descriptions.
+    // Only messages with value descriptions have an entry.
+    QHash<QtCanBus::UniqueId, QList<ValueTable>> valueTables;
+    // all value texts, indexed by their handles
+    QStringList valueTexts;
+    QHash<QString, QCanFrameProcessor::ValueTextHandle> valueTextHandles;
+};
+
+class QCanFrameBuilderPrivate
+{
+public:
+    struct SignalEntry
+    {
+        QCanSignalDescription description;
+        bool inPayload = true;
+        // handles of the multiplexor signals and the accepted value ranges
+        QList<std::pair<qsizetype, QCanSignalDescription::MultiplexValues>> multiplexors;
+        QVariant value;
+        // other signals depend on the value of this one
+        bool isMultiplexor = false;
+    };
+
+    bool multiplexorsMatch(const SignalEntry &entry) const;
+    void dropUnmatchedSignals();
+
+    QtCanBus::UniqueId uniqueId = QtCanBus::UniqueId{0};
+    // frame id and payload with the unique id and all set signals encoded
+    QCanBusFrame::FrameId frameId = 0;
+    QByteArray payload;
+    // frame id and payload with only the unique id encoded
+    QCanBusFrame::FrameId initialFrameId = 0;
+    QByteArray initialPayload;
+    QList<SignalEntry> entries;
+    QHash<QString, qsizetype> handles;
 };
 
 QT_END_NAMESPACE
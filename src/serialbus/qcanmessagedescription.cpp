@@ -4,10 +4,12 @@
 #include "qcanmessagedescription.h"
 #include "qcanmessagedescription_p.h"
 #include "qcansignaldescription.h"
+#include "private/qcansignaldescription_p.h"
 
-#include <QtCore/QHash>
 #include <QtCore/QSharedData>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -249,14 +251,14 @@ void QCanMessageDescription::setComment(const QString &text)
 
 /*!
     Returns the list of signal descriptions that belong to this message
-    description.
+    description. Since Qt 6.7, the list is sorted by the signal names.
 
     \sa signalDescriptionForName(), addSignalDescription(),
     setSignalDescriptions(), clearSignalDescriptions()
 */
 QList<QCanSignalDescription> QCanMessageDescription::signalDescriptions() const
 {
-    return QList<QCanSignalDescription>(d->messageSignals.cbegin(), d->messageSignals.cend());
+    return d->messageSignals;
 }
 
 /*!
@@ -270,7 +272,8 @@ QList<QCanSignalDescription> QCanMessageDescription::signalDescriptions() const
 */
 QCanSignalDescription QCanMessageDescription::signalDescriptionForName(const QString &name) const
 {
-    return d->messageSignals.value(name);
+    const QCanSignalDescription *description = d->signalForName(name);
+    return description ? *description : QCanSignalDescription();
 }
 
 /*!
@@ -297,7 +300,7 @@ void QCanMessageDescription::clearSignalDescriptions()
 void QCanMessageDescription::addSignalDescription(const QCanSignalDescription &description)
 {
     d.detach();
-    d->messageSignals.insert(description.name(), description);
+    d->insertSignal(description);
 }
 
 /*!
@@ -317,7 +320,7 @@ void QCanMessageDescription::setSignalDescriptions(const QList<QCanSignalDescrip
     d->messageSignals.clear();
     d->messageSignals.reserve(descriptions.size());
     for (const auto &desc : descriptions)
-        d->messageSignals.insert(desc.name(), desc);
+        d->insertSignal(desc);
 }
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -347,6 +350,31 @@ QDebug QCanMessageDescription::debugStreaming(QDebug dbg, const QCanMessageDescr
 }
 #endif // QT_NO_DEBUG_STREAM
 
+static bool signalNameLess(const QCanSignalDescription &description, QStringView name)
+{
+    return QStringView(QCanSignalDescriptionPrivate::get(description)->name) < name;
+}
+
+const QCanSignalDescription *QCanMessageDescriptionPrivate::signalForName(QStringView name) const
+{
+    const auto it = std::lower_bound(messageSignals.cbegin(), messageSignals.cend(), name,
+                                     signalNameLess);
+    if (it == messageSignals.cend() || QCanSignalDescriptionPrivate::get(*it)->name != name)
+        return nullptr;
+    return &*it;
+}
+
+void QCanMessageDescriptionPrivate::insertSignal(const QCanSignalDescription &description)
+{
+    const QString &name = QCanSignalDescriptionPrivate::get(description)->name;
+    const auto it = std::lower_bound(messageSignals.begin(), messageSignals.end(), name,
+                                     signalNameLess);
+    if (it != messageSignals.end() && QCanSignalDescriptionPrivate::get(*it)->name == name)
+        *it = description;
+    else
+        messageSignals.insert(it, description);
+}
+
 QCanMessageDescriptionPrivate *QCanMessageDescriptionPrivate::get(const QCanMessageDescription &desc)
 {
     return desc.d.data();
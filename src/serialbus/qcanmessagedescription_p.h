@@ -17,6 +17,9 @@
 
 #include "private/qtserialbusexports_p.h"
 #include "qcanmessagedescription.h"
+#include "qcansignaldescription.h"
+
+#include <QtCore/QList>
 
 QT_BEGIN_NAMESPACE
 
@@ -28,7 +31,13 @@ public:
     QString comment;
     QtCanBus::UniqueId id{0};
     quint8 size = 0; // even CAN FD has max 64 bytes
-    QHash<QString, QCanSignalDescription> messageSignals;
+    // Sorted by name. Messages have only a few signals, so a flat array is
+    // smaller and faster to iterate than a hash, and still allows a binary
+    // search by name.
+    QList<QCanSignalDescription> messageSignals;
+
+    const QCanSignalDescription *signalForName(QStringView name) const;
+    void insertSignal(const QCanSignalDescription &description);
 
     inline bool isShared() const { return ref.loadRelaxed() != 1; }
     static QCanMessageDescriptionPrivate *get(const QCanMessageDescription &desc);
@@ -27,15 +27,21 @@ QT_BEGIN_NAMESPACE
 class Q_SERIALBUS_PRIVATE_EXPORT QCanSignalDescriptionPrivate : public QSharedData
 {
 public:
-    QString name;
-    QString unit;
-    QString receiver;
-    QString comment;
+    // The members are ordered to avoid padding. The small members fill the
+    // gap after the reference count of QSharedData.
     QtCanBus::DataSource source = QtCanBus::DataSource::Payload;
-    QSysInfo::Endian endian = QSysInfo::Endian::BigEndian;
     QtCanBus::DataFormat format = QtCanBus::DataFormat::SignedInteger;
+    // multiplexing state
+    QtCanBus::MultiplexState muxState = QtCanBus::MultiplexState::None;
     quint16 startBit = 0;
     quint16 dataLength = 0;
+    QSysInfo::Endian endian = QSysInfo::Endian::BigEndian;
+    // The strings of descriptions that are created by QCanDbcFileParser
+    // share their data, if they are equal.
+    QString name;
+    QString unit;
+    QString receiver;
+    QString comment;
     // for conversion, possibly unused
     double factor = qQNaN();
     double offset = qQNaN();
@@ -43,8 +49,6 @@ public:
     // expected range, possibly unused
     double minimum = qQNaN();
     double maximum = qQNaN();
-    // multiplexing state
-    QtCanBus::MultiplexState muxState = QtCanBus::MultiplexState::None;
     // Multiplexed values. The key of the hash represents the multiplex switch
     // name, and the value represents the valid range(s) of the mux switch
     // values.
@@ -7,6 +7,8 @@
 #include <QtSerialBus/qmodbuspdu.h>
 #include <QtCore/private/qglobal_p.h>
 
+#include <array>
+
 //
 //  W A R N I N G
 //  -------------
@@ -28,46 +30,72 @@ public:
         Rtu
     };
 
-    inline QModbusSerialAdu(Type type, const QByteArray &data)
-        : m_type(type), m_data(data), m_rawData(data)
+    // A PDU has at most 253 bytes, plus the server address and the CRC.
+    // The decoded data is stored inline, so no allocation is needed to
+    // inspect a received ADU. Longer input is truncated, but rawSize()
+    // still reports the full size.
+    static constexpr qsizetype MaxSize = 256;
+
+    inline QModbusSerialAdu(Type type, QByteArrayView data)
+        : m_type(type), m_rawSize(data.size())
     {
-        if (m_type == Ascii)
-            m_data = QByteArray::fromHex(m_data.mid(1, m_data.size() - 3));
+        QByteArray decoded;
+        if (m_type == Ascii) {
+            m_rawData = data.toByteArray();
+            decoded = QByteArray::fromHex(m_rawData.mid(1, m_rawData.size() - 3));
+            data = decoded;
+        }
+        m_size = qMin(data.size(), MaxSize);
+        if (m_size > 0)
+            memcpy(m_data, data.constData(), m_size);
     }
 
     inline int size() const {
         if (m_type == Ascii)
-            return m_data.size() - 1; // one byte, LRC
-        return m_data.size() - 2; // two bytes, CRC
+            return int(m_size) - 1; // one byte, LRC
+        return int(m_size) - 2; // two bytes, CRC
     }
-    inline QByteArray data() const { return m_data.left(size()); }
+    inline QByteArray data() const { return QByteArray(m_data, qMax(size(), 0)); }
+    inline QByteArrayView dataView() const { return QByteArrayView(m_data, qMax(size(), 0)); }
 
-    inline int rawSize() const { return m_rawData.size(); }
-    inline QByteArray rawData() const { return m_rawData; }
+    inline int rawSize() const { return int(m_rawSize); }
+    inline QByteArray rawData() const {
+        if (m_type == Ascii)
+            return m_rawData;
+        return QByteArray(m_data, m_size);
+    }
 
     inline int serverAddress() const {
-        Q_ASSERT_X(!m_data.isEmpty(), "QModbusAdu::serverAddress()", "Empty ADU.");
-        return quint8(m_data.at(0));
+        Q_ASSERT_X(m_size > 0, "QModbusAdu::serverAddress()", "Empty ADU.");
+        return quint8(m_data[0]);
     }
 
+    // Returns a copy of the PDU, which can be passed to the public API.
     inline QModbusPdu pdu() const {
-        Q_ASSERT_X(!m_data.isEmpty(), "QModbusAdu::pdu()", "Empty ADU.");
-        return QModbusPdu(QModbusPdu::FunctionCode(m_data.at(1)), m_data.mid(2, size() - 2));
+        Q_ASSERT_X(m_size > 0, "QModbusAdu::pdu()", "Empty ADU.");
+        return QModbusPdu(functionCode(), QByteArray(m_data + 2, pduDataSize()));
+    }
+
+    // Returns the PDU without copying its data. The returned PDU refers to
+    // the storage of this ADU, so it must not outlive it.
+    inline QModbusPdu pduView() const {
+        Q_ASSERT_X(m_size > 0, "QModbusAdu::pduView()", "Empty ADU.");
+        return QModbusPdu(functionCode(), QByteArray::fromRawData(m_data + 2, pduDataSize()));
     }
 
     template <typename T>
     auto checksum() const -> decltype(T()) {
-        Q_ASSERT_X(!m_data.isEmpty(), "QModbusAdu::checksum()", "Empty ADU.");
+        Q_ASSERT_X(m_size > 0, "QModbusAdu::checksum()", "Empty ADU.");
         if (m_type == Ascii)
-            return quint8(m_data[m_data.size() - 1]);
-        return quint16(quint8(m_data[m_data.size() - 2]) << 8 | quint8(m_data[m_data.size() - 1]));
+            return quint8(m_data[m_size - 1]);
+        return quint16(quint8(m_data[m_size - 2]) << 8 | quint8(m_data[m_size - 1]));
     }
 
     inline bool matchingChecksum() const {
-        Q_ASSERT_X(!m_data.isEmpty(), "QModbusAdu::matchingChecksum()", "Empty ADU.");
+        Q_ASSERT_X(m_size > 0, "QModbusAdu::matchingChecksum()", "Empty ADU.");
         if (m_type == Ascii)
-            return QModbusSerialAdu::calculateLRC(data(), size()) == checksum<quint8>();
-        return QModbusSerialAdu::calculateCRC(data(), size()) == checksum<quint16>();
+            return QModbusSerialAdu::calculateLRC(m_data, size()) == checksum<quint8>();
+        return QModbusSerialAdu::calculateCRC(m_data, size()) == checksum<quint16>();
     }
 
     /*!
@@ -118,22 +146,86 @@ public:
         return (crc >> 8) | (crc << 8); // swap bytes
     }
 
+    static constexpr quint16 CrcInitialValue = 0xFFFF;
+
+    /*!
+        \internal
+        \fn quint16 QModbusSerialAdu::updateCRC(quint16 crc, const char *data, qsizetype len)
+
+        Continues the running checksum \a crc, which starts at CrcInitialValue, with the first
+        \a len bytes of \a data. Unlike calculateCRC(), the result is not byte swapped: it is
+        zero once a complete RTU ADU, including its checksum, has been processed. This allows to
+        validate an ADU while its bytes arrive.
+    */
+    inline static quint16 updateCRC(quint16 crc, const char *data, qsizetype len)
+    {
+        while (len--)
+            crc = (crc >> 8) ^ CrcTable[(crc ^ quint8(*data++)) & 0xff];
+        return crc;
+    }
+
+    /*!
+        \internal
+        \fn qsizetype QModbusSerialAdu::create(char *buffer, int serverAddress, const QModbusPdu &pdu)
+
+        Writes the RTU ADU for \a serverAddress and \a pdu to \a buffer, which must have space
+        for MaxSize bytes. Returns the size of the ADU, or \c -1 if the PDU is too large.
+    */
+    inline static qsizetype create(char *buffer, int serverAddress, const QModbusPdu &pdu)
+    {
+        const qsizetype size = 1 + pdu.size() + 2;
+        if (size > MaxSize)
+            return -1;
+        writePdu(buffer, serverAddress, pdu);
+        qToBigEndian(calculateCRC(buffer, size - 2), buffer + size - 2);
+        return size;
+    }
+
     inline static QByteArray create(Type type, int serverAddress, const QModbusPdu &pdu,
                                     char delimiter = '\n') {
-        QByteArray result;
-        QDataStream out(&result, QIODevice::WriteOnly);
-        out << quint8(serverAddress) << pdu;
-
         if (type == Ascii) {
-            out << calculateLRC(result, result.size());
+            QByteArray result(1 + pdu.size() + 1, Qt::Uninitialized);
+            writePdu(result.data(), serverAddress, pdu);
+            result[result.size() - 1] = char(calculateLRC(result.constData(), result.size() - 1));
             return ":" + result.toHex() + "\r" + delimiter;
-        } else {
-            out << calculateCRC(result, result.size());
         }
+
+        QByteArray result(1 + pdu.size() + 2, Qt::Uninitialized);
+        writePdu(result.data(), serverAddress, pdu);
+        qToBigEndian(calculateCRC(result.constData(), result.size() - 2),
+                     result.data() + result.size() - 2);
         return result;
     }
 
 private:
+    inline int pduDataSize() const { return qMax(size() - 2, 0); }
+    inline QModbusPdu::FunctionCode functionCode() const {
+        return m_size > 1 ? QModbusPdu::FunctionCode(m_data[1]) : QModbusPdu::Invalid;
+    }
+
+    // Writes the server address, the function code and the data of the PDU,
+    // like the QDataStream operators do.
+    inline static void writePdu(char *out, int serverAddress, const QModbusPdu &pdu)
+    {
+        out[0] = char(quint8(serverAddress));
+        out[1] = char(quint8(pdu.m_code));
+        if (!pdu.m_data.isEmpty())
+            memcpy(out + 2, pdu.m_data.constData(), pdu.m_data.size());
+    }
+
+private:
+    // the reflected polynomial 0x8005, one entry per byte value
+    static constexpr std::array<quint16, 256> CrcTable = [] {
+        std::array<quint16, 256> table = {};
+        for (quint16 i = 0; i < 256; ++i) {
+            quint16 crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? quint16((crc >> 1) ^ 0xA001) : quint16(crc >> 1);
+            table[i] = crc;
+        }
+        return table;
+    }();
+
     inline static quint16 crc_reflect(quint16 data, qint32 len)
     {
         // Generated by pycrc v0.8.3, https://pycrc.org
@@ -150,7 +242,10 @@ private:
 
 private:
     Type m_type = Rtu;
-    QByteArray m_data;
+    qsizetype m_size = 0;
+    qsizetype m_rawSize = 0;
+    char m_data[MaxSize];
+    // only used for ASCII ADUs, the raw data of RTU ADUs is m_data
     QByteArray m_rawData;
 };
 
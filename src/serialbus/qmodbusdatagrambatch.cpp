@@ -0,0 +1,192 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusdatagrambatch_p.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtNetwork/qnetworkdatagram.h>
+#include <QtNetwork/qnetworkinterface.h>
+#include <QtNetwork/qudpsocket.h>
+
+#if defined(Q_OS_LINUX)
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+
+#if defined(Q_OS_LINUX)
+namespace {
+
+quint16 portOf(const sockaddr_storage &address)
+{
+    if (address.ss_family == AF_INET)
+        return ntohs(reinterpret_cast<const sockaddr_in *>(&address)->sin_port);
+    if (address.ss_family == AF_INET6)
+        return ntohs(reinterpret_cast<const sockaddr_in6 *>(&address)->sin6_port);
+    return 0;
+}
+
+/*
+    Converts the address to the family of the socket. A socket bound to
+    QHostAddress::Any is an IPv6 socket, which reaches IPv4 hosts by their
+    IPv4-mapped address.
+*/
+socklen_t toSockAddr(const QHostAddress &address, quint16 port, bool ipv6Socket,
+                     sockaddr_storage *result)
+{
+    memset(result, 0, sizeof(sockaddr_storage));
+    if (!ipv6Socket) {
+        auto ipv4 = reinterpret_cast<sockaddr_in *>(result);
+        ipv4->sin_family = AF_INET;
+        ipv4->sin_port = htons(port);
+        ipv4->sin_addr.s_addr = htonl(address.toIPv4Address());
+        return sizeof(sockaddr_in);
+    }
+
+    auto ipv6 = reinterpret_cast<sockaddr_in6 *>(result);
+    ipv6->sin6_family = AF_INET6;
+    ipv6->sin6_port = htons(port);
+    if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+        const quint32 ipv4 = htonl(address.toIPv4Address());
+        ipv6->sin6_addr.s6_addr[10] = 0xff;
+        ipv6->sin6_addr.s6_addr[11] = 0xff;
+        memcpy(ipv6->sin6_addr.s6_addr + 12, &ipv4, sizeof(ipv4));
+    } else {
+        const Q_IPV6ADDR bytes = address.toIPv6Address();
+        memcpy(ipv6->sin6_addr.s6_addr, bytes.c, sizeof(bytes.c));
+        if (!address.scopeId().isEmpty())
+            ipv6->sin6_scope_id = QNetworkInterface::interfaceIndexFromName(address.scopeId());
+    }
+    return sizeof(sockaddr_in6);
+}
+
+} // namespace
+#endif
+
+void QModbusDatagramBatch::receive(QList<Datagram> *datagrams)
+{
+    datagrams->clear();
+
+#if defined(Q_OS_LINUX)
+    // The first datagram is read by the socket, which enables its read
+    // notifications again. The rest are read in batches.
+    if (!m_socket->hasPendingDatagrams())
+        return;
+    const QNetworkDatagram first = m_socket->receiveDatagram(MaxDatagramSize);
+    if (!first.isValid())
+        return;
+    datagrams->append({ first.data(), first.senderAddress(), quint16(first.senderPort()) });
+
+    const int fd = int(m_socket->socketDescriptor());
+    if (m_receiveBuffer.isEmpty())
+        m_receiveBuffer.resize(BatchSize * MaxDatagramSize);
+
+    mmsghdr headers[BatchSize];
+    iovec vectors[BatchSize];
+    sockaddr_storage addresses[BatchSize];
+    while (datagrams->size() < MaxReceiveCount) {
+        const int count = int(qMin<qsizetype>(BatchSize, MaxReceiveCount - datagrams->size()));
+        memset(headers, 0, sizeof(mmsghdr) * count);
+        for (int i = 0; i < count; ++i) {
+            vectors[i].iov_base = m_receiveBuffer.data() + i * MaxDatagramSize;
+            vectors[i].iov_len = MaxDatagramSize;
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            headers[i].msg_hdr.msg_name = &addresses[i];
+            headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+
+        int received;
+        do {
+            received = ::recvmmsg(fd, headers, count, MSG_DONTWAIT, nullptr);
+        } while (received < 0 && errno == EINTR);
+        if (received <= 0)
+            return; // EAGAIN, no more datagrams; other errors are left to the socket
+
+        for (int i = 0; i < received; ++i) {
+            if (headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                qCWarning(QT_MODBUS) << "(UDP) Discarding datagram larger than"
+                                     << MaxDatagramSize << "bytes";
+                continue;
+            }
+            const auto address = reinterpret_cast<const sockaddr *>(&addresses[i]);
+            datagrams->append({ QByteArray(m_receiveBuffer.constData() + i * MaxDatagramSize,
+                                           headers[i].msg_len),
+                                QHostAddress(address), portOf(addresses[i]) });
+        }
+        if (received < count)
+            return;
+    }
+#else
+    while (datagrams->size() < MaxReceiveCount && m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram(MaxDatagramSize);
+        if (!datagram.isValid())
+            return;
+        datagrams->append({ datagram.data(), datagram.senderAddress(),
+                            quint16(datagram.senderPort()) });
+    }
+#endif
+}
+
+qsizetype QModbusDatagramBatch::send(const QList<Datagram> &datagrams)
+{
+    qsizetype sent = 0;
+
+#if defined(Q_OS_LINUX)
+    const int fd = int(m_socket->socketDescriptor());
+    if (fd < 0)
+        return 0;
+    const bool ipv6Socket = m_socket->localAddress().protocol() != QAbstractSocket::IPv4Protocol;
+
+    mmsghdr headers[BatchSize];
+    iovec vectors[BatchSize];
+    sockaddr_storage addresses[BatchSize];
+    while (sent < datagrams.size()) {
+        const int count = int(qMin<qsizetype>(BatchSize, datagrams.size() - sent));
+        memset(headers, 0, sizeof(mmsghdr) * count);
+        for (int i = 0; i < count; ++i) {
+            const Datagram &datagram = datagrams.at(sent + i);
+            vectors[i].iov_base = const_cast<char *>(datagram.data.constData());
+            vectors[i].iov_len = size_t(datagram.data.size());
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            if (!datagram.address.isNull()) {
+                headers[i].msg_hdr.msg_name = &addresses[i];
+                headers[i].msg_hdr.msg_namelen = toSockAddr(datagram.address, datagram.port,
+                                                            ipv6Socket, &addresses[i]);
+            }
+        }
+
+        int result;
+        do {
+            result = ::sendmmsg(fd, headers, count, 0);
+        } while (result < 0 && errno == EINTR);
+        if (result <= 0) {
+            qCWarning(QT_MODBUS) << "(UDP) Cannot send datagrams:" << qt_error_string(errno);
+            break;
+        }
+        sent += result;
+    }
+#else
+    for (const Datagram &datagram : datagrams) {
+        const qint64 written = datagram.address.isNull()
+            ? m_socket->write(datagram.data)
+            : m_socket->writeDatagram(datagram.data, datagram.address, datagram.port);
+        if (written != datagram.data.size()) {
+            qCWarning(QT_MODBUS) << "(UDP) Cannot send datagram:" << m_socket->errorString();
+            break;
+        }
+        ++sent;
+    }
+#endif
+
+    return sent;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,69 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSDATAGRAMBATCH_P_H
+#define QMODBUSDATAGRAMBATCH_P_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtNetwork/qhostaddress.h>
+
+#include "private/qtserialbusexports_p.h"
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QUdpSocket;
+
+// Moves the datagrams of a QUdpSocket in batches. A Modbus datagram carries
+// a single short ADU, so under load the system calls, not the data, are the
+// cost. On Linux, recvmmsg() and sendmmsg() move up to BatchSize datagrams
+// per system call; elsewhere the datagrams are moved one by one by the socket.
+class Q_SERIALBUS_PRIVATE_EXPORT QModbusDatagramBatch
+{
+public:
+    struct Datagram
+    {
+        QByteArray data;
+        // The sender of a received datagram, or the receiver of a datagram
+        // to send. A null address sends to the peer of a connected socket.
+        QHostAddress address;
+        quint16 port = 0;
+    };
+
+    // large enough for the ADUs of all framings, the ASCII framing being the largest
+    static constexpr qsizetype MaxDatagramSize = 1024;
+    static constexpr int BatchSize = 64;
+    // The datagrams received by one call, so that a flood of datagrams does
+    // not starve the event loop. The socket notifies again about the rest.
+    static constexpr qsizetype MaxReceiveCount = 1024;
+
+    explicit QModbusDatagramBatch(QUdpSocket *socket) : m_socket(socket) {}
+
+    // Replaces the content of datagrams with the pending datagrams of the socket.
+    void receive(QList<Datagram> *datagrams);
+    // Sends the datagrams in order, and returns the number of datagrams sent.
+    qsizetype send(const QList<Datagram> &datagrams);
+
+private:
+    Q_DISABLE_COPY(QModbusDatagramBatch)
+
+    QUdpSocket *m_socket;
+#if defined(Q_OS_LINUX)
+    QByteArray m_receiveBuffer; // BatchSize datagrams, allocated on first use
+#endif
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSDATAGRAMBATCH_P_H
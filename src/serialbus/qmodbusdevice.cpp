@@ -62,6 +62,32 @@ QModbusDevice::~QModbusDevice()
     \value NetworkPortParameter      This parameter holds the network port. \c int
     \value NetworkAddressParameter   This parameter holds the host address for network
                                      communication. \c QString
+    \value FramingParameter          This parameter holds the framing of the Modbus
+                                     messages on the transport. The default depends
+                                     on the transport. This value was introduced in
+                                     Qt 6.7. \c QModbusDevice::Framing
+*/
+
+/*!
+    \enum QModbusDevice::Framing
+    \since 6.7
+
+    This enum describes how Modbus messages are framed on the transport. Each
+    framing can be used with each transport, e.g. RTU framing over TCP to talk
+    to a serial gateway. By default, network transports use \l MbapFraming and
+    serial ports use \l RtuFraming.
+
+    \value MbapFraming   The Modbus Application Protocol header precedes each
+                         message. Responses are matched with their requests by
+                         the transaction identifier.
+    \value RtuFraming    Each message is followed by a CRC. Without transaction
+                         identifiers, responses are matched with the requests in
+                         the order of the requests.
+    \value AsciiFraming  Each message is sent as hexadecimal characters, with a
+                         LRC, between a colon and a line feed. Responses are
+                         matched in the order of the requests.
+
+    \sa FramingParameter
 */
 
 /*!
@@ -102,6 +128,8 @@ QVariant QModbusDevice::connectionParameter(ConnectionParameter parameter) const
         return d->m_networkPort;
     case NetworkAddressParameter:
         return d->m_networkAddress;
+    case FramingParameter:
+        return d->framing();
     default:
         break;
     }
@@ -143,6 +171,9 @@ void QModbusDevice::setConnectionParameter(ConnectionParameter parameter, const
     case NetworkAddressParameter:
         d->m_networkAddress = value.toString();
         break;
+    case FramingParameter:
+        d->m_framing = Framing(value.toInt());
+        break;
     default:
         Q_ASSERT_X(false, "", "Connection parameter not supported.");
         break;
@@ -47,10 +47,19 @@ public:
         SerialStopBitsParameter,
 
         NetworkPortParameter,
-        NetworkAddressParameter
+        NetworkAddressParameter,
+
+        FramingParameter
     };
     Q_ENUM(ConnectionParameter)
 
+    enum Framing {
+        MbapFraming,
+        RtuFraming,
+        AsciiFraming
+    };
+    Q_ENUM(Framing)
+
     enum IntermediateError
     {
         ResponseCrcError,
@@ -91,6 +100,7 @@ Q_DECLARE_TYPEINFO(QModbusDevice::Error, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QModbusDevice::State, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QModbusDevice::ConnectionParameter, Q_PRIMITIVE_TYPE);
 Q_DECLARE_TYPEINFO(QModbusDevice::IntermediateError, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QModbusDevice::Framing, Q_PRIMITIVE_TYPE);
 
 QT_END_NAMESPACE
 
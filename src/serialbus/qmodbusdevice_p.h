@@ -12,6 +12,8 @@
 
 #include <private/qobject_p.h>
 
+#include <optional>
+
 //
 //  W A R N I N G
 //  -------------
@@ -62,13 +64,50 @@ public:
         }
         m_interFrameDelayMilliseconds = qMax(m_interFrameDelayMilliseconds, delayMilliSeconds);
     }
+    /*!
+        Returns the time in microseconds needed to transmit a single character
+        with the current serial port settings: one start bit, the data bits,
+        an optional parity bit and the stop bits.
+    */
+    qreal characterTime() const
+    {
+        qreal bits = 1 + m_dataBits + (m_parity == QSerialPort::NoParity ? 0 : 1);
+        switch (m_stopBits) {
+        case QSerialPort::OneAndHalfStop:
+            bits += 1.5;
+            break;
+        case QSerialPort::TwoStop:
+            bits += 2;
+            break;
+        default:
+            bits += 1;
+            break;
+        }
+        return bits * 1000000. / qreal(qMax(int(m_baudRate), 1));
+    }
+
+    /*!
+        Returns 3.5 character times in microseconds, rounded up. Unlike
+        calculateInterFrameDelay(), no minimum for high baud rates is applied.
+    */
+    int calculatePreciseInterFrameDelay() const
+    {
+        return qCeil(3.5 * characterTime());
+    }
+
     static constexpr int RecommendedDelay = 2; // A approximated value of 1.750 msec.
     int m_interFrameDelayMilliseconds = RecommendedDelay;
+    int m_interFrameDelayMicroseconds = -1; // as set by the user
 #endif
 
     int m_networkPort = 502;
     QString m_networkAddress = QStringLiteral("127.0.0.1");
 
+    // unset, unless the framing of the transport is overridden
+    std::optional<QModbusDevice::Framing> m_framing;
+    virtual QModbusDevice::Framing defaultFraming() const { return QModbusDevice::MbapFraming; }
+    QModbusDevice::Framing framing() const { return m_framing.value_or(defaultFraming()); }
+
     virtual QIODevice *device() const { return nullptr; }
 };
 
@@ -0,0 +1,339 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusframer_p.h"
+#include "qmodbusadu_p.h"
+#include "qmodbus_symbols_p.h"
+
+#include <QtCore/qendian.h>
+#include <QtCore/private/qtools_p.h>
+
+#include <array>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+char encodedFunctionCode(const QModbusPdu &pdu)
+{
+    const quint8 code = quint8(pdu.functionCode());
+    return char(pdu.isException() ? (code | QModbusPdu::ExceptionByte) : code);
+}
+
+/*
+    Returns the size of the PDU data following the function code, or -1 if it
+    cannot be calculated from the data available. The size of a Diagnostics
+    ReturnQueryData PDU is never known, as it has no byte count.
+*/
+int calculateDataSize(QModbusPdu::FunctionCode code, const QByteArray &data,
+                      QModbusFramer::Direction direction)
+{
+    if (code == QModbusPdu::Diagnostics) {
+        if (data.size() < 2)
+            return -1;
+        if (qFromBigEndian<quint16>(data.constData()) == Diagnostics::ReturnQueryData)
+            return -1;
+    }
+    if (direction == QModbusFramer::Requests)
+        return QModbusRequest::calculateDataSize(QModbusRequest(code, data));
+    return QModbusResponse::calculateDataSize(QModbusResponse(code, data));
+}
+
+/*
+    Returns true if the size of a PDU with the function code can be
+    calculated, given enough data.
+*/
+bool hasKnownDataSize(QModbusPdu::FunctionCode code, QModbusFramer::Direction direction)
+{
+    static const char zeros[252] = {};
+    const QByteArray data = QByteArray::fromRawData(zeros, sizeof(zeros));
+    return calculateDataSize(code, data, direction) >= 0;
+}
+
+/*
+    MBAP framing: the transaction and protocol identifiers, the length of the
+    following bytes and the unit identifier precede the PDU.
+*/
+class QModbusMbapFramer : public QModbusFramer
+{
+public:
+    static constexpr qsizetype HeaderSize = 7;
+    static constexpr quint16 MaxLength = 254; // unit identifier and PDU
+
+    explicit QModbusMbapFramer(Direction direction)
+        : QModbusFramer(QModbusDevice::MbapFraming, direction)
+    {}
+
+    void appendAdu(QByteArray *out, quint16 transactionId, int serverAddress,
+                   const QModbusPdu &pdu) const override
+    {
+        const QByteArray data = pdu.data();
+        const qsizetype offset = out->size();
+        out->resize(offset + HeaderSize + pdu.size());
+
+        char *adu = out->data() + offset;
+        qToBigEndian<quint16>(transactionId, adu);
+        qToBigEndian<quint16>(0, adu + 2);
+        qToBigEndian<quint16>(quint16(pdu.size() + 1), adu + 4);
+        adu[6] = char(quint8(serverAddress));
+        adu[7] = encodedFunctionCode(pdu);
+        if (!data.isEmpty())
+            memcpy(adu + 8, data.constData(), data.size());
+    }
+
+    Status parse(QByteArrayView buffer, Frame *frame) override
+    {
+        if (buffer.size() < HeaderSize)
+            return Incomplete;
+
+        const quint16 length = qFromBigEndian<quint16>(buffer.data() + 4);
+        if (length < 2 || length > MaxLength) {
+            // There is no way to find the next frame in the stream.
+            frame->size = buffer.size();
+            return Invalid;
+        }
+        const qsizetype size = HeaderSize - 1 + length;
+        if (buffer.size() < size)
+            return Incomplete;
+
+        frame->size = size;
+        frame->transactionId = qFromBigEndian<quint16>(buffer.data());
+        frame->serverAddress = quint8(buffer.at(6));
+        frame->functionCode = QModbusPdu::FunctionCode(quint8(buffer.at(7)));
+        frame->data = buffer.sliced(HeaderSize + 1, size - HeaderSize - 1);
+        frame->matchingChecksum = true;
+        return Complete;
+    }
+
+    void reset() override {}
+};
+
+/*
+    RTU framing: the server address precedes the PDU, and the CRC follows it.
+    Without the silent intervals of a serial line, the end of the frame is
+    calculated from the PDU. If that is not possible, e.g. for a custom
+    function code, the frame ends where the running CRC first matches.
+*/
+class QModbusRtuFramer : public QModbusFramer
+{
+public:
+    static constexpr qsizetype MinimumSize = 4; // address, function code, CRC
+
+    explicit QModbusRtuFramer(Direction direction)
+        : QModbusFramer(QModbusDevice::RtuFraming, direction)
+    {}
+
+    void appendAdu(QByteArray *out, quint16 transactionId, int serverAddress,
+                   const QModbusPdu &pdu) const override
+    {
+        Q_UNUSED(transactionId);
+        const QByteArray data = pdu.data();
+        const qsizetype offset = out->size();
+        const qsizetype size = 1 + pdu.size() + 2;
+        out->resize(offset + size);
+
+        char *adu = out->data() + offset;
+        adu[0] = char(quint8(serverAddress));
+        adu[1] = encodedFunctionCode(pdu);
+        if (!data.isEmpty())
+            memcpy(adu + 2, data.constData(), data.size());
+        const quint16 crc = QModbusSerialAdu::updateCRC(QModbusSerialAdu::CrcInitialValue, adu,
+                                                        size - 2);
+        qToLittleEndian<quint16>(crc, adu + size - 2);
+    }
+
+    Status parse(QByteArrayView buffer, Frame *frame) override
+    {
+        if (buffer.size() < 2)
+            return Incomplete;
+
+        // The size is calculated again while the frame is incomplete, since
+        // some PDUs reveal their full size only piece by piece.
+        const QModbusPdu::FunctionCode code = QModbusPdu::FunctionCode(quint8(buffer.at(1)));
+        const QByteArrayView pduData = buffer.sliced(2).first(
+                qMin(buffer.size() - 2, QModbusSerialAdu::MaxSize - MinimumSize));
+        const int dataSize = calculateDataSize(
+                code, QByteArray::fromRawData(pduData.data(), pduData.size()), direction());
+
+        qsizetype size = -1;
+        qsizetype end = qMin(buffer.size(), QModbusSerialAdu::MaxSize);
+        if (dataSize >= 0) {
+            size = 2 + dataSize + 2;
+            if (size > QModbusSerialAdu::MaxSize) {
+                frame->size = 1; // skip the address, and look for the next frame
+                return Invalid;
+            }
+            end = qMin(end, size);
+            if (m_checkedSize > size)
+                resetChecksum(); // the frame ended before its size was known
+        } else if (!m_searchCrc) {
+            // Known function codes need more data; others are searched for.
+            m_searchCrc = (code == QModbusPdu::Diagnostics)
+                || !hasKnownDataSize(code, direction());
+            if (!m_searchCrc)
+                return Incomplete;
+        }
+
+        while (m_checkedSize < end) {
+            m_crc = QModbusSerialAdu::updateCRC(m_crc, buffer.data() + m_checkedSize, 1);
+            ++m_checkedSize;
+            if (size < 0 && m_checkedSize >= MinimumSize && m_crc == 0) {
+                size = m_checkedSize;
+                break;
+            }
+        }
+
+        if (size < 0) {
+            if (m_checkedSize < QModbusSerialAdu::MaxSize)
+                return Incomplete;
+            reset();
+            frame->size = 1;
+            return Invalid;
+        }
+        if (m_checkedSize < size)
+            return Incomplete;
+
+        frame->size = size;
+        frame->transactionId = -1;
+        frame->serverAddress = quint8(buffer.at(0));
+        frame->functionCode = code;
+        frame->data = buffer.sliced(2, size - MinimumSize);
+        frame->matchingChecksum = (m_crc == 0);
+        reset();
+        return Complete;
+    }
+
+    void reset() override
+    {
+        resetChecksum();
+        m_searchCrc = false;
+    }
+
+private:
+    void resetChecksum()
+    {
+        m_checkedSize = 0;
+        m_crc = QModbusSerialAdu::CrcInitialValue;
+    }
+
+    qsizetype m_checkedSize = 0;
+    quint16 m_crc = QModbusSerialAdu::CrcInitialValue;
+    bool m_searchCrc = false;
+};
+
+/*
+    ASCII framing: the server address, the PDU and the LRC are encoded as
+    hexadecimal characters between a colon and a line feed.
+*/
+class QModbusAsciiFramer : public QModbusFramer
+{
+public:
+    // colon, two characters per byte, carriage return and line feed
+    static constexpr qsizetype MaxRawSize = 1 + 2 * QModbusSerialAdu::MaxSize + 2;
+
+    explicit QModbusAsciiFramer(Direction direction)
+        : QModbusFramer(QModbusDevice::AsciiFraming, direction)
+    {}
+
+    void appendAdu(QByteArray *out, quint16 transactionId, int serverAddress,
+                   const QModbusPdu &pdu) const override
+    {
+        Q_UNUSED(transactionId);
+        const QByteArray data = pdu.data();
+        const qsizetype offset = out->size();
+        const qsizetype size = 1 + pdu.size() + 1;
+        out->resize(offset + 1 + 2 * size + 2);
+
+        quint8 lrc = 0;
+        char *adu = out->data() + offset;
+        *adu++ = ':';
+        const auto appendByte = [&adu, &lrc](quint8 byte) {
+            *adu++ = QtMiscUtils::toHexUpper(byte >> 4);
+            *adu++ = QtMiscUtils::toHexUpper(byte & 0xf);
+            lrc += byte;
+        };
+        appendByte(quint8(serverAddress));
+        appendByte(quint8(encodedFunctionCode(pdu)));
+        for (const char c : data)
+            appendByte(quint8(c));
+        appendByte(quint8(-lrc));
+        *adu++ = '\r';
+        *adu++ = '\n';
+    }
+
+    Status parse(QByteArrayView buffer, Frame *frame) override
+    {
+        if (buffer.isEmpty())
+            return Incomplete;
+
+        // Skip everything in front of the start of a frame.
+        if (buffer.at(0) != ':') {
+            const qsizetype start = buffer.indexOf(':');
+            frame->size = (start < 0) ? buffer.size() : start;
+            reset();
+            return Invalid;
+        }
+
+        const qsizetype end = buffer.indexOf('\n', qMax(m_scannedSize, qsizetype(1)));
+        if (end < 0) {
+            m_scannedSize = buffer.size();
+            if (m_scannedSize < MaxRawSize)
+                return Incomplete;
+            frame->size = 1; // skip the colon, and look for the next frame
+            reset();
+            return Invalid;
+        }
+        reset();
+        frame->size = end + 1;
+
+        QByteArrayView hex = buffer.sliced(1, end - 1);
+        if (hex.endsWith('\r'))
+            hex.chop(1);
+        const qsizetype size = hex.size() / 2;
+        if (hex.size() % 2 != 0 || size < 3 || size > QModbusSerialAdu::MaxSize)
+            return Invalid;
+
+        quint8 lrc = 0;
+        for (qsizetype i = 0; i < size; ++i) {
+            const int high = QtMiscUtils::fromHex(uint(hex.at(2 * i)));
+            const int low = QtMiscUtils::fromHex(uint(hex.at(2 * i + 1)));
+            if (high < 0 || low < 0)
+                return Invalid;
+            m_decoded[i] = char(high << 4 | low);
+            lrc += quint8(m_decoded[i]);
+        }
+
+        frame->transactionId = -1;
+        frame->serverAddress = quint8(m_decoded[0]);
+        frame->functionCode = QModbusPdu::FunctionCode(quint8(m_decoded[1]));
+        frame->data = QByteArrayView(m_decoded.data() + 2, size - 3);
+        frame->matchingChecksum = (lrc == 0);
+        return Complete;
+    }
+
+    void reset() override { m_scannedSize = 0; }
+
+private:
+    qsizetype m_scannedSize = 0;
+    std::array<char, QModbusSerialAdu::MaxSize> m_decoded = {};
+};
+
+} // namespace
+
+std::unique_ptr<QModbusFramer> QModbusFramer::create(QModbusDevice::Framing framing,
+                                                     Direction direction)
+{
+    switch (framing) {
+    case QModbusDevice::MbapFraming:
+        return std::make_unique<QModbusMbapFramer>(direction);
+    case QModbusDevice::RtuFraming:
+        return std::make_unique<QModbusRtuFramer>(direction);
+    case QModbusDevice::AsciiFraming:
+        return std::make_unique<QModbusAsciiFramer>(direction);
+    }
+    return nullptr;
+}
+
+QModbusFramer::~QModbusFramer() = default;
+
+QT_END_NAMESPACE
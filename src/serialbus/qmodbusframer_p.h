@@ -0,0 +1,112 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSFRAMER_P_H
+#define QMODBUSFRAMER_P_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtSerialBus/qmodbusdevice.h>
+#include <QtSerialBus/qmodbuspdu.h>
+
+#include "private/qtserialbusexports_p.h"
+
+#include <memory>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+// Encodes Modbus ADUs in one of the framings of QModbusDevice::Framing, and
+// finds them in a stream of bytes. The framing does not depend on the
+// transport, so the same framer is used for TCP, UDP and serial ports.
+class Q_SERIALBUS_PRIVATE_EXPORT QModbusFramer
+{
+public:
+    // Selects the rules to calculate the size of a PDU.
+    enum Direction {
+        Requests,
+        Responses
+    };
+
+    enum Status {
+        Incomplete, // more data is needed
+        Complete,
+        Invalid     // the bytes cannot start a frame, and should be discarded
+    };
+
+    struct Frame
+    {
+        qsizetype size = 0; // raw bytes taken from the start of the buffer
+        int transactionId = -1; // only used by the MBAP framing
+        int serverAddress = -1;
+        QModbusPdu::FunctionCode functionCode = QModbusPdu::Invalid;
+        // The PDU data refers to the parsed buffer, or for ASCII frames to the
+        // framer. It is valid until either of them is changed.
+        QByteArrayView data;
+        bool matchingChecksum = true;
+
+        // Returns the QModbusRequest or QModbusResponse without copying its data.
+        template <typename Pdu>
+        Pdu pduView() const
+        {
+            return Pdu(functionCode, QByteArray::fromRawData(data.data(), data.size()));
+        }
+        // Returns a copy of the PDU, which can be passed to the public API.
+        template <typename Pdu>
+        Pdu pdu() const { return Pdu(functionCode, data.toByteArray()); }
+    };
+
+    static std::unique_ptr<QModbusFramer> create(QModbusDevice::Framing framing,
+                                                 Direction direction);
+    virtual ~QModbusFramer();
+
+    QModbusDevice::Framing framing() const { return m_framing; }
+    Direction direction() const { return m_direction; }
+    // Without transaction identifiers, responses are matched in request order.
+    bool hasTransactionId() const { return m_framing == QModbusDevice::MbapFraming; }
+
+    // Appends the ADU of pdu to out. The transaction id is ignored by
+    // framings without one.
+    virtual void appendAdu(QByteArray *out, quint16 transactionId, int serverAddress,
+                           const QModbusPdu &pdu) const = 0;
+    QByteArray createAdu(quint16 transactionId, int serverAddress, const QModbusPdu &pdu) const
+    {
+        QByteArray adu;
+        appendAdu(&adu, transactionId, serverAddress, pdu);
+        return adu;
+    }
+
+    // Parses the frame at the start of buffer. The state is kept between
+    // calls, so bytes that were parsed before are not parsed again when the
+    // buffer has grown. Once a frame is complete or invalid, the caller
+    // removes frame->size bytes from the buffer, and the next call parses the
+    // following frame. reset() must be called if the buffer is changed in
+    // any other way.
+    virtual Status parse(QByteArrayView buffer, Frame *frame) = 0;
+    virtual void reset() = 0;
+
+protected:
+    QModbusFramer(QModbusDevice::Framing framing, Direction direction)
+        : m_framing(framing), m_direction(direction)
+    {}
+
+private:
+    Q_DISABLE_COPY(QModbusFramer)
+
+    const QModbusDevice::Framing m_framing;
+    const Direction m_direction;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSFRAMER_P_H
@@ -0,0 +1,221 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSNETWORKCLIENT_P_H
+#define QMODBUSNETWORKCLIENT_P_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qloggingcategory.h>
+
+#include "private/qmodbusclient_p.h"
+#include "private/qmodbusframer_p.h"
+
+#include <memory>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
+
+// The open transactions of the network clients. Unlike the serial clients,
+// which send one request at a time, network clients send every request
+// immediately, and match the responses with their requests by the
+// transaction identifier. The transports write the requests, and pass the
+// received responses to matchResponse().
+class QModbusNetworkClientPrivate : public QModbusClientPrivate
+{
+    Q_DECLARE_PUBLIC(QModbusClient)
+
+public:
+    // Writes the ADU of request with the framing of the transport. Returns
+    // false, after setting the error of the client, if it cannot be written.
+    virtual bool writeRequest(quint16 tId, const QModbusRequest &request, int address) = 0;
+    // Called once the request written for tId is no longer waiting for its
+    // response, because it was answered, timed out, or is dropped. It may be
+    // called more than once for the same transaction.
+    virtual void releaseTransaction(quint16 tId) { Q_UNUSED(tId); }
+
+    // Finishes the transaction of a received response. The transaction
+    // identifier is -1 for framings without one, in which case the oldest
+    // open request is answered.
+    void matchResponse(int transactionId, int serverAddress, const QModbusResponse &responsePdu,
+                       bool matchingChecksum)
+    {
+        if (!m_framer->hasTransactionId())
+            transactionId = m_requestOrder.isEmpty() ? -1 : m_requestOrder.first();
+
+        qCDebug(QT_MODBUS) << "(Client) tid:" << Qt::hex << transactionId
+            << "server address:" << serverAddress;
+        qCDebug(QT_MODBUS) << "(Client) Received PDU:" << responsePdu.functionCode()
+                           << responsePdu.data().toHex();
+
+        const auto it = m_transactionStore.find(quint16(transactionId));
+        if (transactionId < 0 || it == m_transactionStore.end()) {
+            qCDebug(QT_MODBUS) << "(Client) No pending request for response with "
+                "given transaction ID, ignoring response message.";
+            return;
+        }
+        if (it->reply.isNull())
+            return;
+
+        if (!matchingChecksum) {
+            qCWarning(QT_MODBUS) << "(Client) Discarding response with wrong checksum";
+            it->reply->addIntermediateError(QModbusClient::ResponseCrcError);
+            return;
+        }
+        if (!m_framer->hasTransactionId() && (it->reply->serverAddress() != serverAddress
+                || it->requestPdu.functionCode() != responsePdu.functionCode())) {
+            qCWarning(QT_MODBUS) << "(Client) Cannot match response with open request, "
+                "ignoring";
+            it->reply->addIntermediateError(QModbusClient::ResponseRequestMismatch);
+            return;
+        }
+
+        if (it->timer)
+            it->timer->stop();
+        m_requestOrder.removeOne(quint16(transactionId));
+        releaseTransaction(quint16(transactionId));
+        processQueueElement(responsePdu, *it);
+    }
+
+    QModbusReply *enqueueRequest(const QModbusRequest &request, int serverAddress,
+                                 const QModbusDataUnit &unit,
+                                 QModbusReply::ReplyType type) override
+    {
+        const int tId = transactionId();
+        if (!m_framer->hasTransactionId() && serverAddress == 0)
+            return sendBroadcast(tId, request, unit);
+
+        if (!sendRequest(tId, request, serverAddress))
+            return nullptr;
+
+        Q_Q(QModbusClient);
+        auto reply = new QModbusReply(type, serverAddress, q);
+        const auto element = QueueElement{ reply, request, unit, m_numberOfRetries,
+            m_responseTimeoutDuration };
+        m_transactionStore.insert(tId, element);
+
+        q->connect(reply, &QObject::destroyed, q, [this, tId](QObject *) {
+            if (!m_transactionStore.contains(tId))
+                return;
+            const QueueElement element = m_transactionStore.take(tId);
+            m_requestOrder.removeOne(tId);
+            releaseTransaction(tId);
+            if (element.timer)
+                element.timer->stop();
+        });
+
+        if (element.timer) {
+            q->connect(q, &QModbusClient::timeoutChanged,
+                       element.timer.data(), QOverload<int>::of(&QTimer::setInterval));
+            QObject::connect(element.timer.data(), &QTimer::timeout, q, [this, tId]() {
+                if (!m_transactionStore.contains(tId))
+                    return;
+
+                QueueElement elem = m_transactionStore.take(tId);
+                m_requestOrder.removeOne(tId);
+                releaseTransaction(tId);
+                if (elem.reply.isNull())
+                    return;
+
+                if (elem.numberOfRetries > 0) {
+                    elem.numberOfRetries--;
+                    if (!sendRequest(tId, elem.requestPdu, elem.reply->serverAddress()))
+                        return;
+                    m_transactionStore.insert(tId, elem);
+                    elem.timer->start();
+                    qCDebug(QT_MODBUS) << "(Client) Resend request with tId:" << Qt::hex << tId;
+                } else {
+                    qCDebug(QT_MODBUS) << "(Client) Timeout of request with tId:" << Qt::hex << tId;
+                    elem.reply->setError(QModbusDevice::TimeoutError,
+                        QModbusClient::tr("Request timeout."));
+                }
+            });
+            element.timer->start();
+        } else {
+            qCWarning(QT_MODBUS) << "(Client) No response timeout timer for request with tId:"
+                << Qt::hex << tId << ". Expected timeout:" << m_responseTimeoutDuration;
+        }
+        incrementTransactionId();
+
+        return reply;
+    }
+
+    void cleanupTransactionStore()
+    {
+        if (m_transactionStore.isEmpty())
+            return;
+
+        qCDebug(QT_MODBUS) << "(Client) Cleanup of pending requests";
+
+        for (auto it = m_transactionStore.cbegin(); it != m_transactionStore.cend(); ++it) {
+            releaseTransaction(it.key());
+            const QueueElement &elem = it.value();
+            if (elem.reply.isNull())
+                continue;
+            elem.reply->setError(QModbusDevice::ReplyAbortedError,
+                                 QModbusClient::tr("Reply aborted due to connection closure."));
+        }
+        m_transactionStore.clear();
+        m_requestOrder.clear();
+    }
+
+    // This doesn't overflow, it rather "wraps around". Expected.
+    inline void incrementTransactionId() { m_transactionId++; }
+    inline int transactionId() const { return m_transactionId; }
+
+    QHash<quint16, QueueElement> m_transactionStore;
+    // the open requests in the order they were sent, for framings without
+    // transaction identifiers
+    QList<quint16> m_requestOrder;
+    std::unique_ptr<QModbusFramer> m_framer;
+
+private:
+    // Without transaction identifiers, a broadcast is matched by nothing, no
+    // server answers it. It is finished once written, like on a serial line,
+    // and does not take a place in the request order.
+    QModbusReply *sendBroadcast(quint16 tId, const QModbusRequest &request,
+                                const QModbusDataUnit &unit)
+    {
+        if (!writeRequest(tId, request, 0))
+            return nullptr;
+        releaseTransaction(tId);
+        incrementTransactionId();
+
+        Q_Q(QModbusClient);
+        auto reply = new QModbusReply(QModbusReply::Broadcast, 0, q);
+        const auto element = QueueElement{ reply, request, unit, 0 };
+        QMetaObject::invokeMethod(q, [this, element]() {
+            processQueueElement({}, element);
+        }, Qt::QueuedConnection);
+        return reply;
+    }
+
+    bool sendRequest(quint16 tId, const QModbusRequest &request, int address)
+    {
+        if (!writeRequest(tId, request, address))
+            return false;
+        if (!m_framer->hasTransactionId())
+            m_requestOrder.append(tId);
+        return true;
+    }
+
+    // Private to avoid using the wrong id inside the timer lambda,
+    quint16 m_transactionId = 0; // capturing 'this' will not copy the id.
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSNETWORKCLIENT_P_H
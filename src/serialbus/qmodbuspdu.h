@@ -4,6 +4,7 @@
 #define QMODBUSPDU_H
 
 #include <QtCore/qdatastream.h>
+#include <QtCore/qendian.h>
 #include <QtCore/qiodevice.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qmetatype.h>
@@ -112,41 +113,59 @@ private:
     template <typename T>
     using is_pod = std::integral_constant<bool, std::is_trivial<T>::value && std::is_standard_layout<T>::value>;
 
-    template <typename T> void encode(QDataStream *stream, const T &t) {
+    // The data is encoded in big-endian byte order, like QDataStream does by
+    // default, but written to and read from the buffer directly.
+    template <typename T> static constexpr qsizetype encodedSize(const T &) {
+        return qsizetype(sizeof(T));
+    }
+    template <typename T> static qsizetype encodedSize(const QList<T> &vector) {
+        return vector.size() * qsizetype(sizeof(T));
+    }
+
+    template <typename T> static char *encodeValue(char *out, const T &t) {
         static_assert(is_pod<T>::value, "Only POD types supported.");
         static_assert(IsType<T, quint8, quint16>::value, "Only quint8 and quint16 supported.");
-        (*stream) << t;
+        qToBigEndian(t, out);
+        return out + sizeof(T);
     }
-    template <typename T> void decode(QDataStream *stream, T &t) const {
+    template <typename T> static char *encodeValue(char *out, const QList<T> &vector) {
         static_assert(is_pod<T>::value, "Only POD types supported.");
-        static_assert(IsType<T, quint8 *, quint16 *>::value, "Only quint8* and quint16* supported.");
-        (*stream) >> *t;
+        static_assert(IsType<T, quint8, quint16>::value, "Only quint8 and quint16 supported.");
+        for (const T &t : vector)
+            out = encodeValue(out, t);
+        return out;
     }
-    template<typename T>
-    void encode(QDataStream *stream, const QList<T> &vector)
-    {
+
+    // Like QDataStream, sets the value to 0 and consumes the rest of the data
+    // if not enough data is left.
+    template <typename T> static const char *decodeValue(const char *in, const char *end, T t) {
         static_assert(is_pod<T>::value, "Only POD types supported.");
-        static_assert(IsType<T, quint8, quint16>::value, "Only quint8 and quint16 supported.");
-        for (int i = 0; i < vector.size(); ++i)
-            (*stream) << vector[i];
+        static_assert(IsType<T, quint8 *, quint16 *>::value, "Only quint8* and quint16* supported.");
+        using Value = std::remove_pointer_t<T>;
+        if (end - in < qsizetype(sizeof(Value))) {
+            *t = 0;
+            return end;
+        }
+        *t = qFromBigEndian<Value>(in);
+        return in + sizeof(Value);
     }
 
     template<typename ... Args> void encode(Args ... newData) {
         m_data.clear();
         constexpr size_t argCount = sizeof...(Args);
         if constexpr (argCount > 0) {
-            QDataStream stream(&m_data, QIODevice::WriteOnly);
-            char tmp[argCount] = { (encode(&stream, newData), void(), '0')... };
-            Q_UNUSED(tmp);
+            m_data.resize((qsizetype(0) + ... + encodedSize(newData)));
+            char *out = m_data.data();
+            ((out = encodeValue(out, newData)), ...);
         }
     }
     template<typename ... Args> void decode(Args ... newData) const {
         constexpr size_t argCount = sizeof...(Args);
         if constexpr (argCount > 0) {
             if (!m_data.isEmpty()) {
-                QDataStream stream(m_data);
-                char tmp[argCount] = { (decode(&stream, newData), void(), '0')... };
-                Q_UNUSED(tmp);
+                const char *in = m_data.constData();
+                const char *end = in + m_data.size();
+                ((in = decodeValue(in, end, newData)), ...);
             }
         }
     }
@@ -0,0 +1,93 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusprecisetimer_p.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qsocketnotifier.h>
+
+#if defined(Q_OS_LINUX)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+
+QModbusPreciseTimer::QModbusPreciseTimer()
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &QModbusPreciseTimer::timeout);
+}
+
+QModbusPreciseTimer::~QModbusPreciseTimer()
+{
+#if defined(Q_OS_LINUX)
+    if (m_fd >= 0) {
+        delete m_notifier; // must not outlive the descriptor
+        ::close(m_fd);
+    }
+#endif
+}
+
+#if defined(Q_OS_LINUX)
+// The timerfd is created on first use, so that timers which are never
+// started do not use a file descriptor.
+bool QModbusPreciseTimer::ensureTimerFd()
+{
+    if (m_fd >= 0)
+        return true;
+    if (m_fdFailed)
+        return false;
+
+    m_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_fd < 0) {
+        m_fdFailed = true;
+        qCWarning(QT_MODBUS) << "Cannot create timerfd, delays are rounded up to milliseconds";
+        return false;
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, [this]() {
+        quint64 expirations = 0;
+        if (::read(m_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+            emit timeout();
+    });
+    return true;
+}
+#endif
+
+void QModbusPreciseTimer::start(std::chrono::microseconds interval)
+{
+#if defined(Q_OS_LINUX)
+    if (ensureTimerFd()) {
+        // A zero value disarms a timerfd, so wait at least one nanosecond.
+        const auto ns = qMax(std::chrono::nanoseconds(interval), std::chrono::nanoseconds(1));
+        itimerspec spec = {};
+        spec.it_value.tv_sec = time_t(ns.count() / 1000000000);
+        spec.it_value.tv_nsec = long(ns.count() % 1000000000);
+        if (::timerfd_settime(m_fd, 0, &spec, nullptr) == 0)
+            return;
+    }
+#endif
+    m_timer.start(std::chrono::ceil<std::chrono::milliseconds>(interval));
+}
+
+void QModbusPreciseTimer::stop()
+{
+#if defined(Q_OS_LINUX)
+    if (m_fd >= 0) {
+        const itimerspec spec = {};
+        ::timerfd_settime(m_fd, 0, &spec, nullptr);
+        // discard an expiration the event loop has not delivered yet
+        quint64 expirations = 0;
+        [[maybe_unused]] const auto result = ::read(m_fd, &expirations, sizeof(expirations));
+    }
+#endif
+    m_timer.stop();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qmodbusprecisetimer_p.cpp"
@@ -0,0 +1,58 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSPRECISETIMER_P_H
+#define QMODBUSPRECISETIMER_P_H
+
+#include <QtCore/qobject.h>
+#include <QtCore/qtimer.h>
+#include <QtSerialBus/qtserialbusglobal.h>
+
+#include <chrono>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+// A single-shot timer with microsecond resolution, used for the silent
+// intervals of the Modbus RTU framing. On Linux it is backed by a timerfd,
+// elsewhere by a precise QTimer, which rounds up to milliseconds.
+class QModbusPreciseTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    QModbusPreciseTimer();
+    ~QModbusPreciseTimer() override;
+
+    void start(std::chrono::microseconds interval);
+    void stop();
+
+signals:
+    void timeout();
+
+private:
+#if defined(Q_OS_LINUX)
+    bool ensureTimerFd();
+
+    int m_fd = -1;
+    bool m_fdFailed = false;
+    QSocketNotifier *m_notifier = nullptr;
+#endif
+    QTimer m_timer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSPRECISETIMER_P_H
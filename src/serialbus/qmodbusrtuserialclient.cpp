@@ -3,14 +3,63 @@
 
 #include "qmodbusrtuserialclient.h"
 #include "qmodbusrtuserialclient_p.h"
+#include "qmodbusrtuserialclientgroup_p.h"
 
 #include <QtCore/qloggingcategory.h>
 
+#if defined(Q_OS_UNIX)
+#include <sys/ioctl.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
 Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
 
+void QModbusRtuSerialClientPrivate::scheduleRequestInGroup(std::chrono::microseconds delay)
+{
+    QModbusRtuSerialClientGroupPrivate::get(m_group)->scheduleRequest(m_line, delay);
+}
+
+int QModbusRtuSerialClientPrivate::startResponseTimer()
+{
+    if (m_group) {
+        return QModbusRtuSerialClientGroupPrivate::get(m_group)->startResponseTimer(
+                m_line, std::chrono::milliseconds(m_responseTimeoutDuration));
+    }
+    return m_responseTimer.start(m_responseTimeoutDuration);
+}
+
+void QModbusRtuSerialClientPrivate::stopResponseTimer()
+{
+    if (m_group)
+        QModbusRtuSerialClientGroupPrivate::get(m_group)->stopTimers(m_line, false);
+    else
+        m_responseTimer.stop();
+}
+
+void QModbusRtuSerialClientPrivate::stopTimers()
+{
+    if (m_group) {
+        QModbusRtuSerialClientGroupPrivate::get(m_group)->stopTimers(m_line, true);
+    } else {
+        m_responseTimer.stop();
+        m_scheduleTimer.stop();
+    }
+}
+
+std::chrono::microseconds QModbusRtuSerialClientPrivate::remainingTransmitTime() const
+{
+#if defined(Q_OS_UNIX) && defined(TIOCOUTQ)
+    int queued = 0;
+    if (m_serialPort && m_serialPort->isOpen()
+        && ::ioctl(m_serialPort->handle(), TIOCOUTQ, &queued) == 0 && queued > 0) {
+        return std::chrono::microseconds(qCeil(queued * characterTime()));
+    }
+#endif
+    return std::chrono::microseconds(0);
+}
+
 /*!
     \class QModbusRtuSerialClient
     \inmodule QtSerialBus
@@ -22,6 +71,17 @@ Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
     Communication via Modbus requires the interaction between a single
     Modbus client instance and multiple Modbus servers. This class
     provides the client implementation via a serial port.
+
+    The silent intervals between messages, i.e. the interFrameDelay() and the
+    turnaroundDelay() after a broadcast, are measured from the last byte that
+    was sent or received on the line. The next request is sent as soon as the
+    interval has passed, even if the previous reply took some time to be
+    processed. Bytes that arrive while no response is expected restart the
+    interval.
+
+    The messages are sent with the RTU framing by default. The ASCII framing
+    of the Modbus over serial line specification can be selected with the
+    \l QModbusDevice::FramingParameter.
 */
 
 /*!
@@ -46,11 +106,16 @@ QModbusRtuSerialClient::~QModbusRtuSerialClient()
     Returns the amount of microseconds for the silent interval between two
     consecutive Modbus messages.
 
-    \sa setInterFrameDelay()
+    If precise timing is enabled, the returned value is the delay that is
+    actually used, not rounded up to milliseconds.
+
+    \sa setInterFrameDelay(), isPreciseTimingEnabled()
 */
 int QModbusRtuSerialClient::interFrameDelay() const
 {
     Q_D(const QModbusRtuSerialClient);
+    if (d->m_preciseTiming)
+        return int(d->interFrameDelayDuration().count());
     return d->m_interFrameDelayMilliseconds * 1000;
 }
 
@@ -66,6 +131,7 @@ int QModbusRtuSerialClient::interFrameDelay() const
 void QModbusRtuSerialClient::setInterFrameDelay(int microseconds)
 {
     Q_D(QModbusRtuSerialClient);
+    d->m_interFrameDelayMicroseconds = microseconds;
     d->m_interFrameDelayMilliseconds = qCeil(qreal(microseconds) / 1000.);
     d->calculateInterFrameDelay();
 }
@@ -97,6 +163,51 @@ void QModbusRtuSerialClient::setTurnaroundDelay(int turnaroundDelay)
     d->m_turnaroundDelay = turnaroundDelay;
 }
 
+/*!
+    \since 6.7
+
+    Returns \c true if the precise timing mode is enabled; otherwise returns
+    \c false. The mode is disabled by default.
+
+    \sa setPreciseTimingEnabled()
+*/
+bool QModbusRtuSerialClient::isPreciseTimingEnabled() const
+{
+    Q_D(const QModbusRtuSerialClient);
+    return d->m_preciseTiming;
+}
+
+/*!
+    \since 6.7
+
+    Enables the precise timing mode if \a enable is \c true; otherwise
+    disables it.
+
+    By default, the silent interval between two consecutive Modbus messages
+    is rounded up to whole milliseconds and is at least 2 milliseconds, which
+    is much longer than the 3.5 character times required by the Modbus
+    specification at high baud rates. At 115200 baud, for example, 3.5
+    character times take about 0.3 milliseconds.
+
+    In the precise timing mode, the client waits exactly 3.5 character times,
+    calculated from the baud rate, data bits, parity and stop bits, or the
+    delay set by setInterFrameDelay() if that is longer. On Linux the delays
+    are scheduled with microsecond resolution; on other platforms they are
+    still rounded up to milliseconds. In addition, the turnaround delay after
+    a request starts once the serial driver has transmitted the request,
+    instead of when it was written to the driver, where the platform reports
+    this.
+
+    \note Some Modbus servers cannot handle such short silent intervals.
+
+    \sa interFrameDelay(), turnaroundDelay()
+*/
+void QModbusRtuSerialClient::setPreciseTimingEnabled(bool enable)
+{
+    Q_D(QModbusRtuSerialClient);
+    d->m_preciseTiming = enable;
+}
+
 /*!
     \internal
 */
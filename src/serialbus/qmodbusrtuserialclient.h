@@ -30,6 +30,9 @@ public:
     int turnaroundDelay() const;
     void setTurnaroundDelay(int turnaroundDelay);
 
+    bool isPreciseTimingEnabled() const;
+    void setPreciseTimingEnabled(bool enable);
+
 protected:
     QModbusRtuSerialClient(QModbusRtuSerialClientPrivate &dd, QObject *parent = nullptr);
 
@@ -10,12 +10,17 @@
 #include <QtCore/qqueue.h>
 #include <QtCore/qtimer.h>
 #include <QtSerialBus/qmodbusrtuserialclient.h>
+#include <QtSerialBus/qmodbusrtuserialclientgroup.h>
 #include <QtSerialPort/qserialport.h>
 
-#include <private/qmodbusadu_p.h>
 #include <private/qmodbusclient_p.h>
+#include <private/qmodbusframer_p.h>
+#include <private/qmodbusprecisetimer_p.h>
 #include <private/qmodbus_symbols_p.h>
 
+#include <chrono>
+#include <memory>
+
 //
 //  W A R N I N G
 //  -------------
@@ -68,90 +73,113 @@ class QModbusRtuSerialClientPrivate : public QModbusClientPrivate
     enum State
     {
         Idle,
+        Scheduled,
         WaitingForReplay,
         ProcessReply
     } m_state = Idle;
 
 public:
+    using Clock = std::chrono::steady_clock;
+
     void onReadyRead()
     {
-        m_responseBuffer += m_serialPort->read(m_serialPort->bytesAvailable());
-        qCDebug(QT_MODBUS_LOW) << "(RTU client) Response buffer:" << m_responseBuffer.toHex();
-
-        if (m_responseBuffer.size() < 2) {
-            qCDebug(QT_MODBUS) << "(RTU client) Modbus ADU not complete";
+        m_lastLineActivity = Clock::now();
+        if (m_state != WaitingForReplay) {
+            // No response is expected, e.g. it arrived after the timeout. The
+            // bytes are dropped, and the silent interval starts over.
+            const qint64 skipped = m_serialPort->skip(m_serialPort->bytesAvailable());
+            clearResponseBuffer();
+            qCDebug(QT_MODBUS_LOW) << "(RTU client) Discarded" << skipped << "unexpected bytes";
             return;
         }
 
-        const QModbusSerialAdu tmpAdu(QModbusSerialAdu::Rtu, m_responseBuffer);
-        int pduSizeWithoutFcode = QModbusResponse::calculateDataSize(tmpAdu.pdu());
-        if (pduSizeWithoutFcode < 0) {
-            // wait for more data
-            qCDebug(QT_MODBUS) << "(RTU client) Cannot calculate PDU size for function code:"
-                << tmpAdu.pdu().functionCode() << ", delaying pending frame";
-            return;
-        }
-
-        // server address byte + function code byte + PDU size + 2 bytes CRC
-        int aduSize = 2 + pduSizeWithoutFcode + 2;
-        if (tmpAdu.rawSize() < aduSize) {
-            qCDebug(QT_MODBUS) << "(RTU client) Incomplete ADU received, ignoring";
-            return;
-        }
+        // Read into the existing buffer, so that its capacity is reused.
+        const qsizetype bufferSize = m_responseBuffer.size();
+        const qint64 available = m_serialPort->bytesAvailable();
+        m_responseBuffer.resize(bufferSize + available);
+        const qint64 read = m_serialPort->read(m_responseBuffer.data() + bufferSize, available);
+        m_responseBuffer.resize(bufferSize + qMax(read, qint64(0)));
+        qCDebug(QT_MODBUS_LOW) << "(RTU client) Response buffer:" << m_responseBuffer.toHex();
 
         if (m_queue.isEmpty())
             return;
         auto &current = m_queue.first();
 
-        // Special case for Diagnostics:ReturnQueryData. The response has no
-        // length indicator and is just a simple echo of what we have send.
-        if (tmpAdu.pdu().functionCode() == QModbusPdu::Diagnostics) {
-            const QModbusResponse response = tmpAdu.pdu();
-            if (canMatchRequestAndResponse(response, tmpAdu.serverAddress())) {
-                quint16 subCode = 0xffff;
-                response.decodeData(&subCode);
-                if (subCode == Diagnostics::ReturnQueryData) {
-                    if (response.data() != current.requestPdu.data())
-                        return; // echo does not match request yet
-                    aduSize = 2 + response.dataSize() + 2;
-                    if (tmpAdu.rawSize() < aduSize)
-                        return; // echo matches, probably checksum missing
-                }
-            }
+        // The framer keeps its state between reads: the size of the ADU is
+        // calculated once the header and byte count have arrived, and only
+        // new bytes are added to the checksum. So every byte is processed
+        // once, even if the response arrives in many small chunks.
+        QModbusFramer::Frame frame;
+        QModbusFramer::Status status = QModbusFramer::Incomplete;
+        while (!m_responseBuffer.isEmpty()) {
+            status = m_framer->parse(m_responseBuffer, &frame);
+            if (status != QModbusFramer::Invalid)
+                break;
+            qCDebug(QT_MODBUS) << "(RTU client) Discarding invalid data:"
+                << m_responseBuffer.first(frame.size).toHex();
+            m_responseBuffer.remove(0, frame.size);
+        }
+        if (status != QModbusFramer::Complete) {
+            qCDebug(QT_MODBUS) << "(RTU client) Incomplete ADU received, ignoring";
+            return;
         }
 
-        const QModbusSerialAdu adu(QModbusSerialAdu::Rtu, m_responseBuffer.left(aduSize));
-        m_responseBuffer.remove(0, aduSize);
-
-        qCDebug(QT_MODBUS) << "(RTU client) Received ADU:" << adu.rawData().toHex();
-        if (QT_MODBUS().isDebugEnabled() && !m_responseBuffer.isEmpty())
-            qCDebug(QT_MODBUS_LOW) << "(RTU client) Pending buffer:" << m_responseBuffer.toHex();
+        // The PDU refers to the response buffer, so that no allocation is
+        // needed until the response is passed on.
+        const QModbusResponse pdu = frame.pduView<QModbusResponse>();
+        qCDebug(QT_MODBUS) << "(RTU client) Received ADU:"
+            << m_responseBuffer.first(frame.size).toHex();
 
         // check CRC
-        if (!adu.matchingChecksum()) {
-            qCWarning(QT_MODBUS) << "(RTU client) Discarding response with wrong CRC, received:"
-                << adu.checksum<quint16>() << ", calculated CRC:"
-                << QModbusSerialAdu::calculateCRC(adu.data(), adu.size());
-            m_queue.first().reply->addIntermediateError(QModbusClient::ResponseCrcError);
+        if (!frame.matchingChecksum) {
+            qCWarning(QT_MODBUS) << "(RTU client) Discarding response with wrong checksum:"
+                << m_responseBuffer.first(frame.size).toHex();
+            m_responseBuffer.remove(0, frame.size);
+            ++m_metrics.checksumErrors;
+            current.reply->addIntermediateError(QModbusClient::ResponseCrcError);
             return;
         }
 
-        const QModbusResponse response = adu.pdu();
-        if (!canMatchRequestAndResponse(response, adu.serverAddress())) {
+        if (!canMatchRequestAndResponse(pdu, frame.serverAddress)
+            || (isReturnQueryData(pdu) && pdu.data() != current.requestPdu.data())) {
             qCWarning(QT_MODBUS) << "(RTU client) Cannot match response with open request, "
                 "ignoring";
-            m_queue.first().reply->addIntermediateError(QModbusClient::ResponseRequestMismatch);
+            m_responseBuffer.remove(0, frame.size);
+            ++m_metrics.mismatchedResponses;
+            current.reply->addIntermediateError(QModbusClient::ResponseRequestMismatch);
             return;
         }
 
+        const QModbusResponse response = frame.pdu<QModbusResponse>();
+        m_responseBuffer.remove(0, frame.size);
+        if (QT_MODBUS().isDebugEnabled() && !m_responseBuffer.isEmpty())
+            qCDebug(QT_MODBUS_LOW) << "(RTU client) Pending buffer:" << m_responseBuffer.toHex();
+
         m_state = ProcessReply;
-        m_responseTimer.stop();
+        stopResponseTimer();
         current.m_timerId = INT_MIN;
+        ++m_metrics.responsesReceived;
 
         processQueueElement(response, m_queue.dequeue());
 
         m_state = Idle;
-        scheduleNextRequest(m_interFrameDelayMilliseconds);
+        scheduleNextRequest(interFrameDelayDuration());
+    }
+
+    static bool isReturnQueryData(const QModbusResponse &pdu)
+    {
+        if (pdu.functionCode() != QModbusPdu::Diagnostics || pdu.dataSize() < 2)
+            return false;
+        quint16 subCode = 0xffff;
+        pdu.decodeData(&subCode);
+        return subCode == Diagnostics::ReturnQueryData;
+    }
+
+    void clearResponseBuffer()
+    {
+        m_responseBuffer.resize(0);
+        if (m_framer)
+            m_framer->reset();
     }
 
     void onAboutToClose()
@@ -160,12 +188,12 @@ public:
         Q_UNUSED(q); // avoid warning in release mode
         Q_ASSERT(q->state() == QModbusDevice::ClosingState);
 
-        m_responseTimer.stop();
+        stopTimers();
     }
 
     void onResponseTimeout(int timerId)
     {
-        m_responseTimer.stop();
+        stopResponseTimer();
         if (m_state != State::WaitingForReplay || m_queue.isEmpty())
             return;
         const auto &current = m_queue.first();
@@ -174,6 +202,7 @@ public:
             return;
 
         qCDebug(QT_MODBUS) << "(RTU client) Receive timeout:" << current.requestPdu;
+        ++m_metrics.timeouts;
 
         if (current.numberOfRetries <= 0) {
             auto item = m_queue.dequeue();
@@ -184,7 +213,7 @@ public:
         }
 
         m_state = Idle;
-        scheduleNextRequest(m_interFrameDelayMilliseconds);
+        scheduleNextRequest(interFrameDelayDuration());
     }
 
     void onBytesWritten(qint64 bytes)
@@ -199,13 +228,18 @@ public:
 
         qCDebug(QT_MODBUS) << "(RTU client) Send successful:" << current.requestPdu;
 
+        // The frame is on the wire once the driver has transmitted it.
+        m_lastLineActivity = Clock::now();
+        if (m_preciseTiming)
+            m_lastLineActivity += remainingTransmitTime();
+
         if (!current.reply.isNull() && current.reply->type() == QModbusReply::Broadcast) {
             m_state = ProcessReply;
             processQueueElement({}, m_queue.dequeue());
             m_state = Idle;
-            scheduleNextRequest(m_turnaroundDelay);
+            scheduleNextRequest(std::chrono::milliseconds(m_turnaroundDelay));
         } else {
-            current.m_timerId = m_responseTimer.start(m_responseTimeoutDuration);
+            current.m_timerId = startResponseTimer();
         }
     }
 
@@ -267,6 +301,10 @@ public:
             onResponseTimeout(timerId);
         });
 
+        QObject::connect(&m_scheduleTimer, &QModbusPreciseTimer::timeout, q, [this]() {
+            processQueue();
+        });
+
         QObject::connect(m_serialPort, &QSerialPort::readyRead, q, [this]() {
             onReadyRead();
         });
@@ -297,7 +335,8 @@ public:
 
         calculateInterFrameDelay();
 
-        m_responseBuffer.clear();
+        m_framer = QModbusFramer::create(framing(), QModbusFramer::Responses);
+        clearResponseBuffer();
         m_state = QModbusRtuSerialClientPrivate::Idle;
     }
 
@@ -309,41 +348,106 @@ public:
         auto reply = new QModbusReply(serverAddress == 0 ? QModbusReply::Broadcast : type,
             serverAddress, q);
         QueueElement element(reply, request, unit, m_numberOfRetries + 1);
-        element.adu = QModbusSerialAdu::create(QModbusSerialAdu::Rtu, serverAddress, request);
+        element.adu = m_framer->createAdu(0, serverAddress, request);
         m_queue.enqueue(element);
 
-        scheduleNextRequest(m_interFrameDelayMilliseconds);
+        scheduleNextRequest(interFrameDelayDuration());
 
         return reply;
     }
 
-    void scheduleNextRequest(int delay)
+    // Schedules the next request to be sent once the line has been silent for
+    // the given time. The silence is measured from the last byte on the line,
+    // so the time spent in processing the previous reply is not added to it.
+    void scheduleNextRequest(std::chrono::microseconds silence)
+    {
+        if (m_state == Idle && !m_queue.isEmpty()) {
+            m_state = Scheduled;
+            m_requiredSilence = silence;
+            startScheduleTimer(remainingSilence());
+        }
+    }
+
+    std::chrono::microseconds remainingSilence() const
+    {
+        const auto remaining = std::chrono::ceil<std::chrono::microseconds>(
+                m_lastLineActivity + m_requiredSilence - Clock::now());
+        return qMax(remaining, std::chrono::microseconds(0));
+    }
+
+    void startScheduleTimer(std::chrono::microseconds delay)
     {
         Q_Q(QModbusRtuSerialClient);
 
-        if (m_state == Idle && !m_queue.isEmpty()) {
-            m_state = WaitingForReplay;
-            QTimer::singleShot(delay, q, [this]() { processQueue(); });
+        if (m_group) {
+            scheduleRequestInGroup(delay);
+        } else if (m_preciseTiming) {
+            m_scheduleTimer.start(delay);
+        } else {
+            QTimer::singleShot(std::chrono::ceil<std::chrono::milliseconds>(delay), q,
+                               [this]() { processQueue(); });
+        }
+    }
+
+    std::chrono::microseconds interFrameDelayDuration() const
+    {
+        if (m_preciseTiming) {
+            return std::chrono::microseconds(qMax(m_interFrameDelayMicroseconds,
+                                                  calculatePreciseInterFrameDelay()));
         }
+        return std::chrono::milliseconds(m_interFrameDelayMilliseconds);
     }
 
+    // Without a group, each client has its own timers. The lines of a
+    // QModbusRtuSerialClientGroup leave them to the group instead.
+    void scheduleRequestInGroup(std::chrono::microseconds delay);
+    int startResponseTimer();
+    void stopResponseTimer();
+    void stopTimers();
+
+    // Returns the time the serial driver still needs to transmit the bytes in
+    // its output queue, so that the silence after a request starts when the
+    // frame has left the wire instead of when it was written.
+    std::chrono::microseconds remainingTransmitTime() const;
+
     void processQueue()
     {
-        m_responseBuffer.clear();
-        m_serialPort->clear(QSerialPort::AllDirections);
+        if (m_state != Scheduled)
+            return;
 
-        if (m_queue.isEmpty())
+        // Unexpected bytes have restarted the silent interval while waiting.
+        const std::chrono::microseconds remaining = remainingSilence();
+        if (remaining.count() > 0) {
+            startScheduleTimer(remaining);
             return;
+        }
+
+        // Flushing the port is a system call, so it is only done if the line
+        // holds stale bytes. The ADU of the request has been built when it was
+        // enqueued, so only the write is left when the silent interval ends.
+        if (!m_responseBuffer.isEmpty() || m_serialPort->bytesAvailable() > 0
+            || m_serialPort->bytesToWrite() > 0) {
+            qCDebug(QT_MODBUS_LOW) << "(RTU client) Discarding stale bytes";
+            m_serialPort->clear(QSerialPort::AllDirections);
+        }
+        clearResponseBuffer();
+
+        if (m_queue.isEmpty()) {
+            m_state = Idle;
+            return;
+        }
         auto &current = m_queue.first();
 
         if (current.reply.isNull()) {
             m_queue.dequeue();
             m_state = Idle;
-            scheduleNextRequest(m_interFrameDelayMilliseconds);
+            scheduleNextRequest(interFrameDelayDuration());
         } else {
+            m_state = WaitingForReplay;
             current.bytesWritten = 0;
             current.numberOfRetries--;
             m_serialPort->write(current.adu);
+            ++m_metrics.requestsSent;
 
             qCDebug(QT_MODBUS) << "(RTU client) Sent Serial PDU:" << current.requestPdu;
             qCDebug(QT_MODBUS_LOW).noquote() << "(RTU client) Sent Serial ADU: 0x" + current.adu
@@ -374,14 +478,28 @@ public:
     }
 
     QIODevice *device() const override { return m_serialPort; }
+    QModbusDevice::Framing defaultFraming() const override { return QModbusDevice::RtuFraming; }
 
     Timer m_responseTimer;
     QByteArray m_responseBuffer;
+    // keeps the parsing state of the response at the start of the buffer
+    std::unique_ptr<QModbusFramer> m_framer;
 
     QQueue<QueueElement> m_queue;
     QSerialPort *m_serialPort = nullptr;
 
     int m_turnaroundDelay = 100; // Recommended value is between 100 and 200 msec.
+
+    bool m_preciseTiming = false;
+    QModbusPreciseTimer m_scheduleTimer;
+    // the timeline of the line: the next request is sent once it has been
+    // silent for the required time since the last byte was sent or received
+    Clock::time_point m_lastLineActivity;
+    std::chrono::microseconds m_requiredSilence{0};
+
+    QModbusRtuSerialClientGroup *m_group = nullptr;
+    qsizetype m_line = -1;
+    QModbusRtuSerialClientGroup::Metrics m_metrics;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,329 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusrtuserialclientgroup.h"
+#include "qmodbusrtuserialclientgroup_p.h"
+#include "qmodbusrtuserialclient_p.h"
+
+#include <QtCore/qloggingcategory.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+
+/*!
+    \class QModbusRtuSerialClientGroup
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QModbusRtuSerialClientGroup class drives the Modbus clients of
+    many serial lines from one thread.
+
+    Each QModbusRtuSerialClient schedules its requests and response timeouts
+    with timers of its own. An application that polls many serial lines, e.g.
+    several RS-485 segments, therefore keeps many timers and single-shot
+    callbacks busy in its event loop.
+
+    A QModbusRtuSerialClientGroup owns one client per serial line, created with
+    addLine(). The clients of a group leave all of their timing to the group:
+    the silent intervals between requests and the response timeouts of all
+    lines are kept as deadlines, and are served by a single timer with
+    microsecond resolution (on Linux, a timerfd). The next request of a line
+    is sent as soon as its silent interval ends, independent of the other lines.
+
+    Requests are sent using the client of a line, which is returned by line():
+
+    \code
+        QModbusRtuSerialClientGroup group;
+        for (const QString &portName : portNames) {
+            const qsizetype index = group.addLine(portName);
+            group.line(index)->setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                                      QSerialPort::Baud115200);
+        }
+        group.connectLines();
+        QModbusReply *reply = group.line(3)->sendReadRequest(unit, serverAddress);
+    \endcode
+
+    The traffic of all lines is counted in the shared \l Metrics.
+
+    \sa QModbusRtuSerialClient
+*/
+
+/*!
+    \class QModbusRtuSerialClientGroup::Metrics
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QModbusRtuSerialClientGroup::Metrics struct holds traffic
+    counters of the lines of a QModbusRtuSerialClientGroup.
+
+    The counters are accumulated since the line was added or since the last
+    call to \l QModbusRtuSerialClientGroup::resetMetrics().
+*/
+
+/*!
+    \variable QModbusRtuSerialClientGroup::Metrics::requestsSent
+
+    \brief The number of requests written to the serial port, including
+    broadcasts and retries.
+*/
+
+/*!
+    \variable QModbusRtuSerialClientGroup::Metrics::responsesReceived
+
+    \brief The number of responses that were matched with their requests.
+*/
+
+/*!
+    \variable QModbusRtuSerialClientGroup::Metrics::timeouts
+
+    \brief The number of requests that were not answered in time.
+*/
+
+/*!
+    \variable QModbusRtuSerialClientGroup::Metrics::checksumErrors
+
+    \brief The number of responses that were discarded because of a wrong CRC.
+*/
+
+/*!
+    \variable QModbusRtuSerialClientGroup::Metrics::mismatchedResponses
+
+    \brief The number of responses that did not match the open request.
+*/
+
+QModbusRtuSerialClientPrivate *QModbusRtuSerialClientGroupPrivate::linePrivate(qsizetype line) const
+{
+    return static_cast<QModbusRtuSerialClientPrivate *>(
+            QObjectPrivate::get(lines.at(line).client));
+}
+
+void QModbusRtuSerialClientGroupPrivate::scheduleRequest(qsizetype line,
+                                                         std::chrono::microseconds delay)
+{
+    lines[line].sendDeadline = Clock::now() + delay;
+    updateTimer();
+}
+
+int QModbusRtuSerialClientGroupPrivate::startResponseTimer(qsizetype line,
+                                                           std::chrono::milliseconds timeout)
+{
+    // like timer ids, so that an outdated timeout is recognized by the line
+    nextResponseTimerId = (nextResponseTimerId == INT_MAX) ? 0 : nextResponseTimerId + 1;
+    lines[line].responseDeadline = Clock::now() + timeout;
+    lines[line].responseTimerId = nextResponseTimerId;
+    updateTimer();
+    return nextResponseTimerId;
+}
+
+void QModbusRtuSerialClientGroupPrivate::stopTimers(qsizetype line, bool includingRequest)
+{
+    lines[line].responseDeadline = Clock::time_point::max();
+    if (includingRequest)
+        lines[line].sendDeadline = Clock::time_point::max();
+    updateTimer();
+}
+
+void QModbusRtuSerialClientGroupPrivate::onTimeout()
+{
+    timerDeadline = Clock::time_point::max();
+    dispatching = true;
+
+    // The lines may schedule new deadlines, and the application may add
+    // lines from the reply handlers, so do not keep references into lines.
+    const Clock::time_point now = Clock::now();
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        if (lines.at(i).sendDeadline <= now) {
+            lines[i].sendDeadline = Clock::time_point::max();
+            linePrivate(i)->processQueue();
+        }
+        if (lines.at(i).responseDeadline <= now) {
+            lines[i].responseDeadline = Clock::time_point::max();
+            linePrivate(i)->onResponseTimeout(lines.at(i).responseTimerId);
+        }
+    }
+
+    dispatching = false;
+    updateTimer();
+}
+
+void QModbusRtuSerialClientGroupPrivate::updateTimer()
+{
+    if (dispatching)
+        return;
+
+    Clock::time_point next = Clock::time_point::max();
+    for (const Line &line : std::as_const(lines))
+        next = qMin(next, qMin(line.sendDeadline, line.responseDeadline));
+
+    if (next == timerDeadline)
+        return;
+    timerDeadline = next;
+    if (next == Clock::time_point::max()) {
+        timer.stop();
+        return;
+    }
+    const auto interval = std::chrono::ceil<std::chrono::microseconds>(next - Clock::now());
+    timer.start(qMax(interval, std::chrono::microseconds(0)));
+}
+
+/*!
+    Constructs a group without any lines with the given \a parent.
+*/
+QModbusRtuSerialClientGroup::QModbusRtuSerialClientGroup(QObject *parent)
+    : QObject(*new QModbusRtuSerialClientGroupPrivate, parent)
+{
+    Q_D(QModbusRtuSerialClientGroup);
+    connect(&d->timer, &QModbusPreciseTimer::timeout, this, [d]() { d->onTimeout(); });
+}
+
+/*!
+    Destroys the group. The clients of all lines are disconnected and deleted.
+*/
+QModbusRtuSerialClientGroup::~QModbusRtuSerialClientGroup()
+{
+    Q_D(QModbusRtuSerialClientGroup);
+
+    // the clients use the group while they close
+    for (const QModbusRtuSerialClientGroupPrivate::Line &line : std::as_const(d->lines))
+        delete line.client;
+    d->lines.clear();
+}
+
+/*!
+    Adds a line for the serial port \a portName and returns its index.
+
+    The group creates and owns the QModbusRtuSerialClient of the line. Use
+    line() to configure the client, e.g. the baud rate or the response
+    timeout, and to send requests.
+
+    \sa line(), lineCount()
+*/
+qsizetype QModbusRtuSerialClientGroup::addLine(const QString &portName)
+{
+    Q_D(QModbusRtuSerialClientGroup);
+
+    const qsizetype index = d->lines.size();
+    auto client = new QModbusRtuSerialClient(this);
+    client->setConnectionParameter(QModbusDevice::SerialPortNameParameter, portName);
+
+    auto clientPrivate = static_cast<QModbusRtuSerialClientPrivate *>(
+            QObjectPrivate::get(client));
+    clientPrivate->m_group = this;
+    clientPrivate->m_line = index;
+
+    d->lines.append({ client });
+    return index;
+}
+
+/*!
+    Returns the client of the line with the given \a index, or \c nullptr if
+    there is no such line.
+
+    \sa addLine()
+*/
+QModbusRtuSerialClient *QModbusRtuSerialClientGroup::line(qsizetype index) const
+{
+    Q_D(const QModbusRtuSerialClientGroup);
+
+    if (index < 0 || index >= d->lines.size())
+        return nullptr;
+    return d->lines.at(index).client;
+}
+
+/*!
+    Returns the number of lines of the group.
+*/
+qsizetype QModbusRtuSerialClientGroup::lineCount() const
+{
+    Q_D(const QModbusRtuSerialClientGroup);
+    return d->lines.size();
+}
+
+/*!
+    Connects the clients of all lines. Returns \c true if all of them could be
+    connected; otherwise returns \c false. The errors are reported by the
+    clients of the failed lines.
+
+    \sa disconnectLines(), QModbusDevice::connectDevice()
+*/
+bool QModbusRtuSerialClientGroup::connectLines()
+{
+    Q_D(QModbusRtuSerialClientGroup);
+
+    bool result = true;
+    for (const QModbusRtuSerialClientGroupPrivate::Line &line : std::as_const(d->lines)) {
+        if (!line.client->connectDevice()) {
+            qCWarning(QT_MODBUS) << "(RTU client group) Cannot connect line"
+                                 << line.client->connectionParameter(
+                                            QModbusDevice::SerialPortNameParameter).toString();
+            result = false;
+        }
+    }
+    return result;
+}
+
+/*!
+    Disconnects the clients of all lines.
+
+    \sa connectLines(), QModbusDevice::disconnectDevice()
+*/
+void QModbusRtuSerialClientGroup::disconnectLines()
+{
+    Q_D(QModbusRtuSerialClientGroup);
+
+    for (const QModbusRtuSerialClientGroupPrivate::Line &line : std::as_const(d->lines))
+        line.client->disconnectDevice();
+}
+
+/*!
+    Returns the sum of the traffic counters of all lines.
+
+    \sa resetMetrics()
+*/
+QModbusRtuSerialClientGroup::Metrics QModbusRtuSerialClientGroup::metrics() const
+{
+    Q_D(const QModbusRtuSerialClientGroup);
+
+    Metrics result;
+    for (qsizetype i = 0; i < d->lines.size(); ++i) {
+        const Metrics &metrics = d->linePrivate(i)->m_metrics;
+        result.requestsSent += metrics.requestsSent;
+        result.responsesReceived += metrics.responsesReceived;
+        result.timeouts += metrics.timeouts;
+        result.checksumErrors += metrics.checksumErrors;
+        result.mismatchedResponses += metrics.mismatchedResponses;
+    }
+    return result;
+}
+
+/*!
+    \overload
+
+    Returns the traffic counters of the line with the given \a line index.
+*/
+QModbusRtuSerialClientGroup::Metrics QModbusRtuSerialClientGroup::metrics(qsizetype line) const
+{
+    Q_D(const QModbusRtuSerialClientGroup);
+
+    if (line < 0 || line >= d->lines.size())
+        return {};
+    return d->linePrivate(line)->m_metrics;
+}
+
+/*!
+    Resets the traffic counters of all lines to zero.
+
+    \sa metrics()
+*/
+void QModbusRtuSerialClientGroup::resetMetrics()
+{
+    Q_D(QModbusRtuSerialClientGroup);
+
+    for (qsizetype i = 0; i < d->lines.size(); ++i)
+        d->linePrivate(i)->m_metrics = {};
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qmodbusrtuserialclientgroup.cpp"
@@ -0,0 +1,50 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSRTUSERIALCLIENTGROUP_H
+#define QMODBUSRTUSERIALCLIENTGROUP_H
+
+#include <QtCore/qobject.h>
+#include <QtSerialBus/qtserialbusglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+class QModbusRtuSerialClient;
+class QModbusRtuSerialClientGroupPrivate;
+
+class Q_SERIALBUS_EXPORT QModbusRtuSerialClientGroup : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QModbusRtuSerialClientGroup)
+    Q_DISABLE_COPY(QModbusRtuSerialClientGroup)
+
+public:
+    struct Metrics
+    {
+        quint64 requestsSent = 0;
+        quint64 responsesReceived = 0;
+        quint64 timeouts = 0;
+        quint64 checksumErrors = 0;
+        quint64 mismatchedResponses = 0;
+    };
+
+    explicit QModbusRtuSerialClientGroup(QObject *parent = nullptr);
+    ~QModbusRtuSerialClientGroup() override;
+
+    qsizetype addLine(const QString &portName);
+    QModbusRtuSerialClient *line(qsizetype index) const;
+    qsizetype lineCount() const;
+
+    bool connectLines();
+    void disconnectLines();
+
+    Metrics metrics() const;
+    Metrics metrics(qsizetype line) const;
+    void resetMetrics();
+};
+
+Q_DECLARE_TYPEINFO(QModbusRtuSerialClientGroup::Metrics, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSRTUSERIALCLIENTGROUP_H
@@ -0,0 +1,72 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSRTUSERIALCLIENTGROUP_P_H
+#define QMODBUSRTUSERIALCLIENTGROUP_P_H
+
+#include <QtCore/qlist.h>
+#include <QtSerialBus/qmodbusrtuserialclientgroup.h>
+
+#include <private/qmodbusprecisetimer_p.h>
+#include <private/qobject_p.h>
+
+#include <chrono>
+#include <climits>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QModbusRtuSerialClientPrivate;
+
+class QModbusRtuSerialClientGroupPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QModbusRtuSerialClientGroup)
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The timers of one line. Instead of a timer per line and request, the
+    // deadlines of all lines are served by a single timer.
+    struct Line
+    {
+        QModbusRtuSerialClient *client = nullptr;
+        Clock::time_point sendDeadline = Clock::time_point::max();
+        Clock::time_point responseDeadline = Clock::time_point::max();
+        int responseTimerId = INT_MIN;
+    };
+
+    static QModbusRtuSerialClientGroupPrivate *get(QModbusRtuSerialClientGroup *group)
+    {
+        return group->d_func();
+    }
+
+    // called by the lines
+    void scheduleRequest(qsizetype line, std::chrono::microseconds delay);
+    int startResponseTimer(qsizetype line, std::chrono::milliseconds timeout);
+    void stopTimers(qsizetype line, bool includingRequest);
+
+    void onTimeout();
+    void updateTimer();
+    QModbusRtuSerialClientPrivate *linePrivate(qsizetype line) const;
+
+    QList<Line> lines;
+    QModbusPreciseTimer timer;
+    Clock::time_point timerDeadline = Clock::time_point::max();
+    int nextResponseTimerId = 0;
+    // the timer is updated once after all expired deadlines are handled
+    bool dispatching = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSRTUSERIALCLIENTGROUP_P_H
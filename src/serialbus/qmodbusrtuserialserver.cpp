@@ -23,6 +23,24 @@ QT_BEGIN_NAMESPACE
     Since multiple Modbus server instances can interact with a Modbus client
     at the same time (using a serial bus), servers are identified by their
     \l serverAddress().
+
+    A request ends with a silent interval of 3.5 character times on the
+    serial line, as described in the Modbus over serial line specification.
+    A request whose size, calculated from its function code, ends with a
+    matching checksum is processed as soon as its last character is
+    received. Other characters, such as the responses of other servers on
+    the bus, are ignored until the line is silent. For baud rates above
+    19200, the fixed interval of 1750 microseconds recommended by the
+    specification is used. If a USB adapter or another converter delivers
+    the characters of a request with longer gaps, increase the interval with
+    setInterFrameDelay().
+
+    The specification also requires requests that are interrupted by a silent
+    interval of more than 1.5 character times to be discarded. This check is
+    only made if enabled with setInterCharacterTimeoutEnabled().
+
+    The ASCII framing of the specification can be selected with the
+    \l QModbusDevice::FramingParameter. ASCII requests end with a line feed.
 */
 
 /*!
@@ -90,10 +108,47 @@ int QModbusRtuSerialServer::interFrameDelay() const
 void QModbusRtuSerialServer::setInterFrameDelay(int microseconds)
 {
     Q_D(QModbusRtuSerialServer);
+    d->m_interFrameDelayMicroseconds = microseconds;
     d->m_interFrameDelayMilliseconds = qCeil(qreal(microseconds) / 1000.);
     d->calculateInterFrameDelay();
 }
 
+/*!
+    \since 6.7
+
+    Returns \c true if requests that are interrupted by a silent interval of
+    more than 1.5 character times are discarded; otherwise returns \c false.
+    The check is disabled by default.
+
+    \sa setInterCharacterTimeoutEnabled()
+*/
+bool QModbusRtuSerialServer::isInterCharacterTimeoutEnabled() const
+{
+    Q_D(const QModbusRtuSerialServer);
+    return d->m_interCharacterTimeout;
+}
+
+/*!
+    \since 6.7
+
+    Enables the check of the silent intervals within a request if \a enable
+    is \c true; otherwise disables it.
+
+    The Modbus over serial line specification requires a server to discard a
+    request if the line is silent for more than 1.5 character times before
+    the request is complete. Only enable the check if the serial port
+    delivers the characters as they arrive on the line. Converters such as
+    USB adapters collect the characters and hand them over with delays that
+    easily exceed 1.5 character times, which would discard intact requests.
+
+    \sa isInterCharacterTimeoutEnabled(), interFrameDelay()
+*/
+void QModbusRtuSerialServer::setInterCharacterTimeoutEnabled(bool enable)
+{
+    Q_D(QModbusRtuSerialServer);
+    d->m_interCharacterTimeout = enable;
+}
+
 /*!
     \reimp
 
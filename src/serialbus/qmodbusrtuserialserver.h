@@ -29,6 +29,9 @@ public:
     int interFrameDelay() const;
     void setInterFrameDelay(int microseconds);
 
+    bool isInterCharacterTimeoutEnabled() const;
+    void setInterCharacterTimeoutEnabled(bool enable);
+
 protected:
     QModbusRtuSerialServer(QModbusRtuSerialServerPrivate &dd, QObject *parent = nullptr);
 
@@ -6,15 +6,18 @@
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qdebug.h>
-#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qmath.h>
 #include <QtSerialBus/qmodbusrtuserialserver.h>
 #include <QtSerialPort/qserialport.h>
 
 #include <private/qmodbusadu_p.h>
+#include <private/qmodbusframer_p.h>
+#include <private/qmodbusprecisetimer_p.h>
 #include <private/qmodbusserver_p.h>
 
+#include <memory>
+
 //
 //  W A R N I N G
 //  -------------
@@ -35,6 +38,28 @@ class QModbusRtuSerialServerPrivate : public QModbusServerPrivate
 {
     Q_DECLARE_PUBLIC(QModbusRtuSerialServer)
 
+    // The RTU framing of the Modbus over serial line specification: a frame
+    // ends after a silent interval of 3.5 character times (t3.5). A silent
+    // interval of more than 1.5 character times (t1.5) inside of a frame
+    // makes it incomplete.
+    //
+    // A request whose size, calculated from its function code, ends with a
+    // matching CRC is processed without waiting for t3.5. Anything else, e.g.
+    // the response of another server, ends with the silence. USB adapters,
+    // FIFOs and the scheduler add gaps of their own, so t1.5 is only checked
+    // if the user asks for it.
+    enum class FrameState {
+        Idle,           // t3.5 has passed since the last character
+        Reception,      // the last character arrived less than t1.5 ago
+        ControlAndWait  // t1.5 has passed, t3.5 has not
+    };
+
+    enum class FrameStatus {
+        Ok,
+        Interrupted,    // characters arrived after t1.5
+        Overrun         // the frame exceeds the maximum ADU size
+    };
+
 public:
     void setupSerialPort()
     {
@@ -42,209 +67,11 @@ public:
 
         m_serialPort = new QSerialPort(q);
         QObject::connect(m_serialPort, &QSerialPort::readyRead, q, [this]() {
+            onReadyRead();
+        });
 
-            if (m_interFrameTimer.isValid()
-                    && m_interFrameTimer.elapsed() > m_interFrameDelayMilliseconds
-                    && !m_requestBuffer.isEmpty()) {
-                // This permits response buffer clearing if it contains garbage
-                // but still permits cases where very slow baud rates can cause
-                // chunked and delayed packets
-                qCDebug(QT_MODBUS_LOW) << "(RTU server) Dropping older ADU fragments due to larger than 3.5 char delay (expected:"
-                                       << m_interFrameDelayMilliseconds << ", max:"
-                                       << m_interFrameTimer.elapsed() << ")";
-                m_requestBuffer.clear();
-            }
-
-            m_interFrameTimer.start();
-
-            const qint64 size = m_serialPort->size();
-            m_requestBuffer += m_serialPort->read(size);
-
-            const QModbusSerialAdu adu(QModbusSerialAdu::Rtu, m_requestBuffer);
-            qCDebug(QT_MODBUS_LOW) << "(RTU server) Received ADU:" << adu.rawData().toHex();
-
-            // Index                         -> description
-            // Server address                -> 1 byte
-            // FunctionCode                  -> 1 byte
-            // FunctionCode specific content -> 0-252 bytes
-            // CRC                           -> 2 bytes
-            Q_Q(QModbusRtuSerialServer);
-            QModbusCommEvent event = QModbusCommEvent::ReceiveEvent;
-            if (q->value(QModbusServer::ListenOnlyMode).toBool())
-                event |= QModbusCommEvent::ReceiveFlag::CurrentlyInListenOnlyMode;
-
-            // We expect at least the server address, function code and CRC.
-            if (adu.rawSize() < 4) { // TODO: LRC should be 3 bytes.
-                qCWarning(QT_MODBUS) << "(RTU server) Incomplete ADU received, ignoring";
-
-                // The quantity of CRC errors encountered by the remote device since its last
-                // restart, clear counters operation, or power-up. In case of a message
-                // length < 4 bytes, the receiving device is not able to calculate the CRC.
-                incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
-                storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CommunicationError);
-                return;
-            }
-
-            // Server address is set to 0, this is a broadcast.
-            m_processesBroadcast = (adu.serverAddress() == 0);
-            if (q->processesBroadcast())
-                event |= QModbusCommEvent::ReceiveFlag::BroadcastReceived;
-
-            const int pduSizeWithoutFcode = QModbusRequest::calculateDataSize(adu.pdu());
-
-            // server address byte + function code byte + PDU size + 2 bytes CRC
-            if ((pduSizeWithoutFcode < 0) || ((2 + pduSizeWithoutFcode + 2) != adu.rawSize())) {
-                qCWarning(QT_MODBUS) << "(RTU server) ADU does not match expected size, ignoring";
-                // The quantity of messages addressed to the remote device that it could not
-                // handle due to a character overrun condition, since its last restart, clear
-                // counters operation, or power-up. A character overrun is caused by data
-                // characters arriving at the port faster than they can be stored, or by the loss
-                // of a character due to a hardware malfunction.
-                incrementCounter(QModbusServerPrivate::Counter::BusCharacterOverrun);
-                storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CharacterOverrun);
-                return;
-            }
-
-            // We received the full message, including checksum. We do not expect more bytes to
-            // arrive, so clear the buffer. All new bytes are considered part of the next message.
-            m_requestBuffer.resize(0);
-
-            if (!adu.matchingChecksum()) {
-                qCWarning(QT_MODBUS) << "(RTU server) Discarding request with wrong CRC, received:"
-                                     << adu.checksum<quint16>() << ", calculated CRC:"
-                                     << QModbusSerialAdu::calculateCRC(adu.data(), adu.size());
-                // The quantity of CRC errors encountered by the remote device since its last
-                // restart, clear counters operation, or power-up.
-                incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
-                storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CommunicationError);
-                return;
-            }
-
-            // The quantity of messages that the remote device has detected on the communications
-            // system since its last restart, clear counters operation, or power-up.
-            incrementCounter(QModbusServerPrivate::Counter::BusMessage);
-
-            // If we do not process a Broadcast ...
-            if (!q->processesBroadcast()) {
-                // check if the server address matches ...
-                if (q->serverAddress() != adu.serverAddress()) {
-                    // no, not our address! Ignore!
-                    qCDebug(QT_MODBUS) << "(RTU server) Wrong server address, expected"
-                        << q->serverAddress() << "got" << adu.serverAddress();
-                    return;
-                }
-            } // else { Broadcast -> Server address will never match, deliberately ignore }
-
-            storeModbusCommEvent(event); // store the final event before processing
-
-            const QModbusRequest req = adu.pdu();
-            qCDebug(QT_MODBUS) << "(RTU server) Request PDU:" << req;
-            QModbusResponse response; // If the device ...
-            if (q->value(QModbusServer::DeviceBusy).value<quint16>() == 0xffff) {
-                // is busy, update the quantity of messages addressed to the remote device for
-                // which it returned a Server Device Busy exception response, since its last
-                // restart, clear counters operation, or power-up.
-                incrementCounter(QModbusServerPrivate::Counter::ServerBusy);
-                response = QModbusExceptionResponse(req.functionCode(),
-                    QModbusExceptionResponse::ServerDeviceBusy);
-            } else {
-                // is not busy, update the quantity of messages addressed to the remote device,
-                // or broadcast, that the remote device has processed since its last restart,
-                // clear counters operation, or power-up.
-                incrementCounter(QModbusServerPrivate::Counter::ServerMessage);
-                response = q->processRequest(req);
-            }
-            qCDebug(QT_MODBUS) << "(RTU server) Response PDU:" << response;
-
-            event = QModbusCommEvent::SentEvent; // reset event after processing
-            if (q->value(QModbusServer::ListenOnlyMode).toBool())
-                event |= QModbusCommEvent::SendFlag::CurrentlyInListenOnlyMode;
-
-            if ((!response.isValid())
-                || q->processesBroadcast()
-                || q->value(QModbusServer::ListenOnlyMode).toBool()) {
-                // The quantity of messages addressed to the remote device for which it has
-                // returned no response (neither a normal response nor an exception response),
-                // since its last restart, clear counters operation, or power-up.
-                incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
-                storeModbusCommEvent(event);
-                return;
-            }
-
-            const QByteArray result = QModbusSerialAdu::create(QModbusSerialAdu::Rtu,
-                                                               q->serverAddress(), response);
-
-            qCDebug(QT_MODBUS_LOW) << "(RTU server) Response ADU:" << result.toHex();
-
-            if (!m_serialPort->isOpen()) {
-                qCDebug(QT_MODBUS) << "(RTU server) Requesting serial port has closed.";
-                q->setError(QModbusRtuSerialServer::tr("Requesting serial port is closed"),
-                            QModbusDevice::WriteError);
-                incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
-                storeModbusCommEvent(event);
-                return;
-            }
-
-            qint64 writtenBytes = m_serialPort->write(result);
-            if ((writtenBytes == -1) || (writtenBytes < result.size())) {
-                qCDebug(QT_MODBUS) << "(RTU server) Cannot write requested response to serial port.";
-                q->setError(QModbusRtuSerialServer::tr("Could not write response to client"),
-                            QModbusDevice::WriteError);
-                incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
-                storeModbusCommEvent(event);
-                m_serialPort->clear(QSerialPort::Output);
-                return;
-            }
-
-            if (response.isException()) {
-                switch (response.exceptionCode()) {
-                case QModbusExceptionResponse::IllegalFunction:
-                case QModbusExceptionResponse::IllegalDataAddress:
-                case QModbusExceptionResponse::IllegalDataValue:
-                    event |= QModbusCommEvent::SendFlag::ReadExceptionSent;
-                    break;
-
-                case QModbusExceptionResponse::ServerDeviceFailure:
-                    event |= QModbusCommEvent::SendFlag::ServerAbortExceptionSent;
-                    break;
-
-                case QModbusExceptionResponse::ServerDeviceBusy:
-                    // The quantity of messages addressed to the remote device for which it
-                    // returned a server device busy exception response, since its last restart,
-                    // clear counters operation, or power-up.
-                    incrementCounter(QModbusServerPrivate::Counter::ServerBusy);
-                    event |= QModbusCommEvent::SendFlag::ServerBusyExceptionSent;
-                    break;
-
-                case  QModbusExceptionResponse::NegativeAcknowledge:
-                    // The quantity of messages addressed to the remote device for which it
-                    // returned a negative acknowledge (NAK) exception response, since its last
-                    // restart, clear counters operation, or power-up.
-                    incrementCounter(QModbusServerPrivate::Counter::ServerNAK);
-                    event |= QModbusCommEvent::SendFlag::ServerProgramNAKExceptionSent;
-                    break;
-
-                default:
-                    break;
-                }
-                // The quantity of Modbus exception responses returned by the remote device since
-                // its last restart, clear counters operation, or power-up.
-                incrementCounter(QModbusServerPrivate::Counter::BusExceptionError);
-            } else {
-                switch (quint16(req.functionCode())) {
-                case 0x0a: // Poll 484 (not in the official Modbus specification) *1
-                case 0x0e: // Poll Controller (not in the official Modbus specification) *1
-                case QModbusRequest::GetCommEventCounter: // fall through and bail out
-                    break;
-                default:
-                    // The device's event counter is incremented once for each successful message
-                    // completion. Do not increment for exception responses, poll commands, or fetch
-                    // event counter commands.            *1 but mentioned here ^^^
-                    incrementCounter(QModbusServerPrivate::Counter::CommEvent);
-                    break;
-                }
-            }
-            storeModbusCommEvent(event); // store the final event after processing
+        QObject::connect(&m_frameTimer, &QModbusPreciseTimer::timeout, q, [this]() {
+            onFrameTimeout();
         });
 
         QObject::connect(m_serialPort, &QSerialPort::errorOccurred, q,
@@ -298,12 +125,369 @@ public:
 
         QObject::connect(m_serialPort, &QSerialPort::aboutToClose, q, [this]() {
             Q_Q(QModbusRtuSerialServer);
+            resetFrame();
             // update state if socket closure was caused by remote side
             if (q->state() != QModbusDevice::ClosingState)
                 q->setState(QModbusDevice::UnconnectedState);
         });
     }
 
+    void onReadyRead()
+    {
+        const bool framePending = !m_requestBuffer.isEmpty();
+
+        // Read into the existing buffer, so that its capacity is reused.
+        const qsizetype bufferSize = m_requestBuffer.size();
+        const qint64 size = m_serialPort->size();
+        m_requestBuffer.resize(bufferSize + size);
+        const qint64 read = m_serialPort->read(m_requestBuffer.data() + bufferSize, size);
+        m_requestBuffer.resize(bufferSize + qMax(read, qint64(0)));
+        if (read <= 0)
+            return;
+
+        if (m_framer->framing() != QModbusDevice::RtuFraming) {
+            processFramedRequests();
+            return;
+        }
+
+        if (m_discardUntilSilence) {
+            // the rest of a frame that is not a request to this server
+            m_requestBuffer.resize(bufferSize);
+        } else if (framePending && m_interCharacterTimeout
+                   && m_frameState != FrameState::Reception) {
+            m_frameStatus = FrameStatus::Interrupted;
+        }
+
+        if (m_requestBuffer.size() > QModbusSerialAdu::MaxSize) {
+            // keep reading until the line is silent, but drop the data
+            m_frameStatus = FrameStatus::Overrun;
+            m_requestBuffer.resize(QModbusSerialAdu::MaxSize);
+        }
+        qCDebug(QT_MODBUS_LOW) << "(RTU server) Request buffer:" << m_requestBuffer.toHex();
+
+        m_frameState = FrameState::Reception;
+        m_frameTimer.start(m_interCharacterTimeout ? interCharacterTimeout()
+                                                   : interFrameTimeout());
+        if (m_frameStatus == FrameStatus::Ok)
+            processSizedRequests();
+    }
+
+    void onFrameTimeout()
+    {
+        if (m_frameState == FrameState::Reception && m_interCharacterTimeout) {
+            m_frameState = FrameState::ControlAndWait;
+            m_frameTimer.start(interFrameTimeout() - interCharacterTimeout());
+            return;
+        }
+
+        // t3.5 has passed, the frame is complete.
+        const bool discard = m_discardUntilSilence;
+        const FrameStatus status = m_frameStatus;
+        const QModbusSerialAdu adu(QModbusSerialAdu::Rtu, m_requestBuffer);
+        resetFrame();
+        if (discard || adu.rawSize() == 0)
+            return;
+
+        // The CRC over all bytes, including the checksum, is zero for a
+        // valid ADU.
+        const QByteArray rawData = adu.rawData();
+        const bool matchingChecksum = QModbusSerialAdu::updateCRC(
+                QModbusSerialAdu::CrcInitialValue, rawData.constData(), rawData.size()) == 0;
+        qCDebug(QT_MODBUS_LOW) << "(RTU server) Received ADU:" << rawData.toHex();
+        processFrame(adu.rawSize(), adu.serverAddress(), adu.pdu(), status, matchingChecksum);
+    }
+
+    // Processes the requests that end where their function code says, before
+    // the line is silent.
+    void processSizedRequests()
+    {
+        Q_Q(QModbusRtuSerialServer);
+        while (!m_requestBuffer.isEmpty()) {
+            QModbusFramer::Frame frame;
+            const auto status = m_framer->parse(m_requestBuffer, &frame);
+            if (status == QModbusFramer::Incomplete)
+                return;
+
+            // The bytes do not form a request. Most likely they belong to the
+            // traffic of other devices on the bus, e.g. a response, so they
+            // are neither parsed further nor counted as errors. The next
+            // frame starts after the silence.
+            if (status == QModbusFramer::Invalid || !frame.matchingChecksum) {
+                qCDebug(QT_MODBUS_LOW) << "(RTU server) Ignoring data until t3.5:"
+                                       << m_requestBuffer.toHex();
+                m_requestBuffer.resize(0);
+                m_framer->reset();
+                m_discardUntilSilence = true;
+                return;
+            }
+
+            const qsizetype size = frame.size;
+            const int serverAddress = frame.serverAddress;
+            const QModbusRequest request = frame.pdu<QModbusRequest>();
+            const FrameStatus frameStatus = m_frameStatus;
+            qCDebug(QT_MODBUS_LOW) << "(RTU server) Received ADU:"
+                                   << m_requestBuffer.first(size).toHex();
+            m_requestBuffer.remove(0, size);
+            m_frameStatus = FrameStatus::Ok;
+
+            processFrame(size, serverAddress, request, frameStatus, true);
+
+            // The response of the other server follows a request to it.
+            if (serverAddress != 0 && serverAddress != q->serverAddress()) {
+                m_requestBuffer.resize(0);
+                m_framer->reset();
+                m_discardUntilSilence = true;
+                return;
+            }
+        }
+    }
+
+    // Without the silent intervals of the RTU framing, the end of a frame is
+    // found by the framer, e.g. the line feed of an ASCII frame.
+    void processFramedRequests()
+    {
+        while (!m_requestBuffer.isEmpty()) {
+            qCDebug(QT_MODBUS_LOW) << "(RTU server) Request buffer:" << m_requestBuffer.toHex();
+
+            QModbusFramer::Frame frame;
+            const auto status = m_framer->parse(m_requestBuffer, &frame);
+            if (status == QModbusFramer::Incomplete)
+                return;
+            if (status == QModbusFramer::Invalid) {
+                qCWarning(QT_MODBUS) << "(RTU server) Discarding invalid data:"
+                                     << m_requestBuffer.first(frame.size).toHex();
+                m_requestBuffer.remove(0, frame.size);
+                incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+                continue;
+            }
+
+            const qsizetype size = frame.size;
+            const int serverAddress = frame.serverAddress;
+            const bool matchingChecksum = frame.matchingChecksum;
+            const QModbusRequest request = frame.pdu<QModbusRequest>();
+            m_requestBuffer.remove(0, frame.size);
+
+            processFrame(size, serverAddress, request, FrameStatus::Ok, matchingChecksum);
+        }
+    }
+
+    // Processes a complete frame.
+    void processFrame(qsizetype rawSize, int serverAddress, const QModbusRequest &req,
+                      FrameStatus frameStatus, bool matchingChecksum)
+    {
+        // Index                         -> description
+        // Server address                -> 1 byte
+        // FunctionCode                  -> 1 byte
+        // FunctionCode specific content -> 0-252 bytes
+        // CRC                           -> 2 bytes
+        Q_Q(QModbusRtuSerialServer);
+        QModbusCommEvent event = QModbusCommEvent::ReceiveEvent;
+        if (q->value(QModbusServer::ListenOnlyMode).toBool())
+            event |= QModbusCommEvent::ReceiveFlag::CurrentlyInListenOnlyMode;
+
+        // We expect at least the server address, function code and CRC.
+        if (rawSize < 4) { // TODO: LRC should be 3 bytes.
+            qCWarning(QT_MODBUS) << "(RTU server) Incomplete ADU received, ignoring";
+
+            // The quantity of CRC errors encountered by the remote device since its last
+            // restart, clear counters operation, or power-up. In case of a message
+            // length < 4 bytes, the receiving device is not able to calculate the CRC.
+            incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+            storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CommunicationError);
+            return;
+        }
+
+        if (frameStatus == FrameStatus::Overrun) {
+            qCWarning(QT_MODBUS) << "(RTU server) ADU exceeds the maximum size, ignoring";
+            // The quantity of messages addressed to the remote device that it could not
+            // handle due to a character overrun condition, since its last restart, clear
+            // counters operation, or power-up. A character overrun is caused by data
+            // characters arriving at the port faster than they can be stored, or by the loss
+            // of a character due to a hardware malfunction.
+            incrementCounter(QModbusServerPrivate::Counter::BusCharacterOverrun);
+            storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CharacterOverrun);
+            return;
+        }
+
+        if (frameStatus == FrameStatus::Interrupted) {
+            qCWarning(QT_MODBUS) << "(RTU server) ADU interrupted by more than 1.5 character "
+                                    "times of silence, ignoring";
+            incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+            storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CommunicationError);
+            return;
+        }
+
+        // Server address is set to 0, this is a broadcast.
+        m_processesBroadcast = (serverAddress == 0);
+        if (q->processesBroadcast())
+            event |= QModbusCommEvent::ReceiveFlag::BroadcastReceived;
+
+        if (!matchingChecksum) {
+            qCWarning(QT_MODBUS) << "(RTU server) Discarding request with wrong checksum";
+            // The quantity of CRC errors encountered by the remote device since its last
+            // restart, clear counters operation, or power-up.
+            incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+            storeModbusCommEvent(event | QModbusCommEvent::ReceiveFlag::CommunicationError);
+            return;
+        }
+
+        // The quantity of messages that the remote device has detected on the communications
+        // system since its last restart, clear counters operation, or power-up.
+        incrementCounter(QModbusServerPrivate::Counter::BusMessage);
+
+        // If we do not process a Broadcast ...
+        if (!q->processesBroadcast()) {
+            // check if the server address matches ...
+            if (q->serverAddress() != serverAddress) {
+                // no, not our address! Ignore!
+                qCDebug(QT_MODBUS) << "(RTU server) Wrong server address, expected"
+                    << q->serverAddress() << "got" << serverAddress;
+                return;
+            }
+        } // else { Broadcast -> Server address will never match, deliberately ignore }
+
+        storeModbusCommEvent(event); // store the final event before processing
+
+        qCDebug(QT_MODBUS) << "(RTU server) Request PDU:" << req;
+        QModbusResponse response; // If the device ...
+        if (q->value(QModbusServer::DeviceBusy).value<quint16>() == 0xffff) {
+            // is busy, update the quantity of messages addressed to the remote device for
+            // which it returned a Server Device Busy exception response, since its last
+            // restart, clear counters operation, or power-up.
+            incrementCounter(QModbusServerPrivate::Counter::ServerBusy);
+            response = QModbusExceptionResponse(req.functionCode(),
+                QModbusExceptionResponse::ServerDeviceBusy);
+        } else {
+            // is not busy, update the quantity of messages addressed to the remote device,
+            // or broadcast, that the remote device has processed since its last restart,
+            // clear counters operation, or power-up.
+            incrementCounter(QModbusServerPrivate::Counter::ServerMessage);
+            response = q->processRequest(req);
+        }
+        qCDebug(QT_MODBUS) << "(RTU server) Response PDU:" << response;
+
+        event = QModbusCommEvent::SentEvent; // reset event after processing
+        if (q->value(QModbusServer::ListenOnlyMode).toBool())
+            event |= QModbusCommEvent::SendFlag::CurrentlyInListenOnlyMode;
+
+        if ((!response.isValid())
+            || q->processesBroadcast()
+            || q->value(QModbusServer::ListenOnlyMode).toBool()) {
+            // The quantity of messages addressed to the remote device for which it has
+            // returned no response (neither a normal response nor an exception response),
+            // since its last restart, clear counters operation, or power-up.
+            incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
+            storeModbusCommEvent(event);
+            return;
+        }
+
+        // The response is written into the same buffer each time, so that
+        // its capacity is reused.
+        m_responseAdu.resize(0);
+        m_framer->appendAdu(&m_responseAdu, 0, q->serverAddress(), response);
+        const char *result = m_responseAdu.constData();
+        const qsizetype resultSize = m_responseAdu.size();
+
+        qCDebug(QT_MODBUS_LOW) << "(RTU server) Response ADU:" << m_responseAdu.toHex();
+
+        if (!m_serialPort->isOpen()) {
+            qCDebug(QT_MODBUS) << "(RTU server) Requesting serial port has closed.";
+            q->setError(QModbusRtuSerialServer::tr("Requesting serial port is closed"),
+                        QModbusDevice::WriteError);
+            incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
+            storeModbusCommEvent(event);
+            return;
+        }
+
+        qint64 writtenBytes = m_serialPort->write(result, resultSize);
+        if ((writtenBytes == -1) || (writtenBytes < resultSize)) {
+            qCDebug(QT_MODBUS) << "(RTU server) Cannot write requested response to serial port.";
+            q->setError(QModbusRtuSerialServer::tr("Could not write response to client"),
+                        QModbusDevice::WriteError);
+            incrementCounter(QModbusServerPrivate::Counter::ServerNoResponse);
+            storeModbusCommEvent(event);
+            m_serialPort->clear(QSerialPort::Output);
+            return;
+        }
+
+        if (response.isException()) {
+            switch (response.exceptionCode()) {
+            case QModbusExceptionResponse::IllegalFunction:
+            case QModbusExceptionResponse::IllegalDataAddress:
+            case QModbusExceptionResponse::IllegalDataValue:
+                event |= QModbusCommEvent::SendFlag::ReadExceptionSent;
+                break;
+
+            case QModbusExceptionResponse::ServerDeviceFailure:
+                event |= QModbusCommEvent::SendFlag::ServerAbortExceptionSent;
+                break;
+
+            case QModbusExceptionResponse::ServerDeviceBusy:
+                // The quantity of messages addressed to the remote device for which it
+                // returned a server device busy exception response, since its last restart,
+                // clear counters operation, or power-up.
+                incrementCounter(QModbusServerPrivate::Counter::ServerBusy);
+                event |= QModbusCommEvent::SendFlag::ServerBusyExceptionSent;
+                break;
+
+            case  QModbusExceptionResponse::NegativeAcknowledge:
+                // The quantity of messages addressed to the remote device for which it
+                // returned a negative acknowledge (NAK) exception response, since its last
+                // restart, clear counters operation, or power-up.
+                incrementCounter(QModbusServerPrivate::Counter::ServerNAK);
+                event |= QModbusCommEvent::SendFlag::ServerProgramNAKExceptionSent;
+                break;
+
+            default:
+                break;
+            }
+            // The quantity of Modbus exception responses returned by the remote device since
+            // its last restart, clear counters operation, or power-up.
+            incrementCounter(QModbusServerPrivate::Counter::BusExceptionError);
+        } else {
+            switch (quint16(req.functionCode())) {
+            case 0x0a: // Poll 484 (not in the official Modbus specification) *1
+            case 0x0e: // Poll Controller (not in the official Modbus specification) *1
+            case QModbusRequest::GetCommEventCounter: // fall through and bail out
+                break;
+            default:
+                // The device's event counter is incremented once for each successful message
+                // completion. Do not increment for exception responses, poll commands, or fetch
+                // event counter commands.            *1 but mentioned here ^^^
+                incrementCounter(QModbusServerPrivate::Counter::CommEvent);
+                break;
+            }
+        }
+        storeModbusCommEvent(event); // store the final event after processing
+    }
+
+    void resetFrame()
+    {
+        m_frameTimer.stop();
+        m_frameState = FrameState::Idle;
+        m_frameStatus = FrameStatus::Ok;
+        m_discardUntilSilence = false;
+        m_requestBuffer.resize(0);
+        if (m_framer)
+            m_framer->reset();
+    }
+
+    // t1.5 and t3.5. Above 19200 baud the specification recommends fixed
+    // values of 750 and 1750 microseconds, since the timers would have to be
+    // very precise otherwise. A longer user defined t3.5 is kept.
+    std::chrono::microseconds interCharacterTimeout() const
+    {
+        if (m_baudRate > 19200)
+            return std::chrono::microseconds(750);
+        return std::chrono::microseconds(qCeil(1.5 * characterTime()));
+    }
+
+    std::chrono::microseconds interFrameTimeout() const
+    {
+        const int delay = m_baudRate > 19200 ? 1750 : calculatePreciseInterFrameDelay();
+        return std::chrono::microseconds(qMax(delay, m_interFrameDelayMicroseconds));
+    }
+
     void setupEnvironment()
     {
         if (m_serialPort) {
@@ -316,15 +500,25 @@ public:
 
         calculateInterFrameDelay();
 
-        m_requestBuffer.clear();
+        m_framer = QModbusFramer::create(framing(), QModbusFramer::Requests);
+        resetFrame();
     }
 
     QIODevice *device() const override { return m_serialPort; }
+    QModbusDevice::Framing defaultFraming() const override { return QModbusDevice::RtuFraming; }
 
     QByteArray m_requestBuffer;
+    FrameState m_frameState = FrameState::Idle;
+    FrameStatus m_frameStatus = FrameStatus::Ok;
+    // the frame is not a request to this server, and is dropped at t3.5
+    bool m_discardUntilSilence = false;
+    bool m_interCharacterTimeout = false; // discard frames interrupted for t1.5
+    QModbusPreciseTimer m_frameTimer;
+    // finds the end of the frames, and encodes the responses
+    std::unique_ptr<QModbusFramer> m_framer;
+    QByteArray m_responseAdu;
     bool m_processesBroadcast = false;
     QSerialPort *m_serialPort = nullptr;
-    QElapsedTimer m_interFrameTimer;
 };
 
 QT_END_NAMESPACE
@@ -16,6 +16,18 @@ QT_BEGIN_NAMESPACE
     \brief The QModbusTcpClient class is the interface class for Modbus TCP client device.
 
     QModbusTcpClient communicates with the Modbus backend providing users with a convenient API.
+
+    By default, the messages are framed with the Modbus Application Protocol
+    header. Many serial gateways expect the RTU framing of a serial line
+    instead, which can be selected with the \l QModbusDevice::FramingParameter:
+
+    \code
+        client->setConnectionParameter(QModbusDevice::FramingParameter,
+                                       QModbusDevice::RtuFraming);
+    \endcode
+
+    Without transaction identifiers, as with the RTU framing, responses are
+    matched with the requests in the order the requests were sent.
 */
 
 /*!
@@ -69,6 +81,7 @@ bool QModbusTcpClient::open()
         return false;
     }
 
+    d->m_framer = QModbusFramer::create(d->framing(), QModbusFramer::Responses);
     d->m_socket->connectToHost(url.host(), url.port());
 
     return true;
@@ -9,7 +9,7 @@
 #include <QtNetwork/qtcpsocket.h>
 #include "QtSerialBus/qmodbustcpclient.h"
 
-#include "private/qmodbusclient_p.h"
+#include "private/qmodbusnetworkclient_p.h"
 
 //
 //  W A R N I N G
@@ -27,7 +27,7 @@ QT_BEGIN_NAMESPACE
 Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
 Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
 
-class QModbusTcpClientPrivate : public QModbusClientPrivate
+class QModbusTcpClientPrivate : public QModbusNetworkClientPrivate
 {
     Q_DECLARE_PUBLIC(QModbusTcpClient)
 
@@ -43,6 +43,7 @@ public:
                                << "on port" << m_socket->peerPort();
             Q_Q(QModbusTcpClient);
             responseBuffer.clear();
+            m_framer->reset();
             q->setState(QModbusDevice::ConnectedState);
         });
 
@@ -69,127 +70,50 @@ public:
         QObject::connect(m_socket, &QIODevice::readyRead, q, [this](){
             responseBuffer += m_socket->read(m_socket->bytesAvailable());
             qCDebug(QT_MODBUS_LOW) << "(TCP client) Response buffer:" << responseBuffer.toHex();
-
-            while (!responseBuffer.isEmpty()) {
-                // can we read enough for Modbus ADU header?
-                if (responseBuffer.size() < mbpaHeaderSize) {
-                    qCDebug(QT_MODBUS_LOW) << "(TCP client) MBPA header too short. Waiting for more data.";
-                    return;
-                }
-
-                quint8 serverAddress;
-                quint16 transactionId, bytesPdu, protocolId;
-                QDataStream input(responseBuffer);
-                input >> transactionId >> protocolId >> bytesPdu >> serverAddress;
-
-                // stop the timer as soon as we know enough about the transaction
-                const bool knownTransaction = m_transactionStore.contains(transactionId);
-                if (knownTransaction && m_transactionStore[transactionId].timer)
-                    m_transactionStore[transactionId].timer->stop();
-
-                qCDebug(QT_MODBUS) << "(TCP client) tid:" << Qt::hex << transactionId << "size:"
-                    << bytesPdu << "server address:" << serverAddress;
-
-                // The length field is the byte count of the following fields, including the Unit
-                // Identifier and the PDU, so we remove on byte.
-                bytesPdu--;
-
-                int tcpAduSize = mbpaHeaderSize + bytesPdu;
-                if (responseBuffer.size() < tcpAduSize) {
-                    qCDebug(QT_MODBUS) << "(TCP client) PDU too short. Waiting for more data";
-                    return;
-                }
-
-                QModbusResponse responsePdu;
-                input >> responsePdu;
-                qCDebug(QT_MODBUS) << "(TCP client) Received PDU:" << responsePdu.functionCode()
-                                   << responsePdu.data().toHex();
-
-                responseBuffer.remove(0, tcpAduSize);
-
-                if (!knownTransaction) {
-                    qCDebug(QT_MODBUS) << "(TCP client) No pending request for response with "
-                        "given transaction ID, ignoring response message.";
-                } else {
-                    processQueueElement(responsePdu, m_transactionStore[transactionId]);
-                }
-            }
+            processResponseBuffer();
         });
     }
 
-    QModbusReply *enqueueRequest(const QModbusRequest &request, int serverAddress,
-                                 const QModbusDataUnit &unit,
-                                 QModbusReply::ReplyType type) override
+    void processResponseBuffer()
     {
-        auto writeToSocket = [this](quint16 tId, const QModbusRequest &request, int address) {
-            QByteArray buffer;
-            QDataStream output(&buffer, QIODevice::WriteOnly);
-            output << tId << quint16(0) << quint16(request.size() + 1) << quint8(address) << request;
-
-            int writtenBytes = m_socket->write(buffer);
-            if (writtenBytes == -1 || writtenBytes < buffer.size()) {
-                Q_Q(QModbusTcpClient);
-                qCDebug(QT_MODBUS) << "(TCP client) Cannot write request to socket.";
-                q->setError(QModbusTcpClient::tr("Could not write request to socket."),
-                            QModbusDevice::WriteError);
-                return false;
+        while (!responseBuffer.isEmpty()) {
+            QModbusFramer::Frame frame;
+            const auto status = m_framer->parse(responseBuffer, &frame);
+            if (status == QModbusFramer::Incomplete) {
+                qCDebug(QT_MODBUS_LOW) << "(TCP client) ADU too short. Waiting for more data.";
+                return;
+            }
+            if (status == QModbusFramer::Invalid) {
+                qCWarning(QT_MODBUS) << "(TCP client) Discarding invalid data:"
+                                     << responseBuffer.first(frame.size).toHex();
+                responseBuffer.remove(0, frame.size);
+                continue;
             }
-            qCDebug(QT_MODBUS_LOW) << "(TCP client) Sent TCP ADU:" << buffer.toHex();
-            qCDebug(QT_MODBUS) << "(TCP client) Sent TCP PDU:" << request << "with tId:" <<Qt:: hex
-                << tId;
-            return true;
-        };
-
-        const int tId = transactionId();
-        if (!writeToSocket(tId, request, serverAddress))
-            return nullptr;
 
-        Q_Q(QModbusTcpClient);
-        auto reply = new QModbusReply(type, serverAddress, q);
-        const auto element = QueueElement{ reply, request, unit, m_numberOfRetries,
-            m_responseTimeoutDuration };
-        m_transactionStore.insert(tId, element);
+            const QModbusResponse responsePdu = frame.pdu<QModbusResponse>();
+            responseBuffer.remove(0, frame.size);
+            matchResponse(frame.transactionId, frame.serverAddress, responsePdu,
+                          frame.matchingChecksum);
+        }
+    }
 
-        q->connect(reply, &QObject::destroyed, q, [this, tId](QObject *) {
-            if (!m_transactionStore.contains(tId))
-                return;
-            const QueueElement element = m_transactionStore.take(tId);
-            if (element.timer)
-                element.timer->stop();
-        });
+    // Requests are written with the framing of the connection.
+    bool writeRequest(quint16 tId, const QModbusRequest &request, int address) override
+    {
+        const QByteArray buffer = m_framer->createAdu(tId, address, request);
 
-        if (element.timer) {
-            q->connect(q, &QModbusClient::timeoutChanged,
-                       element.timer.data(), QOverload<int>::of(&QTimer::setInterval));
-            QObject::connect(element.timer.data(), &QTimer::timeout, q, [this, writeToSocket, tId]() {
-                if (!m_transactionStore.contains(tId))
-                    return;
-
-                QueueElement elem = m_transactionStore.take(tId);
-                if (elem.reply.isNull())
-                    return;
-
-                if (elem.numberOfRetries > 0) {
-                    elem.numberOfRetries--;
-                    if (!writeToSocket(tId, elem.requestPdu, elem.reply->serverAddress()))
-                        return;
-                    m_transactionStore.insert(tId, elem);
-                    elem.timer->start();
-                    qCDebug(QT_MODBUS) << "(TCP client) Resend request with tId:" << Qt::hex << tId;
-                } else {
-                    qCDebug(QT_MODBUS) << "(TCP client) Timeout of request with tId:" <<Qt::hex << tId;
-                    elem.reply->setError(QModbusDevice::TimeoutError,
-                        QModbusClient::tr("Request timeout."));
-                }
-            });
-            element.timer->start();
-        } else {
-            qCWarning(QT_MODBUS) << "(TCP client) No response timeout timer for request with tId:"
-                << Qt::hex << tId << ". Expected timeout:" << m_responseTimeoutDuration;
+        int writtenBytes = m_socket->write(buffer);
+        if (writtenBytes == -1 || writtenBytes < buffer.size()) {
+            Q_Q(QModbusTcpClient);
+            qCDebug(QT_MODBUS) << "(TCP client) Cannot write request to socket.";
+            q->setError(QModbusTcpClient::tr("Could not write request to socket."),
+                        QModbusDevice::WriteError);
+            return false;
         }
-        incrementTransactionId();
-
-        return reply;
+        qCDebug(QT_MODBUS_LOW) << "(TCP client) Sent TCP ADU:" << buffer.toHex();
+        qCDebug(QT_MODBUS) << "(TCP client) Sent TCP PDU:" << request << "with tId:" <<Qt:: hex
+            << tId;
+        return true;
     }
 
     // TODO: Review once we have a transport layer in place.
@@ -200,35 +124,10 @@ public:
         return false;
     }
 
-    void cleanupTransactionStore()
-    {
-        if (m_transactionStore.isEmpty())
-            return;
-
-        qCDebug(QT_MODBUS) << "(TCP client) Cleanup of pending requests";
-
-        for (const auto &elem : std::as_const(m_transactionStore)) {
-            if (elem.reply.isNull())
-                continue;
-            elem.reply->setError(QModbusDevice::ReplyAbortedError,
-                                 QModbusClient::tr("Reply aborted due to connection closure."));
-        }
-        m_transactionStore.clear();
-    }
-
-    // This doesn't overflow, it rather "wraps around". Expected.
-    inline void incrementTransactionId() { m_transactionId++; }
-    inline int transactionId() const { return m_transactionId; }
-
     QIODevice *device() const override { return m_socket; }
 
     QTcpSocket *m_socket = nullptr;
     QByteArray responseBuffer;
-    QHash<quint16, QueueElement> m_transactionStore;
-    int mbpaHeaderSize = 7;
-
-private:   // Private to avoid using the wrong id inside the timer lambda,
-    quint16 m_transactionId = 0; // capturing 'this' will not copy the id.
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,421 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbustcpclientpool.h"
+#include "qmodbustcpclientpool_p.h"
+
+#include <QtCore/qurl.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QModbusTcpClientPool
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QModbusTcpClientPool class is a Modbus TCP client that spreads
+    its requests across several connections to the same server.
+
+    A QModbusTcpClient sends all requests through a single TCP connection.
+    Many servers, and especially gateways in front of many units, accept
+    several concurrent connections, and process the requests of different
+    connections in parallel. QModbusTcpClientPool keeps \l connectionCount()
+    connections to the server at the network address and port of the
+    \l {QModbusDevice::ConnectionParameter}{connection parameters}, and writes
+    each request to the connection with the fewest requests waiting for
+    their responses.
+
+    \code
+        QModbusTcpClientPool pool;
+        pool.setConnectionParameter(QModbusDevice::NetworkAddressParameter, "192.168.0.10");
+        pool.setConnectionCount(8);
+        pool.connectDevice();
+    \endcode
+
+    The pool is connected as soon as one of its connections is established.
+    A connection that fails or is closed by the server aborts only its own
+    requests, with \l QModbusDevice::ReplyAbortedError, and is established
+    again after \l reconnectInterval(). Meanwhile, the other connections keep
+    serving the requests. If no connection is left, the pool goes back to
+    the \l QModbusDevice::ConnectingState until one of them is established
+    again.
+
+    Responses are matched with their requests by the transaction identifier,
+    therefore the pool requires the default
+    \l {QModbusDevice::MbapFraming}{MBAP framing}.
+
+    \sa QModbusTcpClient
+*/
+
+void QModbusTcpClientPoolPrivate::setupConnections()
+{
+    Q_Q(QModbusTcpClientPool);
+
+    for (const Connection &connection : m_connections) {
+        delete connection.socket;
+        delete connection.reconnectTimer;
+    }
+    m_connections.clear();
+    m_connections.resize(m_connectionCount);
+
+    for (qsizetype i = 0; i < qsizetype(m_connections.size()); ++i) {
+        Connection &connection = m_connections[i];
+        connection.socket = new QTcpSocket(q);
+        connection.reconnectTimer = new QTimer(q);
+        connection.reconnectTimer->setSingleShot(true);
+        connection.framer = QModbusFramer::create(QModbusDevice::MbapFraming,
+                                                  QModbusFramer::Responses);
+
+        QObject::connect(connection.reconnectTimer, &QTimer::timeout, q, [this, i]() {
+            connectToHost(i);
+        });
+        QObject::connect(connection.socket, &QAbstractSocket::connected, q, [this, i]() {
+            onConnected(i);
+        });
+        QObject::connect(connection.socket, &QAbstractSocket::stateChanged, q,
+                         [this, i](QAbstractSocket::SocketState state) {
+            if (state == QAbstractSocket::UnconnectedState)
+                onUnconnected(i);
+        });
+        QObject::connect(connection.socket, &QAbstractSocket::errorOccurred, q,
+                         [this, i](QAbstractSocket::SocketError /*error*/) {
+            qCWarning(QT_MODBUS) << "(TCP client pool) Connection" << i << "error:"
+                                 << m_connections[i].socket->errorString();
+        });
+        QObject::connect(connection.socket, &QIODevice::readyRead, q, [this, i]() {
+            QTcpSocket *socket = m_connections[i].socket;
+            m_connections[i].buffer += socket->read(socket->bytesAvailable());
+            processResponseBuffer(i);
+        });
+    }
+}
+
+void QModbusTcpClientPoolPrivate::connectToHost(qsizetype index)
+{
+    if (m_closing)
+        return;
+    QTcpSocket *socket = m_connections[index].socket;
+    if (socket->state() == QAbstractSocket::UnconnectedState)
+        socket->connectToHost(m_host, m_port);
+}
+
+void QModbusTcpClientPoolPrivate::onConnected(qsizetype index)
+{
+    Q_Q(QModbusTcpClientPool);
+
+    Connection &connection = m_connections[index];
+    qCDebug(QT_MODBUS) << "(TCP client pool) Connection" << index << "connected to"
+                       << connection.socket->peerAddress() << "on port"
+                       << connection.socket->peerPort();
+    connection.buffer.clear();
+    connection.framer->reset();
+    if (!m_closing)
+        q->setState(QModbusDevice::ConnectedState);
+}
+
+void QModbusTcpClientPoolPrivate::onUnconnected(qsizetype index)
+{
+    Q_Q(QModbusTcpClientPool);
+
+    qCDebug(QT_MODBUS) << "(TCP client pool) Connection" << index << "closed.";
+    Connection &connection = m_connections[index];
+    connection.buffer.clear();
+    connection.framer->reset();
+    abortTransactions(index);
+
+    if (m_closing) {
+        const bool closed = std::all_of(m_connections.cbegin(), m_connections.cend(),
+                                        [](const Connection &other) {
+            return other.socket->state() == QAbstractSocket::UnconnectedState;
+        });
+        if (closed)
+            finishClose();
+        return;
+    }
+
+    connection.reconnectTimer->start(m_reconnectInterval);
+    if (activeConnectionCount() > 0)
+        return;
+
+    // Without any connection, no request can be sent until one is established again.
+    q->setState(QModbusDevice::ConnectingState);
+    q->setError(QModbusClient::tr("TCP socket error (%1).")
+                        .arg(connection.socket->errorString()),
+                QModbusDevice::ConnectionError);
+}
+
+void QModbusTcpClientPoolPrivate::processResponseBuffer(qsizetype index)
+{
+    Connection &connection = m_connections[index];
+    while (!connection.buffer.isEmpty()) {
+        QModbusFramer::Frame frame;
+        const auto status = connection.framer->parse(connection.buffer, &frame);
+        if (status == QModbusFramer::Incomplete)
+            return;
+        if (status == QModbusFramer::Invalid) {
+            qCWarning(QT_MODBUS) << "(TCP client pool) Discarding invalid data:"
+                                 << connection.buffer.first(frame.size).toHex();
+            connection.buffer.remove(0, frame.size);
+            continue;
+        }
+
+        const QModbusResponse responsePdu = frame.pdu<QModbusResponse>();
+        connection.buffer.remove(0, frame.size);
+        matchResponse(frame.transactionId, frame.serverAddress, responsePdu,
+                      frame.matchingChecksum);
+    }
+}
+
+/*
+    Aborts the requests written to the connection. Their responses cannot
+    arrive any more, and they are not written to another connection, since
+    the server may have processed them already.
+*/
+void QModbusTcpClientPoolPrivate::abortTransactions(qsizetype index)
+{
+    QList<quint16> transactions;
+    for (auto it = m_transactionConnections.cbegin(); it != m_transactionConnections.cend(); ++it) {
+        if (it.value() == index)
+            transactions.append(it.key());
+    }
+
+    for (const quint16 tId : std::as_const(transactions)) {
+        releaseTransaction(tId);
+        if (!m_transactionStore.contains(tId))
+            continue;
+        const QueueElement element = m_transactionStore.take(tId);
+        if (element.timer)
+            element.timer->stop();
+        if (element.reply.isNull())
+            continue;
+        element.reply->setError(QModbusDevice::ReplyAbortedError,
+                                QModbusClient::tr("Reply aborted due to connection closure."));
+    }
+}
+
+void QModbusTcpClientPoolPrivate::finishClose()
+{
+    Q_Q(QModbusTcpClientPool);
+
+    m_closing = false;
+    q->setState(QModbusDevice::UnconnectedState);
+    cleanupTransactionStore();
+}
+
+qsizetype QModbusTcpClientPoolPrivate::leastBusyConnection()
+{
+    const qsizetype count = qsizetype(m_connections.size());
+    qsizetype result = -1;
+    for (qsizetype i = 0; i < count; ++i) {
+        const qsizetype index = (m_nextConnection + i) % count;
+        const Connection &connection = m_connections[index];
+        if (connection.socket->state() != QAbstractSocket::ConnectedState)
+            continue;
+        if (result < 0 || connection.inFlight < m_connections[result].inFlight)
+            result = index;
+    }
+    if (result >= 0)
+        m_nextConnection = (result + 1) % count;
+    return result;
+}
+
+int QModbusTcpClientPoolPrivate::activeConnectionCount() const
+{
+    return int(std::count_if(m_connections.cbegin(), m_connections.cend(),
+                             [](const Connection &connection) {
+        return connection.socket->state() == QAbstractSocket::ConnectedState;
+    }));
+}
+
+bool QModbusTcpClientPoolPrivate::writeRequest(quint16 tId, const QModbusRequest &request,
+                                               int address)
+{
+    Q_Q(QModbusTcpClientPool);
+
+    const qsizetype index = leastBusyConnection();
+    if (index < 0) {
+        qCDebug(QT_MODBUS) << "(TCP client pool) No connection to write request to.";
+        q->setError(QModbusTcpClientPool::tr("No connection of the pool is established."),
+                    QModbusDevice::WriteError);
+        return false;
+    }
+
+    Connection &connection = m_connections[index];
+    const QByteArray buffer = connection.framer->createAdu(tId, address, request);
+    const qint64 writtenBytes = connection.socket->write(buffer);
+    if (writtenBytes == -1 || writtenBytes < buffer.size()) {
+        qCDebug(QT_MODBUS) << "(TCP client pool) Cannot write request to connection" << index;
+        q->setError(QModbusTcpClientPool::tr("Could not write request to socket."),
+                    QModbusDevice::WriteError);
+        return false;
+    }
+    qCDebug(QT_MODBUS_LOW) << "(TCP client pool) Sent TCP ADU:" << buffer.toHex();
+    qCDebug(QT_MODBUS) << "(TCP client pool) Sent TCP PDU:" << request << "with tId:" << Qt::hex
+        << tId << "on connection" << Qt::dec << index;
+
+    ++connection.inFlight;
+    m_transactionConnections.insert(tId, index);
+    return true;
+}
+
+void QModbusTcpClientPoolPrivate::releaseTransaction(quint16 tId)
+{
+    const auto it = m_transactionConnections.constFind(tId);
+    if (it == m_transactionConnections.cend())
+        return;
+    --m_connections[it.value()].inFlight;
+    m_transactionConnections.erase(it);
+}
+
+/*!
+    Constructs a QModbusTcpClientPool with the specified \a parent.
+*/
+QModbusTcpClientPool::QModbusTcpClientPool(QObject *parent)
+    : QModbusClient(*new QModbusTcpClientPoolPrivate, parent)
+{
+}
+
+/*!
+    Destroys the QModbusTcpClientPool instance.
+*/
+QModbusTcpClientPool::~QModbusTcpClientPool()
+{
+    close();
+}
+
+/*!
+    \internal
+*/
+QModbusTcpClientPool::QModbusTcpClientPool(QModbusTcpClientPoolPrivate &dd, QObject *parent)
+    : QModbusClient(dd, parent)
+{
+}
+
+/*!
+    Returns the number of connections the pool keeps to the server. The
+    default is \c 4.
+
+    \sa activeConnectionCount()
+*/
+int QModbusTcpClientPool::connectionCount() const
+{
+    Q_D(const QModbusTcpClientPool);
+    return d->m_connectionCount;
+}
+
+/*!
+    Sets the number of connections the pool keeps to the server to \a count,
+    which must be at least \c 1. The number takes effect the next time the
+    pool is connected.
+*/
+void QModbusTcpClientPool::setConnectionCount(int count)
+{
+    Q_D(QModbusTcpClientPool);
+    if (count < 1) {
+        qCWarning(QT_MODBUS) << "(TCP client pool) Invalid connection count:" << count;
+        return;
+    }
+    d->m_connectionCount = count;
+}
+
+/*!
+    Returns the number of connections that are established at the moment.
+
+    \sa connectionCount()
+*/
+int QModbusTcpClientPool::activeConnectionCount() const
+{
+    Q_D(const QModbusTcpClientPool);
+    return d->activeConnectionCount();
+}
+
+/*!
+    Returns the time in milliseconds after which a failed connection is
+    established again. The default is \c 1000 milliseconds.
+*/
+int QModbusTcpClientPool::reconnectInterval() const
+{
+    Q_D(const QModbusTcpClientPool);
+    return d->m_reconnectInterval;
+}
+
+/*!
+    Sets the time after which a failed connection is established again to
+    \a milliseconds.
+*/
+void QModbusTcpClientPool::setReconnectInterval(int milliseconds)
+{
+    Q_D(QModbusTcpClientPool);
+    d->m_reconnectInterval = qMax(0, milliseconds);
+}
+
+/*!
+     \reimp
+*/
+bool QModbusTcpClientPool::open()
+{
+    if (state() == QModbusDevice::ConnectedState)
+        return true;
+
+    Q_D(QModbusTcpClientPool);
+    if (d->m_closing)
+        return false;
+
+    const QUrl url = QUrl::fromUserInput(d->m_networkAddress + QStringLiteral(":")
+        + QString::number(d->m_networkPort));
+
+    if (!url.isValid()) {
+        setError(tr("Invalid connection settings for TCP communication specified."),
+            QModbusDevice::ConnectionError);
+        qCWarning(QT_MODBUS) << "(TCP client pool) Invalid host:" << url.host() << "or port:"
+            << url.port();
+        return false;
+    }
+    if (d->framing() != QModbusDevice::MbapFraming) {
+        setError(tr("A TCP client pool requires the MBAP framing."),
+                 QModbusDevice::ConnectionError);
+        return false;
+    }
+
+    d->m_host = url.host();
+    d->m_port = quint16(url.port());
+    d->m_framer = QModbusFramer::create(QModbusDevice::MbapFraming, QModbusFramer::Responses);
+    if (qsizetype(d->m_connections.size()) != d->m_connectionCount)
+        d->setupConnections();
+    for (qsizetype i = 0; i < qsizetype(d->m_connections.size()); ++i)
+        d->connectToHost(i);
+
+    return true;
+}
+
+/*!
+     \reimp
+*/
+void QModbusTcpClientPool::close()
+{
+    if (state() == QModbusDevice::UnconnectedState)
+        return;
+
+    Q_D(QModbusTcpClientPool);
+    if (d->m_closing)
+        return;
+
+    d->m_closing = true;
+    bool closed = true;
+    for (const QModbusTcpClientPoolPrivate::Connection &connection : d->m_connections) {
+        connection.reconnectTimer->stop();
+        if (connection.socket->state() == QAbstractSocket::ConnectedState) {
+            // Unconnected once the pending requests are written.
+            connection.socket->disconnectFromHost();
+            closed = closed && connection.socket->state() == QAbstractSocket::UnconnectedState;
+        } else {
+            connection.socket->abort();
+        }
+    }
+    if (closed && d->m_closing)
+        d->finishClose();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,39 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSTCPCLIENTPOOL_H
+#define QMODBUSTCPCLIENTPOOL_H
+
+#include <QtSerialBus/qmodbusclient.h>
+
+QT_BEGIN_NAMESPACE
+
+class QModbusTcpClientPoolPrivate;
+
+class Q_SERIALBUS_EXPORT QModbusTcpClientPool : public QModbusClient
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QModbusTcpClientPool)
+
+public:
+    explicit QModbusTcpClientPool(QObject *parent = nullptr);
+    ~QModbusTcpClientPool();
+
+    int connectionCount() const;
+    void setConnectionCount(int count);
+
+    int activeConnectionCount() const;
+
+    int reconnectInterval() const;
+    void setReconnectInterval(int milliseconds);
+
+protected:
+    QModbusTcpClientPool(QModbusTcpClientPoolPrivate &dd, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSTCPCLIENTPOOL_H
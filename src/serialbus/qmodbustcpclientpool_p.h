@@ -0,0 +1,76 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSTCPCLIENTPOOL_P_H
+#define QMODBUSTCPCLIENTPOOL_P_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qtimer.h>
+#include <QtNetwork/qtcpsocket.h>
+#include <QtSerialBus/qmodbustcpclientpool.h>
+
+#include "private/qmodbusnetworkclient_p.h"
+
+#include <memory>
+#include <vector>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+class QModbusTcpClientPoolPrivate : public QModbusNetworkClientPrivate
+{
+    Q_DECLARE_PUBLIC(QModbusTcpClientPool)
+
+public:
+    // One TCP connection of the pool. The transaction identifiers are unique
+    // across the pool, so a response is matched no matter which connection
+    // it arrives on.
+    struct Connection
+    {
+        QTcpSocket *socket = nullptr;
+        QTimer *reconnectTimer = nullptr;
+        QByteArray buffer;
+        std::unique_ptr<QModbusFramer> framer;
+        int inFlight = 0;
+    };
+
+    void setupConnections();
+    void connectToHost(qsizetype index);
+    void onConnected(qsizetype index);
+    void onUnconnected(qsizetype index);
+    void processResponseBuffer(qsizetype index);
+    void abortTransactions(qsizetype index);
+    void finishClose();
+    qsizetype leastBusyConnection();
+    int activeConnectionCount() const;
+
+    bool writeRequest(quint16 tId, const QModbusRequest &request, int address) override;
+    void releaseTransaction(quint16 tId) override;
+    bool isOpen() const override { return activeConnectionCount() > 0; }
+
+    std::vector<Connection> m_connections;
+    // the connection each open request was written to
+    QHash<quint16, qsizetype> m_transactionConnections;
+    QString m_host;
+    quint16 m_port = 0;
+    int m_connectionCount = 4;
+    int m_reconnectInterval = 1000;
+    // where the search for the least busy connection starts, so that idle
+    // connections take turns
+    qsizetype m_nextConnection = 0;
+    bool m_closing = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSTCPCLIENTPOOL_P_H
@@ -22,6 +22,11 @@ QT_BEGIN_NAMESPACE
 
     Modbus TCP networks can have multiple servers. Servers are read/written by
     a client device represented by \l QModbusTcpClient.
+
+    The messages are framed with the Modbus Application Protocol header by
+    default. The \l QModbusDevice::FramingParameter selects another framing,
+    e.g. to serve clients that send RTU frames over TCP. Such requests to the
+    broadcast address \c 0 are processed, but not answered.
 */
 
 /*!
@@ -13,6 +13,7 @@
 #include <QtNetwork/qtcpsocket.h>
 #include <QtSerialBus/qmodbustcpserver.h>
 
+#include <private/qmodbusframer_p.h>
 #include <private/qmodbusserver_p.h>
 
 #include <memory>
@@ -99,68 +100,73 @@ public:
                 return;
             }
 
-            auto buffer = new QByteArray();
+            // Each connection has its own framer, which keeps the parsing state of
+            // the connection's buffer.
+            auto connection = new Connection{ {}, QModbusFramer::create(
+                    framing(), QModbusFramer::Requests) };
 
-            QObject::connect(socket, &QObject::destroyed, socket, [buffer]() {
-                // cleanup buffer
-                delete buffer;
+            QObject::connect(socket, &QObject::destroyed, socket, [connection]() {
+                // cleanup connection
+                delete connection;
             });
             QObject::connect(socket, &QTcpSocket::disconnected, q, [socket, this]() {
                 Q_Q(QModbusTcpServer);
                 emit q->modbusClientDisconnected(socket);
                 socket->deleteLater();
             });
-            QObject::connect(socket, &QTcpSocket::readyRead, q, [buffer, socket, this]() {
+            QObject::connect(socket, &QTcpSocket::readyRead, q, [connection, socket, this]() {
                 if (!socket)
                     return;
 
+                QByteArray *buffer = &connection->buffer;
+                QModbusFramer *framer = connection->framer.get();
                 buffer->append(socket->readAll());
                 while (!buffer->isEmpty()) {
                     qCDebug(QT_MODBUS_LOW).noquote() << "(TCP server) Read buffer: 0x"
                         + buffer->toHex();
 
-                    if (buffer->size() < mbpaHeaderSize) {
-                        qCDebug(QT_MODBUS) << "(TCP server) MBPA header too short. Waiting for more data.";
+                    QModbusFramer::Frame frame;
+                    const auto status = framer->parse(*buffer, &frame);
+                    if (status == QModbusFramer::Incomplete) {
+                        qCDebug(QT_MODBUS) << "(TCP server) ADU too short. Waiting for more data.";
                         return;
                     }
+                    if (status == QModbusFramer::Invalid) {
+                        qCWarning(QT_MODBUS) << "(TCP server) Discarding invalid data:"
+                                             << buffer->first(frame.size).toHex();
+                        buffer->remove(0, frame.size);
+                        continue;
+                    }
 
-                    quint8 unitId;
-                    quint16 transactionId, bytesPdu, protocolId;
-                    QDataStream input(*buffer);
-                    input >> transactionId >> protocolId >> bytesPdu >> unitId;
-
-                    qCDebug(QT_MODBUS_LOW) << "(TCP server) Request MBPA:" << "Transaction Id:"
-                        << Qt::hex << transactionId << "Protocol Id:" << protocolId << "PDU bytes:"
-                        << bytesPdu << "Unit Id:" << unitId;
+                    const quint16 transactionId = quint16(frame.transactionId);
+                    const quint8 unitId = quint8(frame.serverAddress);
+                    const bool matchingChecksum = frame.matchingChecksum;
+                    const QModbusRequest request = frame.pdu<QModbusRequest>();
+                    buffer->remove(0, frame.size);
 
-                    // The length field is the byte count of the following fields, including the Unit
-                    // Identifier and the PDU, so we remove on byte.
-                    bytesPdu--;
+                    qCDebug(QT_MODBUS_LOW) << "(TCP server) Request ADU:" << "Transaction Id:"
+                        << Qt::hex << frame.transactionId << "Unit Id:" << unitId;
 
-                    const quint16 current = mbpaHeaderSize + bytesPdu;
-                    if (buffer->size() < current) {
-                        qCDebug(QT_MODBUS) << "(TCP server) PDU too short. Waiting for more data";
-                        return;
+                    if (!matchingChecksum) {
+                        qCWarning(QT_MODBUS) << "(TCP server) Discarding request with wrong "
+                            "checksum";
+                        incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+                        continue;
                     }
 
-                    QModbusRequest request;
-                    input >> request;
-
-                    buffer->remove(0, current);
-
-                    if (!matchingServerAddress(unitId))
+                    // Serial framings have no transaction, but a broadcast address,
+                    // which is answered by no server.
+                    const bool broadcast = !framer->hasTransactionId() && unitId == 0;
+                    if (!broadcast && !matchingServerAddress(unitId))
                         continue;
 
                     qCDebug(QT_MODBUS) << "(TCP server) Request PDU:" << request;
                     const QModbusResponse response = forwardProcessRequest(request);
                     qCDebug(QT_MODBUS) << "(TCP server) Response PDU:" << response;
+                    if (broadcast)
+                        continue;
 
-                    QByteArray result;
-                    QDataStream output(&result, QIODevice::WriteOnly);
-                    // The length field is the byte count of the following fields, including the Unit
-                    // Identifier and PDU fields, so we add one byte to the response size.
-                    output << transactionId << protocolId << quint16(response.size() + 1)
-                           << unitId << response;
+                    const QByteArray result = framer->createAdu(transactionId, unitId, response);
 
                     if (!socket->isOpen()) {
                         qCDebug(QT_MODBUS) << "(TCP server) Requesting socket has closed.";
@@ -188,11 +194,16 @@ public:
         });
     }
 
+    struct Connection
+    {
+        QByteArray buffer;
+        std::unique_ptr<QModbusFramer> framer;
+    };
+
     QTcpServer *m_tcpServer { nullptr };
 
     std::unique_ptr<QModbusTcpConnectionObserver> m_observer;
 
-    static const qint8 mbpaHeaderSize = 7;
     static const qint16 maxBytesModbusADU = 260;
 };
 
@@ -0,0 +1,105 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusudpclient.h"
+#include "qmodbusudpclient_p.h"
+
+#include <QtCore/qurl.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QModbusUdpClient
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QModbusUdpClient class is the interface class for Modbus UDP client device.
+
+    QModbusUdpClient sends Modbus requests in UDP datagrams, one ADU per
+    datagram. Like QModbusTcpClient, it frames the messages with the Modbus
+    Application Protocol header by default, and matches the responses with
+    their requests by the transaction identifier. Other framings can be
+    selected with the \l QModbusDevice::FramingParameter.
+
+    Without a connection to set up and keep, UDP suits many short polls of
+    devices on a local network. Since datagrams may be lost, the
+    \l {QModbusClient::numberOfRetries()}{retries} of a request resend it
+    once its response timed out.
+
+    The requests sent in a row are collected, and written together once the
+    control returns to the event loop. On Linux, the datagrams are sent and
+    received in batches, with a single system call for many datagrams.
+
+    \sa QModbusUdpServer, QModbusTcpClient
+*/
+
+/*!
+    Constructs a QModbusUdpClient with the specified \a parent.
+*/
+QModbusUdpClient::QModbusUdpClient(QObject *parent)
+    : QModbusClient(*new QModbusUdpClientPrivate, parent)
+{
+    Q_D(QModbusUdpClient);
+    d->setupUdpSocket();
+}
+
+/*!
+    Destroys the QModbusUdpClient instance.
+*/
+QModbusUdpClient::~QModbusUdpClient()
+{
+    close();
+}
+
+/*!
+    \internal
+*/
+QModbusUdpClient::QModbusUdpClient(QModbusUdpClientPrivate &dd, QObject *parent)
+    : QModbusClient(dd, parent)
+{
+    Q_D(QModbusUdpClient);
+    d->setupUdpSocket();
+}
+
+/*!
+     \reimp
+*/
+bool QModbusUdpClient::open()
+{
+    if (state() == QModbusDevice::ConnectedState)
+        return true;
+
+    Q_D(QModbusUdpClient);
+    if (d->m_socket->state() != QAbstractSocket::UnconnectedState)
+        return false;
+
+    const QUrl url = QUrl::fromUserInput(d->m_networkAddress + QStringLiteral(":")
+        + QString::number(d->m_networkPort));
+
+    if (!url.isValid()) {
+        setError(tr("Invalid connection settings for UDP communication specified."),
+            QModbusDevice::ConnectionError);
+        qCWarning(QT_MODBUS) << "(UDP client) Invalid host:" << url.host() << "or port:"
+            << url.port();
+        return false;
+    }
+
+    d->m_framer = QModbusFramer::create(d->framing(), QModbusFramer::Responses);
+    d->m_socket->connectToHost(url.host(), url.port());
+
+    return true;
+}
+
+/*!
+     \reimp
+*/
+void QModbusUdpClient::close()
+{
+    if (state() == QModbusDevice::UnconnectedState)
+        return;
+
+    Q_D(QModbusUdpClient);
+    d->m_socket->disconnectFromHost();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,31 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSUDPCLIENT_H
+#define QMODBUSUDPCLIENT_H
+
+#include <QtSerialBus/qmodbusclient.h>
+
+QT_BEGIN_NAMESPACE
+
+class QModbusUdpClientPrivate;
+
+class Q_SERIALBUS_EXPORT QModbusUdpClient : public QModbusClient
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QModbusUdpClient)
+
+public:
+    explicit QModbusUdpClient(QObject *parent = nullptr);
+    ~QModbusUdpClient();
+
+protected:
+    QModbusUdpClient(QModbusUdpClientPrivate &dd, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSUDPCLIENT_H
@@ -0,0 +1,150 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSUDPCLIENT_P_H
+#define QMODBUSUDPCLIENT_P_H
+
+#include <QtCore/qloggingcategory.h>
+#include <QtNetwork/qudpsocket.h>
+#include <QtSerialBus/qmodbusudpclient.h>
+
+#include "private/qmodbusdatagrambatch_p.h"
+#include "private/qmodbusnetworkclient_p.h"
+
+#include <optional>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
+
+class QModbusUdpClientPrivate : public QModbusNetworkClientPrivate
+{
+    Q_DECLARE_PUBLIC(QModbusUdpClient)
+
+public:
+    void setupUdpSocket()
+    {
+        Q_Q(QModbusUdpClient);
+
+        m_socket = new QUdpSocket(q);
+        m_batch.emplace(m_socket);
+
+        // A UDP socket is connected as soon as the host name is resolved; it
+        // only sets the peer of the datagrams sent and received.
+        QObject::connect(m_socket, &QAbstractSocket::connected, q, [this]() {
+            qCDebug(QT_MODBUS) << "(UDP client) Connected to" << m_socket->peerAddress()
+                               << "on port" << m_socket->peerPort();
+            Q_Q(QModbusUdpClient);
+            q->setState(QModbusDevice::ConnectedState);
+        });
+
+        QObject::connect(m_socket, &QAbstractSocket::disconnected, q, [this]() {
+            qCDebug(QT_MODBUS) << "(UDP client) Connection closed.";
+            Q_Q(QModbusUdpClient);
+            m_pendingRequests.clear();
+            q->setState(QModbusDevice::UnconnectedState);
+            cleanupTransactionStore();
+        });
+
+        QObject::connect(m_socket, &QAbstractSocket::errorOccurred, q,
+                         [this](QAbstractSocket::SocketError /*error*/)
+        {
+            Q_Q(QModbusUdpClient);
+
+            if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+                m_pendingRequests.clear();
+                cleanupTransactionStore();
+                q->setState(QModbusDevice::UnconnectedState);
+            }
+            q->setError(QModbusClient::tr("UDP socket error (%1).").arg(m_socket->errorString()),
+                        QModbusDevice::ConnectionError);
+        });
+
+        QObject::connect(m_socket, &QIODevice::readyRead, q, [this]() {
+            QList<QModbusDatagramBatch::Datagram> datagrams;
+            m_batch->receive(&datagrams);
+            processDatagrams(datagrams);
+        });
+    }
+
+    // Each datagram carries exactly one ADU.
+    void processDatagrams(const QList<QModbusDatagramBatch::Datagram> &datagrams)
+    {
+        for (const QModbusDatagramBatch::Datagram &datagram : datagrams) {
+            qCDebug(QT_MODBUS_LOW) << "(UDP client) Response datagram:" << datagram.data.toHex();
+
+            QModbusFramer::Frame frame;
+            m_framer->reset();
+            if (m_framer->parse(datagram.data, &frame) != QModbusFramer::Complete
+                    || frame.size != datagram.data.size()) {
+                qCWarning(QT_MODBUS) << "(UDP client) Discarding invalid datagram:"
+                                     << datagram.data.toHex();
+                continue;
+            }
+            matchResponse(frame.transactionId, frame.serverAddress,
+                          frame.pdu<QModbusResponse>(), frame.matchingChecksum);
+        }
+    }
+
+    // The requests are collected, and sent together once the control returns
+    // to the event loop. Requests sent in a row, e.g. when polling many
+    // registers, then share the system calls.
+    bool writeRequest(quint16 tId, const QModbusRequest &request, int address) override
+    {
+        if (m_pendingRequests.isEmpty()) {
+            Q_Q(QModbusUdpClient);
+            QMetaObject::invokeMethod(q, [this]() { flushRequests(); }, Qt::QueuedConnection);
+        }
+        m_pendingRequests.append({ m_framer->createAdu(tId, address, request) });
+        qCDebug(QT_MODBUS) << "(UDP client) Queued UDP PDU:" << request << "with tId:" << Qt::hex
+            << tId;
+        return true;
+    }
+
+    void flushRequests()
+    {
+        if (m_pendingRequests.isEmpty())
+            return;
+
+        const qsizetype sent = m_batch->send(m_pendingRequests);
+        qCDebug(QT_MODBUS_LOW) << "(UDP client) Sent" << sent << "of" << m_pendingRequests.size()
+                               << "datagrams";
+        if (sent < m_pendingRequests.size()) {
+            // The unsent requests time out, and are retried.
+            Q_Q(QModbusUdpClient);
+            qCDebug(QT_MODBUS) << "(UDP client) Cannot write requests to socket.";
+            q->setError(QModbusUdpClient::tr("Could not write request to socket."),
+                        QModbusDevice::WriteError);
+        }
+        m_pendingRequests.clear();
+    }
+
+    bool isOpen() const override
+    {
+        if (m_socket)
+            return m_socket->isOpen();
+        return false;
+    }
+
+    QIODevice *device() const override { return m_socket; }
+
+    QUdpSocket *m_socket = nullptr;
+    std::optional<QModbusDatagramBatch> m_batch;
+    QList<QModbusDatagramBatch::Datagram> m_pendingRequests;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSUDPCLIENT_P_H
@@ -0,0 +1,146 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmodbusudpserver.h"
+#include "qmodbusudpserver_p.h"
+
+#include <QtCore/qurl.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QModbusUdpServer
+    \inmodule QtSerialBus
+    \since 6.7
+
+    \brief The QModbusUdpServer class represents a Modbus server that uses a
+    UDP socket for its communication with the Modbus clients.
+
+    QModbusUdpServer answers the requests of any number of
+    \l {QModbusUdpClient}{Modbus UDP clients} on a single socket, without
+    keeping state per client. Each request arrives in a datagram of its own,
+    and its response is sent to the sender of the request.
+
+    The messages are framed with the Modbus Application Protocol header by
+    default. The \l QModbusDevice::FramingParameter selects another framing.
+    Such requests to the broadcast address \c 0 are processed, but not
+    answered.
+
+    The responses to the requests received at once are sent together. On
+    Linux, the datagrams are sent and received in batches, with a single
+    system call for many datagrams.
+
+    \sa QModbusUdpClient, QModbusTcpServer
+*/
+
+/*!
+    Constructs a QModbusUdpServer with the specified \a parent. The
+    \l serverAddress preset is \c 255.
+*/
+QModbusUdpServer::QModbusUdpServer(QObject *parent)
+    : QModbusServer(*new QModbusUdpServerPrivate, parent)
+{
+    Q_D(QModbusUdpServer);
+    d->setupUdpSocket();
+    setServerAddress(0xff);
+}
+
+/*!
+    Destroys the QModbusUdpServer instance.
+*/
+QModbusUdpServer::~QModbusUdpServer()
+{
+    close();
+}
+
+/*!
+    \internal
+*/
+QModbusUdpServer::QModbusUdpServer(QModbusUdpServerPrivate &dd, QObject *parent)
+    : QModbusServer(dd, parent)
+{
+    Q_D(QModbusUdpServer);
+    d->setupUdpSocket();
+}
+
+/*!
+    \reimp
+*/
+bool QModbusUdpServer::open()
+{
+    if (state() == QModbusDevice::ConnectedState)
+        return true;
+
+    Q_D(QModbusUdpServer);
+    if (d->m_socket->state() != QAbstractSocket::UnconnectedState)
+        return false;
+
+    const QUrl url = QUrl::fromUserInput(d->m_networkAddress + QStringLiteral(":")
+        + QString::number(d->m_networkPort));
+
+    if (!url.isValid()) {
+        setError(tr("Invalid connection settings for UDP communication specified."),
+            QModbusDevice::ConnectionError);
+        qCWarning(QT_MODBUS) << "(UDP server) Invalid host:" << url.host() << "or port:"
+            << url.port();
+        return false;
+    }
+
+    d->m_framer = QModbusFramer::create(d->framing(), QModbusFramer::Requests);
+    if (d->m_socket->bind(QHostAddress(url.host()), quint16(url.port())))
+        setState(QModbusDevice::ConnectedState);
+    else
+        setError(d->m_socket->errorString(), QModbusDevice::ConnectionError);
+
+    return state() == QModbusDevice::ConnectedState;
+}
+
+/*!
+    \reimp
+*/
+void QModbusUdpServer::close()
+{
+    if (state() == QModbusDevice::UnconnectedState)
+        return;
+
+    Q_D(QModbusUdpServer);
+    d->m_socket->close();
+    setState(QModbusDevice::UnconnectedState);
+}
+
+/*!
+    \reimp
+
+    Processes the Modbus client request specified by \a request and returns a
+    Modbus response.
+
+    As for \l QModbusTcpServer, the following Modbus function codes are
+    filtered out as they are serial line only according to the Modbus
+    Application Protocol Specification 1.1b:
+    \list
+        \li \l QModbusRequest::ReadExceptionStatus
+        \li \l QModbusRequest::Diagnostics
+        \li \l QModbusRequest::GetCommEventCounter
+        \li \l QModbusRequest::GetCommEventLog
+        \li \l QModbusRequest::ReportServerId
+    \endlist
+    A request to the UDP server will be answered with a Modbus exception
+    response with the exception code QModbusExceptionResponse::IllegalFunction.
+*/
+QModbusResponse QModbusUdpServer::processRequest(const QModbusPdu &request)
+{
+    switch (request.functionCode()) {
+    case QModbusRequest::ReadExceptionStatus:
+    case QModbusRequest::Diagnostics:
+    case QModbusRequest::GetCommEventCounter:
+    case QModbusRequest::GetCommEventLog:
+    case QModbusRequest::ReportServerId:
+        return QModbusExceptionResponse(request.functionCode(),
+            QModbusExceptionResponse::IllegalFunction);
+    default:
+        break;
+    }
+    return QModbusServer::processRequest(request);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,34 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSUDPSERVER_H
+#define QMODBUSUDPSERVER_H
+
+#include <QtSerialBus/qmodbuspdu.h>
+#include <QtSerialBus/qmodbusserver.h>
+
+QT_BEGIN_NAMESPACE
+
+class QModbusUdpServerPrivate;
+
+class Q_SERIALBUS_EXPORT QModbusUdpServer : public QModbusServer
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QModbusUdpServer)
+
+public:
+    explicit QModbusUdpServer(QObject *parent = nullptr);
+    ~QModbusUdpServer();
+
+protected:
+    QModbusUdpServer(QModbusUdpServerPrivate &dd, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+
+    QModbusResponse processRequest(const QModbusPdu &request) override;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSUDPSERVER_H
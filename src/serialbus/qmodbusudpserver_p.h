@@ -0,0 +1,136 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMODBUSUDPSERVER_P_H
+#define QMODBUSUDPSERVER_P_H
+
+#include <QtCore/qloggingcategory.h>
+#include <QtNetwork/qudpsocket.h>
+#include <QtSerialBus/qmodbusudpserver.h>
+
+#include <private/qmodbusdatagrambatch_p.h>
+#include <private/qmodbusframer_p.h>
+#include <private/qmodbusserver_p.h>
+
+#include <memory>
+#include <optional>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS)
+Q_DECLARE_LOGGING_CATEGORY(QT_MODBUS_LOW)
+
+class QModbusUdpServerPrivate : public QModbusServerPrivate
+{
+    Q_DECLARE_PUBLIC(QModbusUdpServer)
+
+public:
+    void setupUdpSocket()
+    {
+        Q_Q(QModbusUdpServer);
+
+        m_socket = new QUdpSocket(q);
+        m_batch.emplace(m_socket);
+
+        QObject::connect(m_socket, &QIODevice::readyRead, q, [this]() {
+            QList<QModbusDatagramBatch::Datagram> datagrams;
+            m_batch->receive(&datagrams);
+            processDatagrams(datagrams);
+        });
+
+        QObject::connect(m_socket, &QAbstractSocket::errorOccurred, q,
+                         [this](QAbstractSocket::SocketError /*error*/) {
+            Q_Q(QModbusUdpServer);
+
+            qCWarning(QT_MODBUS) << "(UDP server) Socket error:" << m_socket->errorString();
+            q->setError(m_socket->errorString(), QModbusDevice::ConnectionError);
+        });
+    }
+
+    // Each datagram carries exactly one ADU. The responses to all datagrams
+    // received at once are sent together.
+    void processDatagrams(const QList<QModbusDatagramBatch::Datagram> &datagrams)
+    {
+        Q_Q(QModbusUdpServer);
+
+        m_responses.clear();
+        for (const QModbusDatagramBatch::Datagram &datagram : datagrams) {
+            qCDebug(QT_MODBUS_LOW) << "(UDP server) Request datagram from" << datagram.address
+                                   << datagram.port << ":" << datagram.data.toHex();
+
+            QModbusFramer::Frame frame;
+            m_framer->reset();
+            if (m_framer->parse(datagram.data, &frame) != QModbusFramer::Complete
+                    || frame.size != datagram.data.size()) {
+                qCWarning(QT_MODBUS) << "(UDP server) Discarding invalid datagram:"
+                                     << datagram.data.toHex();
+                incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+                continue;
+            }
+            if (!frame.matchingChecksum) {
+                qCWarning(QT_MODBUS) << "(UDP server) Discarding request with wrong checksum";
+                incrementCounter(QModbusServerPrivate::Counter::BusCommunicationError);
+                continue;
+            }
+
+            const quint8 unitId = quint8(frame.serverAddress);
+            // Serial framings have no transaction, but a broadcast address,
+            // which is answered by no server.
+            const bool broadcast = !m_framer->hasTransactionId() && unitId == 0;
+            if (!broadcast && q->serverAddress() != unitId) {
+                qCDebug(QT_MODBUS) << "(UDP server) Wrong server unit identifier address, "
+                    "expected" << q->serverAddress() << "got" << unitId;
+                continue;
+            }
+
+            const QModbusRequest request = frame.pdu<QModbusRequest>();
+            qCDebug(QT_MODBUS) << "(UDP server) Request PDU:" << request;
+            QModbusResponse response;
+            if (q->value(QModbusServer::DeviceBusy).value<quint16>() == 0xffff) {
+                // If the device is busy, send an exception response without processing.
+                incrementCounter(QModbusServerPrivate::Counter::ServerBusy);
+                response = QModbusExceptionResponse(request.functionCode(),
+                    QModbusExceptionResponse::ServerDeviceBusy);
+            } else {
+                response = q->processRequest(request);
+            }
+            qCDebug(QT_MODBUS) << "(UDP server) Response PDU:" << response;
+            if (broadcast)
+                continue;
+
+            m_responses.append({ m_framer->createAdu(quint16(frame.transactionId), unitId,
+                                                     response),
+                                 datagram.address, datagram.port });
+        }
+
+        if (m_responses.isEmpty())
+            return;
+        if (m_batch->send(m_responses) < m_responses.size()) {
+            qCDebug(QT_MODBUS) << "(UDP server) Cannot write responses to socket.";
+            q->setError(QModbusUdpServer::tr("Could not write response to client"),
+                        QModbusDevice::WriteError);
+        }
+        m_responses.clear();
+    }
+
+    QUdpSocket *m_socket = nullptr;
+    std::optional<QModbusDatagramBatch> m_batch;
+    // one framer for all clients, as every datagram is a complete frame
+    std::unique_ptr<QModbusFramer> m_framer;
+    QList<QModbusDatagramBatch::Datagram> m_responses;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMODBUSUDPSERVER_P_H
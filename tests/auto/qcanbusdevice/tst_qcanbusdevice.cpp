@@ -12,6 +12,7 @@
 #include <memory>
 
 using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
 
 Q_DECLARE_METATYPE(QCanBusDevice::Filter)
 
@@ -65,6 +66,7 @@ public:
             enqueueOutgoingFrame(data);
             QTimer::singleShot(2000, this, [this](){ triggerDelayedWrites(); });
         } else {
+            addTransmittedFrame(data);
             emit framesWritten(1);
         }
         return true;
@@ -75,6 +77,11 @@ public:
         setError(text, e);
     }
 
+    void emulateDrops(QCanBusDevice::Direction direction, quint64 count)
+    {
+        addDroppedFrames(direction, count);
+    }
+
     QString interpretErrorFrame(const QCanBusFrame &/*errorFrame*/) override
     {
         return QString();
@@ -107,7 +114,7 @@ public slots:
         if (framesToWrite() == 0)
             return;
 
-        dequeueOutgoingFrame();
+        addTransmittedFrame(dequeueOutgoingFrame());
         emit framesWritten(1);
 
         if (framesToWrite() > 0)
@@ -132,6 +139,10 @@ private slots:
     void write();
     void read();
     void readAll();
+    void readFrames();
+    void processFrames();
+    void metrics();
+    void receiveCoalescing();
     void clearInputBuffer();
     void clearOutputBuffer();
     void error();
@@ -295,6 +306,212 @@ void tst_QCanBusDevice::readAll()
     QVERIFY(!device->framesAvailable());
 }
 
+void tst_QCanBusDevice::readFrames()
+{
+    QCanBusFrame buffer[4];
+
+    device->disconnectDevice();
+    QTRY_VERIFY_WITH_TIMEOUT(device->state() == QCanBusDevice::UnconnectedState, 5000);
+
+    QCOMPARE(device->readFrames(buffer, 4), 0);
+    QCOMPARE(device->error(), QCanBusDevice::OperationError);
+
+    QVERIFY(device->connectDevice());
+    QTRY_VERIFY_WITH_TIMEOUT(device->state() == QCanBusDevice::ConnectedState, 5000);
+
+    QCOMPARE(device->readFrames(buffer, 4), 0);
+    QCOMPARE(device->error(), QCanBusDevice::NoError);
+
+    for (int i = 0; i < 6; ++i)
+        device->triggerNewFrame();
+
+    QCOMPARE(device->readFrames(buffer, 0), 0);
+    QCOMPARE(device->readFrames(nullptr, 4), 0);
+    QCOMPARE(device->framesAvailable(), 6);
+
+    QCOMPARE(device->readFrames(buffer, 4), 4);
+    QCOMPARE(device->framesAvailable(), 2);
+    for (const QCanBusFrame &frame : buffer) {
+        QVERIFY(frame.isValid());
+        QCOMPARE(frame.frameId(), 5u);
+        QCOMPARE(frame.payload(), QByteArray("FOOBAR"));
+    }
+
+    QCOMPARE(device->readFrames(buffer, 4), 2);
+    QCOMPARE(device->framesAvailable(), 0);
+    QCOMPARE(device->readFrames(buffer, 4), 0);
+}
+
+void tst_QCanBusDevice::processFrames()
+{
+    QCOMPARE(device->state(), QCanBusDevice::ConnectedState);
+    device->clear(QCanBusDevice::Input);
+
+    qsizetype calls = 0;
+    const auto countCalls = [&calls](const QCanBusFrame *, qsizetype) {
+        ++calls;
+        return qsizetype(0);
+    };
+
+    // no frames, no call
+    QCOMPARE(device->processFrames(countCalls), 0);
+    QCOMPARE(calls, 0);
+
+    for (int i = 0; i < 5; ++i)
+        device->triggerNewFrame();
+
+    // peek only
+    QCOMPARE(device->processFrames(countCalls), 0);
+    QCOMPARE(calls, 1);
+    QCOMPARE(device->framesAvailable(), 5);
+
+    // commit part of the frames
+    qsizetype seen = 0;
+    QCOMPARE(device->processFrames([&seen](const QCanBusFrame *frames, qsizetype count) {
+        seen = count;
+        for (qsizetype i = 0; i < count; ++i) {
+            if (frames[i].frameId() != 5u)
+                return qsizetype(0);
+        }
+        return qsizetype(3);
+    }), 3);
+    QCOMPARE(seen, 5);
+    QCOMPARE(device->framesAvailable(), 2);
+
+    // consuming more frames than available is limited to the available frames
+    QCOMPARE(device->processFrames([](const QCanBusFrame *, qsizetype count) {
+        return count + 10;
+    }), 2);
+    QCOMPARE(device->framesAvailable(), 0);
+}
+
+void tst_QCanBusDevice::metrics()
+{
+    device->setWriteBuffered(false);
+    QCOMPARE(device->state(), QCanBusDevice::ConnectedState);
+
+    device->clear(QCanBusDevice::Input);
+    device->resetMetrics();
+
+    QCanBusDevice::Metrics metrics = device->metrics();
+    QCOMPARE(metrics.receivedFrames, 0u);
+    QCOMPARE(metrics.receivedBytes, 0u);
+    QCOMPARE(metrics.receiveDrops, 0u);
+    QCOMPARE(metrics.receiveQueueHighWaterMark, 0);
+    QCOMPARE(metrics.receiveEnqueueTime, 0);
+    QCOMPARE(metrics.transmittedFrames, 0u);
+    QCOMPARE(metrics.transmittedBytes, 0u);
+    QCOMPARE(metrics.transmitDrops, 0u);
+    QCOMPARE(metrics.transmitQueueHighWaterMark, 0);
+
+    // the reference frame carries a payload of six bytes
+    for (int i = 0; i < 3; ++i)
+        device->triggerNewFrame();
+
+    metrics = device->metrics();
+    QCOMPARE(metrics.receivedFrames, 3u);
+    QCOMPARE(metrics.receivedBytes, 18u);
+    QCOMPARE(metrics.receiveQueueHighWaterMark, 3);
+    QVERIFY(metrics.receiveEnqueueTime >= 0);
+
+    // the high water mark is kept after the queue was drained
+    QCOMPARE(device->readAllFrames().size(), 3);
+    device->triggerNewFrame();
+    metrics = device->metrics();
+    QCOMPARE(metrics.receivedFrames, 4u);
+    QCOMPARE(metrics.receiveQueueHighWaterMark, 3);
+    QCOMPARE(device->readAllFrames().size(), 1);
+
+    device->emulateDrops(QCanBusDevice::Input, 5);
+    device->emulateDrops(QCanBusDevice::Output, 2);
+    QVERIFY(device->writeFrame(QCanBusFrame(0x123, "testData")));
+
+    metrics = device->metrics();
+    QCOMPARE(metrics.receiveDrops, 5u);
+    QCOMPARE(metrics.transmitDrops, 2u);
+    QCOMPARE(metrics.transmittedFrames, 1u);
+    QCOMPARE(metrics.transmittedBytes, 8u);
+
+    device->resetMetrics();
+    metrics = device->metrics();
+    QCOMPARE(metrics.receivedFrames, 0u);
+    QCOMPARE(metrics.receiveDrops, 0u);
+    QCOMPARE(metrics.transmittedFrames, 0u);
+    QCOMPARE(metrics.transmitDrops, 0u);
+}
+
+void tst_QCanBusDevice::receiveCoalescing()
+{
+    QCOMPARE(device->state(), QCanBusDevice::ConnectedState);
+    QCOMPARE(device->receiveCoalescingFrameCount(), 1);
+    QCOMPARE(device->receiveCoalescingLatency(), 0us);
+
+    device->clear(QCanBusDevice::Input);
+    QSignalSpy spy(device.get(), &QCanBusDevice::framesReceived);
+
+    // frame count only
+    device->setReceiveCoalescing(3);
+    QCOMPARE(device->receiveCoalescingFrameCount(), 3);
+    device->triggerNewFrame();
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 0);
+    QCOMPARE(device->framesAvailable(), 2);
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(device->framesAvailable(), 3);
+    device->clear(QCanBusDevice::Input);
+
+    // latency only
+    spy.clear();
+    device->setReceiveCoalescing(0, 20ms);
+    QCOMPARE(device->receiveCoalescingLatency(), 20ms);
+    device->triggerNewFrame();
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 0);
+    QTRY_COMPARE(spy.size(), 1);
+    QCOMPARE(device->framesAvailable(), 2);
+    device->clear(QCanBusDevice::Input);
+
+    // frame count reached before the latency
+    spy.clear();
+    device->setReceiveCoalescing(2, 10s);
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 0);
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 1);
+    device->clear(QCanBusDevice::Input);
+
+    // latency reached before the frame count
+    spy.clear();
+    device->setReceiveCoalescing(100, 20ms);
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 0);
+    QTRY_COMPARE(spy.size(), 1);
+    QTest::qWait(50);
+    QCOMPARE(spy.size(), 1);
+    device->clear(QCanBusDevice::Input);
+
+    // frames read before the latency passed are not announced any more
+    spy.clear();
+    device->triggerNewFrame();
+    device->triggerNewFrame();
+    QCOMPARE(device->readAllFrames().size(), 2);
+    QTest::qWait(50);
+    QCOMPARE(spy.size(), 0);
+
+    // invalid parameters are ignored
+    device->setReceiveCoalescing(-1, 5ms);
+    QCOMPARE(device->receiveCoalescingFrameCount(), 100);
+    QCOMPARE(device->receiveCoalescingLatency(), 20ms);
+
+    // default behavior
+    spy.clear();
+    device->setReceiveCoalescing(1);
+    device->triggerNewFrame();
+    QCOMPARE(spy.size(), 1);
+    device->clear(QCanBusDevice::Input);
+}
+
 void tst_QCanBusDevice::clearInputBuffer()
 {
     device->disconnectDevice();
@@ -17,6 +17,7 @@ private slots:
     void id();
     void payload();
     void timeStamp();
+    void preciseTimeStamp();
     void bitRateSwitch();
     void errorStateIndicator();
     void localEcho();
@@ -154,6 +155,65 @@ void tst_QCanBusFrame::timeStamp()
     QCOMPARE(timeStamp.microSeconds(), 1);
 }
 
+void tst_QCanBusFrame::preciseTimeStamp()
+{
+    QCanBusFrame frame;
+    QCOMPARE(frame.timeStampNanoSeconds(), 0);
+    QCOMPARE(frame.timeStampSource(), QCanBusFrame::TimeStampSource::Unknown);
+
+    frame.setTimeStamp(12, 345678901, QCanBusFrame::TimeStampSource::Hardware);
+    QCOMPARE(frame.timeStamp().seconds(), 12);
+    QCOMPARE(frame.timeStamp().microSeconds(), 345678);
+    QCOMPARE(frame.timeStampNanoSeconds(), 345678901);
+    QCOMPARE(frame.timeStampSource(), QCanBusFrame::TimeStampSource::Hardware);
+
+    // nanosecond overflow
+    frame.setTimeStamp(1, 2000000003, QCanBusFrame::TimeStampSource::Kernel);
+    QCOMPARE(frame.timeStamp().seconds(), 3);
+    QCOMPARE(frame.timeStamp().microSeconds(), 0);
+    QCOMPARE(frame.timeStampNanoSeconds(), 3);
+    QCOMPARE(frame.timeStampSource(), QCanBusFrame::TimeStampSource::Kernel);
+
+    // setting a microsecond timestamp drops the nanoseconds, but keeps the source
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(5, 6));
+    QCOMPARE(frame.timeStampNanoSeconds(), 6000);
+    QCOMPARE(frame.timeStampSource(), QCanBusFrame::TimeStampSource::Kernel);
+
+    frame.setTimeStampSource(QCanBusFrame::TimeStampSource::Application);
+    QCOMPARE(frame.timeStampSource(), QCanBusFrame::TimeStampSource::Application);
+
+    frame.setTimeStamp(7, 8009, QCanBusFrame::TimeStampSource::Hardware);
+    {
+        QByteArray buffer;
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        out << frame;
+
+        QDataStream in(buffer);
+        QCanBusFrame restoredFrame;
+        in >> restoredFrame;
+        QCOMPARE(restoredFrame.timeStamp().seconds(), 7);
+        QCOMPARE(restoredFrame.timeStampNanoSeconds(), 8009);
+        QCOMPARE(restoredFrame.timeStampSource(), QCanBusFrame::TimeStampSource::Hardware);
+    }
+
+    // older stream versions only carry microseconds
+    {
+        QByteArray buffer;
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_6);
+        out << frame;
+
+        QDataStream in(buffer);
+        in.setVersion(QDataStream::Qt_6_6);
+        QCanBusFrame restoredFrame;
+        in >> restoredFrame;
+        QVERIFY(in.atEnd());
+        QCOMPARE(restoredFrame.timeStamp().seconds(), 7);
+        QCOMPARE(restoredFrame.timeStampNanoSeconds(), 8000);
+        QCOMPARE(restoredFrame.timeStampSource(), QCanBusFrame::TimeStampSource::Unknown);
+    }
+}
+
 void tst_QCanBusFrame::bitRateSwitch()
 {
      QCanBusFrame frame(QCanBusFrame::DataFrame);
@@ -0,0 +1,161 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtSerialBus/qcanbusdevice.h>
+#include <QtSerialBus/qcanbusframe.h>
+#include <QtSerialBus/qcanbusreactor.h>
+
+#include <QtCore/qthread.h>
+#include <QtTest/qsignalspy.h>
+#include <QtTest/qtest.h>
+
+class tst_Backend : public QCanBusDevice
+{
+    Q_OBJECT
+public:
+    void receive(quint32 frameId, qint64 nanoSeconds)
+    {
+        QCanBusFrame frame(frameId, QByteArray("\x01", 1));
+        frame.setTimeStamp(0, nanoSeconds, QCanBusFrame::TimeStampSource::Kernel);
+        enqueueReceivedFrames({frame});
+    }
+
+    bool open() override
+    {
+        setState(QCanBusDevice::ConnectedState);
+        return true;
+    }
+
+    void close() override
+    {
+        setState(QCanBusDevice::UnconnectedState);
+    }
+
+    bool writeFrame(const QCanBusFrame &frame) override
+    {
+        writeThread = QThread::currentThread();
+        writtenFrames.append(frame);
+        emit framesWritten(1);
+        return true;
+    }
+
+    QString interpretErrorFrame(const QCanBusFrame &) override
+    {
+        return QString();
+    }
+
+    QThread *writeThread = nullptr;
+    QList<QCanBusFrame> writtenFrames;
+};
+
+class tst_QCanBusReactor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addRemoveDevice();
+    void mergedReceive();
+    void write();
+};
+
+void tst_QCanBusReactor::addRemoveDevice()
+{
+    QCanBusReactor reactor;
+    tst_Backend first;
+    tst_Backend second;
+    QObject parent;
+    tst_Backend *child = new tst_Backend;
+    child->setParent(&parent);
+
+    QTest::ignoreMessage(QtWarningMsg, "QCanBusReactor::addDevice(): Cannot add a null device.");
+    QCOMPARE(reactor.addDevice(nullptr), -1);
+    QTest::ignoreMessage(QtWarningMsg, "QCanBusReactor::addDevice(): The device must not have "
+                                       "a parent and must live in the thread of the reactor.");
+    QCOMPARE(reactor.addDevice(child), -1);
+
+    QCOMPARE(reactor.addDevice(&first), 0);
+    QCOMPARE(reactor.addDevice(&second), 1);
+    QVERIFY(first.thread() != QThread::currentThread());
+    QCOMPARE(first.thread(), second.thread());
+    QCOMPARE(reactor.device(1), &second);
+    QCOMPARE(reactor.device(2), nullptr);
+
+    QVERIFY(reactor.removeDevice(&first));
+    QCOMPARE(first.thread(), QThread::currentThread());
+    QCOMPARE(reactor.devices(), QList<QCanBusDevice *>({nullptr, &second}));
+    QTest::ignoreMessage(QtWarningMsg, "QCanBusReactor::removeDevice(): Unknown device.");
+    QVERIFY(!reactor.removeDevice(&first));
+
+    // the reactor hands remaining devices back on destruction
+    {
+        QCanBusReactor other;
+        QCOMPARE(other.addDevice(&first), 0);
+        QVERIFY(first.thread() != QThread::currentThread());
+    }
+    QCOMPARE(first.thread(), QThread::currentThread());
+}
+
+void tst_QCanBusReactor::mergedReceive()
+{
+    QCanBusReactor reactor;
+    tst_Backend first;
+    tst_Backend second;
+    QVERIFY(first.connectDevice());
+    QVERIFY(second.connectDevice());
+    QCOMPARE(reactor.addDevice(&first), 0);
+    QCOMPARE(reactor.addDevice(&second), 1);
+
+    QSignalSpy spy(&reactor, &QCanBusReactor::framesReceived);
+
+    // all frames arrive within one event loop iteration of the reactor thread
+    QMetaObject::invokeMethod(&first, [&first, &second]() {
+        first.receive(0x100, 30);
+        first.receive(0x101, 20);
+        second.receive(0x200, 10);
+    }, Qt::BlockingQueuedConnection);
+
+    QTRY_COMPARE(spy.size(), 1);
+    QCOMPARE(reactor.framesAvailable(), 3);
+
+    const QList<QCanBusReactor::Frame> frames = reactor.readAllFrames();
+    QCOMPARE(frames.size(), 3);
+    QCOMPARE(frames.at(0).channel, 1);
+    QCOMPARE(frames.at(0).frame.frameId(), 0x200u);
+    QCOMPARE(frames.at(1).channel, 0);
+    QCOMPARE(frames.at(1).frame.frameId(), 0x101u);
+    QCOMPARE(frames.at(2).channel, 0);
+    QCOMPARE(frames.at(2).frame.frameId(), 0x100u);
+
+    QCOMPARE(reactor.framesAvailable(), 0);
+    QCOMPARE(first.framesAvailable(), 0);
+    QCOMPARE(second.framesAvailable(), 0);
+
+    QVERIFY(reactor.removeDevice(&first));
+    QVERIFY(reactor.removeDevice(&second));
+}
+
+void tst_QCanBusReactor::write()
+{
+    QCanBusReactor reactor;
+    tst_Backend device;
+    QVERIFY(device.connectDevice());
+    const qsizetype channel = reactor.addDevice(&device);
+    QCOMPARE(channel, 0);
+
+    QThread *reactorThread = device.thread();
+
+    const QCanBusFrame frame(0x123, QByteArray("\xAB\xCD", 2));
+    QVERIFY(!reactor.writeFrame(1, frame));
+    QVERIFY(reactor.writeFrame(channel, frame));
+    // the write is queued in front of this call
+    QMetaObject::invokeMethod(&device, []() {}, Qt::BlockingQueuedConnection);
+
+    QVERIFY(reactor.removeDevice(&device));
+    QCOMPARE(device.writeThread, reactorThread);
+    QCOMPARE(device.writtenFrames.size(), 1);
+    QCOMPARE(device.writtenFrames.at(0).frameId(), 0x123u);
+}
+
+QTEST_MAIN(tst_QCanBusReactor)
+
+#include "tst_qcanbusreactor.moc"
@@ -8,6 +8,9 @@
 #include <QtSerialBus/QCanSignalDescription>
 #include <QtSerialBus/QCanUniqueIdDescription>
 
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qtemporaryfile.h>
+
 #include "qcanmessagedescription_helpers.h"
 #include "qcanuniqueiddescription_helpers.h"
 
@@ -27,6 +30,10 @@ private slots:
     void parseFile();
     void valueDescriptions();
     void resetState();
+    void largeData();
+    void cache();
+    void sharedStrings();
+    void lazyLoading();
 
 private:
     QString m_filesDir;
@@ -187,6 +194,44 @@ void tst_QCanDbcFileParser::parseFile_data()
                 << expectedWarnings << descriptions;
     }
 
+    {
+        messageDesc.clearSignalDescriptions();
+
+        QCanSignalDescription signalDesc;
+        signalDesc.setName("Signal0");
+        signalDesc.setDataEndian(QSysInfo::Endian::LittleEndian);
+        signalDesc.setDataFormat(QtCanBus::DataFormat::UnsignedInteger);
+        signalDesc.setDataSource(QtCanBus::DataSource::Payload);
+        signalDesc.setStartBit(0);
+        signalDesc.setBitLength(8);
+        signalDesc.setFactor(1.0);
+        signalDesc.setOffset(0.0);
+        signalDesc.setRange(0.0, 0.0);
+        signalDesc.setPhysicalUnit("unit");
+        signalDesc.setReceiver("Vector__XXX");
+        messageDesc.addSignalDescription(signalDesc);
+
+        // char strings may contain any printable character
+        signalDesc.setName("Signal4");
+        signalDesc.setStartBit(8);
+        signalDesc.setPhysicalUnit(u"\u00b0C"_s);
+        messageDesc.addSignalDescription(signalDesc);
+
+        // identifiers and numbers only consist of ASCII letters and digits
+        expectedWarnings = {
+            u"Failed to find signal description in string SG_ S\u00edgnal1 : 8|8@1+ (1,0) [0|0] \"unit\" Vector__XXX"_s,
+            u"Failed to find signal description in string SG_ Signal\u0662 : 8|8@1+ (1,0) [0|0] \"unit\" Vector__XXX"_s,
+            u"Failed to find signal description in string SG_ Signal3 : \u0668|8@1+ (1,0) [0|0] \"unit\" Vector__XXX"_s,
+        };
+
+        QList<QCanMessageDescription> descriptions { messageDesc };
+
+        QTest::addRow("non-ASCII identifiers and numbers")
+                << QStringList{ u"non_ascii_names.dbc"_s }
+                << QCanDbcFileParser::Error::None << QString()
+                << expectedWarnings << descriptions;
+    }
+
     {
         messageDesc.clearSignalDescriptions();
 
@@ -1062,6 +1107,287 @@ void tst_QCanDbcFileParser::resetState()
     QVERIFY(parser.messageValueDescriptions().isEmpty());
 }
 
+void tst_QCanDbcFileParser::largeData()
+{
+    QFETCH_GLOBAL(bool, readFromFile);
+
+    // The data is big enough to be split into several chunks, which are
+    // parsed in parallel. The warnings must still come in the order of the
+    // lines.
+    constexpr int messageCount = 4000;
+    QString data;
+    QStringList expectedWarnings;
+    QSet<QtCanBus::UniqueId> expectedUids;
+    for (int i = 0; i < messageCount; ++i) {
+        // duplicates of the first messages at the end of the later chunks
+        const uint uid = (i % 700 == 699) ? uint(i / 700) : uint(i);
+        data += "BO_ %1 Message%2: 8 Vector__XXX\n"_L1.arg(uid).arg(i);
+        if (i % 900 == 450) {
+            // no signals
+            expectedWarnings.append(u"Message description with unique id %1 is skipped "
+                                     "because it's not valid."_s.arg(uid));
+            continue;
+        }
+        data += " SG_ s0 : 0|8@1+ (1,0) [0|255] \"unit\" Vector__XXX\n"_L1;
+        if (expectedUids.contains(QtCanBus::UniqueId{uid})) {
+            expectedWarnings.append(u"Message description with unique id %1 is skipped "
+                                     "because such unique id is already used."_s.arg(uid));
+        }
+        expectedUids.insert(QtCanBus::UniqueId{uid});
+    }
+    data += "CM_ BO_ 5 \"Comment\";\n"_L1;
+    data += "CM_ BO_ %1 \"Comment\";\n"_L1.arg(messageCount);
+    expectedWarnings.append(u"Failed to find message description for unique id %1. "
+                             "Skipping string CM_ BO_ %1 \"Comment\";"_s.arg(messageCount));
+
+    QCanDbcFileParser parser;
+    QTemporaryFile file;
+    if (readFromFile) {
+        QVERIFY(file.open());
+        file.write(data.toUtf8());
+        file.close();
+        QVERIFY(parser.parse(file.fileName()));
+    } else {
+        QVERIFY(parser.parseData(data));
+    }
+
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    QCOMPARE(parser.warnings(), expectedWarnings);
+    const auto messages = parser.messageDescriptions();
+    QCOMPARE(messages.size(), expectedUids.size());
+    for (const auto &message : messages) {
+        QVERIFY(expectedUids.contains(message.uniqueId()));
+        // the first definition of a unique id wins
+        QCOMPARE(message.name(), u"Message%1"_s.arg(qToUnderlying(message.uniqueId())));
+        QCOMPARE(message.comment().isEmpty(), message.uniqueId() != QtCanBus::UniqueId{5});
+    }
+
+    if (!readFromFile)
+        return;
+
+    // all messages of the second file are duplicates
+    QVERIFY(parser.parse({ file.fileName(), file.fileName() }));
+    QCOMPARE(parser.messageDescriptions().size(), expectedUids.size());
+    const QStringList warnings = parser.warnings();
+    QCOMPARE(warnings.first(expectedWarnings.size()), expectedWarnings);
+    QCOMPARE(warnings.size(), 2 * expectedWarnings.size() + expectedUids.size());
+}
+
+static QList<QCanMessageDescription> sortedMessages(const QCanDbcFileParser &parser)
+{
+    auto messages = parser.messageDescriptions();
+    std::sort(messages.begin(), messages.end(),
+              [](const QCanMessageDescription &lhs, const QCanMessageDescription &rhs) {
+        return lhs.name() < rhs.name();
+    });
+    return messages;
+}
+
+void tst_QCanDbcFileParser::cache()
+{
+    QFETCH_GLOBAL(bool, readFromFile);
+    if (!readFromFile)
+        QSKIP("The cache is only used when parsing files");
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString dbcFile = dir.filePath(u"value_descriptions.dbc"_s);
+    const QString cacheFile = dir.filePath(u"cache"_s);
+    QVERIFY(QFile::copy(m_filesDir + u"value_descriptions.dbc"_s, dbcFile));
+    QVERIFY(QFile::setPermissions(dbcFile, QFile::ReadOwner | QFile::WriteOwner));
+
+    auto compareParsers = [&](const QCanDbcFileParser &actual,
+                              const QCanDbcFileParser &expected) {
+        QCOMPARE(actual.error(), expected.error());
+        QCOMPARE(actual.warnings(), expected.warnings());
+        QCOMPARE(actual.messageValueDescriptions(), expected.messageValueDescriptions());
+        QVERIFY(equals(sortedMessages(actual), sortedMessages(expected)));
+    };
+
+    QCanDbcFileParser reference;
+    QVERIFY(reference.parse(dbcFile));
+
+    // the first run writes the cache
+    QCanDbcFileParser parser;
+    QVERIFY(parser.cacheFileName().isEmpty());
+    parser.setCacheFileName(cacheFile);
+    QCOMPARE(parser.cacheFileName(), cacheFile);
+    QVERIFY(parser.parse(dbcFile));
+    QVERIFY(QFile::exists(cacheFile));
+    compareParsers(parser, reference);
+    if (QTest::currentTestFailed())
+        return;
+
+    // the second run reads it
+    QCanDbcFileParser cachedParser;
+    cachedParser.setCacheFileName(cacheFile);
+    QVERIFY(cachedParser.parse(dbcFile));
+    compareParsers(cachedParser, reference);
+    if (QTest::currentTestFailed())
+        return;
+
+    // a different list of files does not use the cache
+    QVERIFY(cachedParser.parse({ dbcFile, dbcFile }));
+    QCOMPARE_GT(cachedParser.warnings().size(), reference.warnings().size());
+
+    // the same contents under another name do not use the cache either
+    auto readCache = [&cacheFile]() {
+        QFile f(cacheFile);
+        return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+    };
+    QVERIFY(cachedParser.parse(dbcFile));
+    const QByteArray originalCache = readCache();
+    const QString renamedFile = dir.filePath(u"renamed.dbc"_s);
+    QVERIFY(QFile::copy(dbcFile, renamedFile));
+    QVERIFY(cachedParser.parse(renamedFile));
+    compareParsers(cachedParser, reference);
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE_NE(readCache(), originalCache);
+
+    // a modified file makes the cache stale
+    {
+        QFile f(dbcFile);
+        QVERIFY(f.open(QIODevice::Append));
+        f.write("\nCM_ BO_ 1234 \"Updated comment\";\n");
+    }
+    QVERIFY(reference.parse(dbcFile));
+    QVERIFY(cachedParser.parse(dbcFile));
+    compareParsers(cachedParser, reference);
+    if (QTest::currentTestFailed())
+        return;
+    const auto messages = cachedParser.messageDescriptions();
+    const auto updated = std::find_if(messages.cbegin(), messages.cend(), [](const auto &msg) {
+        return msg.uniqueId() == QtCanBus::UniqueId{1234};
+    });
+    QVERIFY(updated != messages.cend());
+    QCOMPARE(updated->comment(), u"Updated comment"_s);
+
+    // a corrupted cache is ignored
+    {
+        QFile f(cacheFile);
+        QVERIFY(f.open(QIODevice::ReadWrite));
+        QVERIFY(f.resize(f.size() / 2));
+    }
+    QVERIFY(cachedParser.parse(dbcFile));
+    compareParsers(cachedParser, reference);
+}
+
+void tst_QCanDbcFileParser::sharedStrings()
+{
+    const QString data = u"BO_ 1 First: 2 Node\n"
+                          " SG_ s0 : 0|8@1+ (1,0) [0|0] \"km/h\" Node\n"
+                          " SG_ s1 : 8|8@1+ (1,0) [0|0] \"km/h\" Node\n"
+                          "BO_ 2 Second: 1 Node\n"
+                          " SG_ s0 : 0|8@1+ (1,0) [0|0] \"km/h\" Node\n"
+                          "VAL_ 1 s0 0 \"Off\" 1 \"On\" ;\n"
+                          "VAL_ 2 s0 0 \"Off\" 1 \"On\" ;\n"_s;
+
+    QCanDbcFileParser parser;
+    QVERIFY(parser.parseData(data));
+    QVERIFY(parser.warnings().isEmpty());
+
+    auto messages = parser.messageDescriptions();
+    QCOMPARE(messages.size(), 2);
+    std::sort(messages.begin(), messages.end(),
+              [](const QCanMessageDescription &lhs, const QCanMessageDescription &rhs) {
+        return lhs.uniqueId() < rhs.uniqueId();
+    });
+    const auto first = messages.at(0).signalDescriptionForName(u"s0"_s);
+    const auto second = messages.at(0).signalDescriptionForName(u"s1"_s);
+    const auto third = messages.at(1).signalDescriptionForName(u"s0"_s);
+    QVERIFY(first.isValid());
+    QVERIFY(second.isValid());
+    QVERIFY(third.isValid());
+
+    // equal strings of different descriptions share their data
+    QCOMPARE(first.physicalUnit().constData(), second.physicalUnit().constData());
+    QCOMPARE(first.physicalUnit().constData(), third.physicalUnit().constData());
+    QCOMPARE(first.receiver().constData(), third.receiver().constData());
+    QCOMPARE(first.name().constData(), third.name().constData());
+    QCOMPARE(messages.at(0).transmitter().constData(), messages.at(1).transmitter().constData());
+
+    const auto values = parser.messageValueDescriptions();
+    QCOMPARE(values.value(QtCanBus::UniqueId{1}).value(u"s0"_s).value(1).constData(),
+             values.value(QtCanBus::UniqueId{2}).value(u"s0"_s).value(1).constData());
+}
+
+void tst_QCanDbcFileParser::lazyLoading()
+{
+    QFETCH_GLOBAL(bool, readFromFile);
+
+    const QString fileName = m_filesDir + u"value_descriptions.dbc"_s;
+    QCanDbcFileParser reference;
+    QVERIFY(parseHelper(&reference, fileName, readFromFile));
+
+    QCanDbcFileParser parser;
+    QVERIFY(!parser.lazyLoading());
+    parser.setLazyLoading(true);
+    QVERIFY(parser.lazyLoading());
+    QVERIFY(parseHelper(&parser, fileName, readFromFile));
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    // The value description for an unknown message is detected while
+    // indexing. The other problems are logged once the message is parsed.
+    QCOMPARE(parser.warnings(), reference.warnings().first(1));
+
+    const auto provider = parser.messageDescriptionProvider();
+    QVERIFY(!provider(QtCanBus::UniqueId{1236}).isValid());
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(u"Failed to find signal description for signal s3"_s));
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(u"Failed to parse value description from string"_s));
+    const auto message = provider(QtCanBus::UniqueId{0x18fef1fe});
+    QVERIFY(message.isValid());
+    QCOMPARE(message.name(), u"Test1"_s);
+    QCOMPARE(message.signalDescriptions().size(), 2);
+
+    // the results for all messages are still available, and equal
+    QVERIFY(equals(sortedMessages(parser), sortedMessages(reference)));
+    QCOMPARE(parser.messageValueDescriptions(), reference.messageValueDescriptions());
+
+    // the provider keeps the contents, even if the parser is destroyed
+    QCanFrameProcessor::MessageDescriptionProvider detachedProvider;
+    {
+        QCanDbcFileParser other;
+        other.setLazyLoading(true);
+        QVERIFY(parseHelper(&other, fileName, readFromFile));
+        detachedProvider = other.messageDescriptionProvider();
+    }
+    QVERIFY(equals(detachedProvider(QtCanBus::UniqueId{1234}),
+                   provider(QtCanBus::UniqueId{1234})));
+
+    const QStringList fileNames = {
+        u"valid_message_and_signals.dbc"_s, u"simple_multiplexing.dbc"_s,
+        u"extended_multiplexing.dbc"_s, u"messages_with_comments.dbc"_s,
+        u"message_signals_in_one_line.dbc"_s, u"different_data_types.dbc"_s,
+        u"invalid_message_pos.dbc"_s, u"invalid_signal_pos.dbc"_s
+    };
+    for (const QString &name : fileNames) {
+        const bool result = parseHelper(&reference, m_filesDir + name, readFromFile);
+        QCOMPARE(parseHelper(&parser, m_filesDir + name, readFromFile), result);
+        QCOMPARE(parser.error(), reference.error());
+        QCOMPARE(parser.errorString(), reference.errorString());
+        if (!result)
+            continue;
+        const auto messages = sortedMessages(reference);
+        const auto lazyProvider = parser.messageDescriptionProvider();
+        for (const auto &expected : messages)
+            QVERIFY(equals(lazyProvider(expected.uniqueId()), expected));
+        QVERIFY(equals(sortedMessages(parser), messages));
+    }
+
+    if (!readFromFile)
+        return;
+
+    // the extra data of the second file refers to a message of the first one
+    const QStringList files = { m_filesDir + u"multiple_files_1.dbc"_s,
+                                m_filesDir + u"multiple_files_2.dbc"_s };
+    QVERIFY(reference.parse(files));
+    QVERIFY(parser.parse(files));
+    QVERIFY(parser.warnings().isEmpty());
+    QVERIFY(equals(sortedMessages(parser), sortedMessages(reference)));
+}
+
 QTEST_MAIN(tst_QCanDbcFileParser)
 
 #include "tst_qcandbcfileparser.moc"
@@ -10,9 +10,12 @@
 #include <QtSerialBus/qcanmessagedescription.h>
 #include <QtSerialBus/qcansignaldescription.h>
 #include <QtSerialBus/private/qcanframeprocessor_p.h>
+#include <QtSerialBus/private/qcanmessagedescription_p.h>
 
 QT_USE_NAMESPACE
 
+using namespace Qt::StringLiterals;
+
 class tst_QCanFrameProcessor : public QObject
 {
     Q_OBJECT
@@ -40,6 +43,12 @@ private slots:
     void extractUniqueId_data();
     void extractUniqueId();
 
+    void extractSignalBits();
+
+    void messageLookup();
+    void messageDescriptionProvider();
+    void valueDescriptions();
+
     /* generate */
     void prepareFrame_data();
     void prepareFrame();
@@ -56,6 +65,8 @@ private slots:
     void prepareUniqueId_data();
     void prepareUniqueId();
 
+    void frameBuilder();
+
     /* roundtrip */
     void roundtrip_data();
     void roundtrip();
@@ -992,6 +1003,340 @@ void tst_QCanFrameProcessor::extractUniqueId()
     QCOMPARE(result.uniqueId, expectedUniqueId);
 }
 
+// Reads the bits of a signal one by one, in the order that is described by
+// the DBC format. Returns std::nullopt if the signal exceeds the payload.
+static std::optional<quint64> referenceSignalBits(const QByteArray &payload, quint16 startBit,
+                                                  quint16 bitLength, QSysInfo::Endian endian)
+{
+    const auto bitAt = [&payload](qsizetype bit) -> std::optional<quint64> {
+        if (bit / 8 >= payload.size())
+            return std::nullopt;
+        return (quint8(payload.at(bit / 8)) >> (bit % 8)) & 0x01;
+    };
+
+    quint64 bits = 0;
+    qsizetype bitIdx = startBit;
+    for (quint16 i = 0; i < bitLength; ++i) {
+        const auto bit = bitAt(bitIdx);
+        if (!bit)
+            return std::nullopt;
+        if (endian == QSysInfo::Endian::LittleEndian) {
+            // the start bit is the LSB
+            bits |= *bit << i;
+            ++bitIdx;
+        } else {
+            // the start bit is the MSB, continue with the MSB of the next byte
+            bits = (bits << 1) | *bit;
+            bitIdx = (bitIdx % 8 == 0) ? bitIdx + 15 : bitIdx - 1;
+        }
+    }
+    return bits;
+}
+
+void tst_QCanFrameProcessor::extractSignalBits()
+{
+    // Compare the extraction of all possible signal positions in a CAN FD
+    // payload with a bit by bit reference implementation.
+    QByteArray payload(24, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (char &byte : payload) {
+        seed = seed * 1103515245 + 12345;
+        byte = char(seed >> 16);
+    }
+    QCanBusFrame frame(0x123, payload);
+    frame.setFlexibleDataRateFormat(true);
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(11);
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+
+    for (auto endian : { QSysInfo::Endian::LittleEndian, QSysInfo::Endian::BigEndian }) {
+        for (quint16 bitLength = 1; bitLength <= 64; ++bitLength) {
+            QList<QCanSignalDescription> signalDescriptions;
+            QHash<QString, quint64> expectedBits;
+            for (quint16 startBit = 0; startBit < payload.size() * 8; ++startBit) {
+                const auto bits = referenceSignalBits(payload, startBit, bitLength, endian);
+                if (!bits)
+                    continue;
+                for (auto format : { QtCanBus::DataFormat::UnsignedInteger,
+                                     QtCanBus::DataFormat::SignedInteger }) {
+                    QCanSignalDescription signalDesc;
+                    const bool isSigned = format == QtCanBus::DataFormat::SignedInteger;
+                    signalDesc.setName((isSigned ? u"s%1"_s : u"u%1"_s).arg(startBit));
+                    signalDesc.setDataEndian(endian);
+                    signalDesc.setDataFormat(format);
+                    signalDesc.setStartBit(startBit);
+                    signalDesc.setBitLength(bitLength);
+                    signalDescriptions.append(signalDesc);
+                    expectedBits.insert(signalDesc.name(), *bits);
+                }
+            }
+
+            QCanMessageDescription message;
+            message.setName("message");
+            message.setUniqueId(QtCanBus::UniqueId{0x123});
+            message.setSize(payload.size());
+            message.setSignalDescriptions(signalDescriptions);
+            processor.setMessageDescriptions({ message });
+
+            const auto result = processor.parseFrame(frame);
+            QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+            QVERIFY(processor.warnings().isEmpty());
+            QCOMPARE(result.signalValues.size(), expectedBits.size());
+            for (auto it = expectedBits.cbegin(); it != expectedBits.cend(); ++it) {
+                const QVariant value = result.signalValues.value(it.key());
+                if (it.key().startsWith(u's')) {
+                    // sign-extend the reference value
+                    const quint64 signBit = quint64(1) << (bitLength - 1);
+                    const auto expected = qint64((it.value() ^ signBit) - signBit);
+                    QCOMPARE(value.toLongLong(), expected);
+                } else {
+                    QCOMPARE(value.toULongLong(), it.value());
+                }
+            }
+        }
+    }
+}
+
+void tst_QCanFrameProcessor::messageLookup()
+{
+    QCanSignalDescription signalDesc;
+    signalDesc.setName("s0");
+    signalDesc.setStartBit(7);
+    signalDesc.setBitLength(8);
+
+    QCanMessageDescription standardMsg;
+    standardMsg.setName("standard");
+    standardMsg.setUniqueId(QtCanBus::UniqueId{0x7FF});
+    standardMsg.setSize(1);
+    standardMsg.addSignalDescription(signalDesc);
+
+    QCanMessageDescription extendedMsg = standardMsg;
+    extendedMsg.setName("extended");
+    extendedMsg.setUniqueId(QtCanBus::UniqueId{0x1ABCDEF});
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(29);
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+    const auto *d = QCanFrameProcessorPrivate::get(processor);
+
+    // all unique ids fit into 11 bits -> direct lookup
+    processor.setMessageDescriptions({ standardMsg });
+    QVERIFY(!d->directMessageLookup.isEmpty());
+    auto result = processor.parseFrame(QCanBusFrame(0x7FF, QByteArray(1, 0x12)));
+    QCOMPARE(result.uniqueId, QtCanBus::UniqueId{0x7FF});
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x12);
+    result = processor.parseFrame(QCanBusFrame(0x1ABCDEF, QByteArray(1, 0x12)));
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::Decoding);
+    QCOMPARE(processor.prepareFrame(QtCanBus::UniqueId{0x7FF}, {{"s0", 0x34}}).payload(),
+             QByteArray(1, 0x34));
+
+    // an extended unique id -> hash lookup
+    processor.addMessageDescriptions({ extendedMsg });
+    QVERIFY(d->directMessageLookup.isEmpty());
+    result = processor.parseFrame(QCanBusFrame(0x7FF, QByteArray(1, 0x12)));
+    QCOMPARE(result.uniqueId, QtCanBus::UniqueId{0x7FF});
+    result = processor.parseFrame(QCanBusFrame(0x1ABCDEF, QByteArray(1, 0x56)));
+    QCOMPARE(result.uniqueId, QtCanBus::UniqueId{0x1ABCDEF});
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x56);
+
+    processor.clearMessageDescriptions();
+    QVERIFY(d->directMessageLookup.isEmpty());
+    result = processor.parseFrame(QCanBusFrame(0x7FF, QByteArray(1, 0x12)));
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::Decoding);
+}
+
+void tst_QCanFrameProcessor::messageDescriptionProvider()
+{
+    QCanSignalDescription signalDesc;
+    signalDesc.setName("s0");
+    signalDesc.setStartBit(7);
+    signalDesc.setBitLength(8);
+
+    QCanMessageDescription message;
+    message.setName("provided");
+    message.setUniqueId(QtCanBus::UniqueId{0x123});
+    message.setSize(1);
+    message.addSignalDescription(signalDesc);
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(29);
+
+    QList<QtCanBus::UniqueId> requests;
+    const auto provider = [&](QtCanBus::UniqueId uid) {
+        requests.append(uid);
+        return uid == message.uniqueId() ? message : QCanMessageDescription();
+    };
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+    QVERIFY(!processor.messageDescriptionProvider());
+    processor.setMessageDescriptionProvider(provider);
+    QVERIFY(processor.messageDescriptionProvider());
+    QVERIFY(processor.messageDescriptions().isEmpty());
+
+    // the description is requested once, and then kept
+    auto result = processor.parseFrame(QCanBusFrame(0x123, QByteArray(1, 0x12)));
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x12);
+    result = processor.parseFrame(QCanBusFrame(0x123, QByteArray(1, 0x34)));
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x34);
+    QCOMPARE(processor.prepareFrame(QtCanBus::UniqueId{0x123}, {{"s0", 0x56}}).payload(),
+             QByteArray(1, 0x56));
+    QCOMPARE(requests, QList<QtCanBus::UniqueId>{ QtCanBus::UniqueId{0x123} });
+    QCOMPARE(processor.messageDescriptions().size(), 1);
+
+    // unknown ids are requested once as well
+    requests.clear();
+    processor.parseFrame(QCanBusFrame(0x124, QByteArray(1, 0x12)));
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::Decoding);
+    QVERIFY(!processor.createFrameBuilder(QtCanBus::UniqueId{0x124}).isValid());
+    QCOMPARE(requests, QList<QtCanBus::UniqueId>{ QtCanBus::UniqueId{0x124} });
+
+    // explicitly added descriptions take precedence
+    QCanMessageDescription added = message;
+    added.setUniqueId(QtCanBus::UniqueId{0x124});
+    processor.addMessageDescriptions({ added });
+    result = processor.parseFrame(QCanBusFrame(0x124, QByteArray(1, 0x78)));
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x78);
+    QCOMPARE(requests.size(), 1);
+
+    // cleared descriptions are requested again
+    requests.clear();
+    processor.clearMessageDescriptions();
+    result = processor.parseFrame(QCanBusFrame(0x123, QByteArray(1, 0x12)));
+    QCOMPARE(result.signalValues.value("s0").toInt(), 0x12);
+    QCOMPARE(requests, QList<QtCanBus::UniqueId>{ QtCanBus::UniqueId{0x123} });
+
+    // without a provider, nothing new is loaded
+    processor.setMessageDescriptionProvider({});
+    processor.parseFrame(QCanBusFrame(0x125, QByteArray(1, 0x12)));
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::Decoding);
+    QCOMPARE(requests.size(), 1);
+}
+
+void tst_QCanFrameProcessor::valueDescriptions()
+{
+    QCanSignalDescription dense;
+    dense.setName("dense");
+    dense.setDataEndian(QSysInfo::Endian::LittleEndian);
+    dense.setStartBit(0);
+    dense.setBitLength(8);
+
+    QCanSignalDescription sparse = dense;
+    sparse.setName("sparse");
+    sparse.setStartBit(8);
+    sparse.setBitLength(16);
+
+    QCanSignalDescription scaled = dense;
+    scaled.setName("scaled");
+    scaled.setStartBit(24);
+    scaled.setFactor(0.5);
+    scaled.setOffset(10);
+
+    QCanSignalDescription plain = dense;
+    plain.setName("plain");
+    plain.setStartBit(32);
+
+    QCanMessageDescription message;
+    message.setName("message");
+    message.setUniqueId(QtCanBus::UniqueId{0x123});
+    message.setSize(5);
+    message.setSignalDescriptions({ dense, sparse, scaled, plain });
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(11);
+
+    const QCanFrameProcessor::MessageValueDescriptions descriptions = {
+        { QtCanBus::UniqueId{0x123}, {
+            { "dense", { {0, "Off"}, {1, "On"}, {3, "Error"} } },
+            { "sparse", { {1, "On"}, {1000, "Kilo"}, {60000, "Max"} } },
+            { "scaled", { {4, "Four"} } }
+        } }
+    };
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+    processor.setMessageDescriptions({ message });
+    processor.setValueDescriptions(descriptions);
+    QCOMPARE(processor.valueDescriptions(), descriptions);
+
+    const auto *d = QCanFrameProcessorPrivate::get(processor);
+    const auto tables = d->valueTables.value(QtCanBus::UniqueId{0x123});
+    QCOMPARE(tables.size(), 4);
+    // the tables follow the order of the signal descriptions
+    const auto &messageSignals = QCanMessageDescriptionPrivate::get(message)->messageSignals;
+    for (qsizetype i = 0; i < messageSignals.size(); ++i) {
+        const auto &table = tables.at(i);
+        const QString name = messageSignals.at(i).name();
+        if (name == u"dense") {
+            QVERIFY(!table.dense.isEmpty());
+        } else if (name == u"sparse") {
+            QVERIFY(table.dense.isEmpty());
+            QCOMPARE(table.sparse.size(), 3);
+        } else if (name == u"plain") {
+            QVERIFY(table.dense.isEmpty());
+            QVERIFY(table.sparse.isEmpty());
+        }
+    }
+
+    const auto decode = [&](const QByteArray &payload) {
+        const QCanBusFrame frame(0x123, payload);
+        const auto result = processor.decodeFrame(frame);
+        const auto parsed = processor.parseFrame(frame);
+        QHash<QString, QString> texts;
+        for (const auto &signal : result.signalValues) {
+            // the values match those of parseFrame()
+            if (signal.value != parsed.signalValues.value(signal.name))
+                return QHash<QString, QString>{ { "mismatch", signal.name } };
+            if (signal.valueText >= 0)
+                texts.insert(signal.name, processor.valueText(signal.valueText));
+        }
+        return texts;
+    };
+
+    // raw value 4 of "scaled" is the physical value 12
+    QHash<QString, QString> expected = {
+        { "dense", "On" }, { "sparse", "Kilo" }, { "scaled", "Four" }
+    };
+    QCOMPARE(decode(QByteArray::fromHex("01e8030401")), expected);
+
+    expected = { { "dense", "Error" }, { "sparse", "Max" } };
+    QCOMPARE(decode(QByteArray::fromHex("0360ea0501")), expected);
+
+    // unknown values have no text
+    QVERIFY(decode(QByteArray::fromHex("0202000000")).isEmpty());
+
+    // equal texts share the handle
+    auto result = processor.decodeFrame(QCanBusFrame(0x123, QByteArray::fromHex("0101000000")));
+    QCOMPARE(result.signalValues.size(), 4);
+    QList<QCanFrameProcessor::ValueTextHandle> onHandles;
+    for (const auto &signal : result.signalValues) {
+        if (signal.valueText >= 0)
+            onHandles.append(signal.valueText);
+    }
+    QCOMPARE(onHandles.size(), 2);
+    QCOMPARE(onHandles.at(0), onHandles.at(1));
+    QCOMPARE(processor.valueText(onHandles.at(0)), u"On");
+    QVERIFY(processor.valueText(-1).isEmpty());
+    QVERIFY(processor.valueText(1000).isEmpty());
+
+    // tables are kept up to date with the message descriptions
+    processor.clearMessageDescriptions();
+    QVERIFY(d->valueTables.isEmpty());
+    processor.addMessageDescriptions({ message });
+    QCOMPARE(decode(QByteArray::fromHex("0000000000")),
+             (QHash<QString, QString>{ { "dense", "Off" } }));
+
+    processor.setValueDescriptions({});
+    QVERIFY(d->valueTables.isEmpty());
+    QVERIFY(decode(QByteArray::fromHex("01e8030401")).isEmpty());
+}
+
 void tst_QCanFrameProcessor::prepareFrame_data()
 {
     QTest::addColumn<quint16>("startBit");
@@ -1865,6 +2210,120 @@ void tst_QCanFrameProcessor::prepareUniqueId()
     QCOMPARE(result.payload(), expectedFrame.payload());
 }
 
+void tst_QCanFrameProcessor::frameBuilder()
+{
+    QCanSignalDescription mux;
+    mux.setName("mux");
+    mux.setDataEndian(QSysInfo::Endian::LittleEndian);
+    mux.setStartBit(0);
+    mux.setBitLength(4);
+    mux.setMultiplexState(QtCanBus::MultiplexState::MultiplexorSwitch);
+
+    QCanSignalDescription s0; // multiplexed
+    s0.setName("s0");
+    s0.setDataEndian(QSysInfo::Endian::LittleEndian);
+    s0.setStartBit(4);
+    s0.setBitLength(4);
+    s0.setMultiplexState(QtCanBus::MultiplexState::MultiplexedSignal);
+    s0.addMultiplexSignal(mux.name(), 1);
+
+    QCanSignalDescription s1;
+    s1.setName("s1");
+    s1.setDataEndian(QSysInfo::Endian::LittleEndian);
+    s1.setStartBit(8);
+    s1.setBitLength(12);
+
+    QCanSignalDescription s2;
+    s2.setName("s2");
+    s2.setDataEndian(QSysInfo::Endian::BigEndian);
+    s2.setStartBit(23);
+    s2.setBitLength(8);
+    s2.setFactor(0.5);
+
+    const QtCanBus::UniqueId uniqueId{0x123};
+
+    QCanMessageDescription msg;
+    msg.setName("test");
+    msg.setUniqueId(uniqueId);
+    msg.setSize(4);
+    msg.setSignalDescriptions({ mux, s0, s1, s2 });
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(29);
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+
+    // no message description
+    QCanFrameProcessor::FrameBuilder builder = processor.createFrameBuilder(uniqueId);
+    QVERIFY(!builder.isValid());
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::Encoding);
+    QVERIFY(!builder.frame().isValid());
+
+    processor.addMessageDescriptions({ msg });
+    builder = processor.createFrameBuilder(uniqueId);
+    QVERIFY(builder.isValid());
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+    QCOMPARE(builder.uniqueId(), uniqueId);
+
+    const auto muxHandle = builder.signalHandle("mux");
+    const auto s0Handle = builder.signalHandle("s0");
+    const auto s1Handle = builder.signalHandle("s1");
+    const auto s2Handle = builder.signalHandle("s2");
+    QVERIFY(muxHandle >= 0);
+    QVERIFY(s0Handle >= 0);
+    QVERIFY(s1Handle >= 0);
+    QVERIFY(s2Handle >= 0);
+    QVERIFY(builder.signalHandle("unknown") < 0);
+    QVERIFY(!builder.setSignalValue(-1, 1));
+
+    QCanBusFrame frame = builder.frame();
+    QCOMPARE(frame.frameId(), static_cast<QCanBusFrame::FrameId>(uniqueId));
+    QCOMPARE(frame.payload(), QByteArray(4, 0x00));
+
+    // multiplexor precondition is not met yet
+    QVERIFY(!builder.setSignalValue(s0Handle, 5));
+    QVERIFY(!builder.signalValue(s0Handle).isValid());
+
+    QVERIFY(builder.setSignalValue(muxHandle, 1));
+    QVERIFY(builder.setSignalValue(s0Handle, 5));
+    QVERIFY(builder.setSignalValue(s1Handle, 0xABC));
+    QVERIFY(builder.setSignalValue(s2Handle, 20.));
+    QCOMPARE(builder.signalValue(s1Handle).toInt(), 0xABC);
+
+    const QVariantMap allValues = { qMakePair(u"mux"_s, 1), qMakePair(u"s0"_s, 5),
+                                    qMakePair(u"s1"_s, 0xABC), qMakePair(u"s2"_s, 20.) };
+    frame = builder.frame();
+    QVERIFY(frame.isValid());
+    QCOMPARE(frame.frameId(), static_cast<QCanBusFrame::FrameId>(uniqueId));
+    QCOMPARE(frame.payload(), processor.prepareFrame(uniqueId, allValues).payload());
+
+    // updating one signal keeps all other bits, and does not modify the
+    // previously returned frame
+    const QByteArray previousPayload = frame.payload();
+    QVERIFY(builder.setSignalValue(s1Handle, 0x123));
+    QCOMPARE(frame.payload(), previousPayload);
+
+    QVariantMap updatedValues = allValues;
+    updatedValues.insert(u"s1"_s, 0x123);
+    QCOMPARE(builder.frame().payload(), processor.prepareFrame(uniqueId, updatedValues).payload());
+
+    // a multiplexed signal that no longer matches its multiplexor is removed
+    QVERIFY(builder.setSignalValue(muxHandle, 2));
+    QVERIFY(!builder.signalValue(s0Handle).isValid());
+    updatedValues.remove(u"s0"_s);
+    updatedValues.insert(u"mux"_s, 2);
+    frame = builder.frame();
+    QCOMPARE(frame.payload(), processor.prepareFrame(uniqueId, updatedValues).payload());
+    QCOMPARE(frame.payload().at(0), char(0x02));
+
+    // and is not restored when the multiplexor matches again
+    QVERIFY(builder.setSignalValue(muxHandle, 1));
+    QVERIFY(!builder.signalValue(s0Handle).isValid());
+    QCOMPARE(builder.frame().payload().at(0), char(0x01));
+    QCOMPARE(builder.frame().payload().mid(1), frame.payload().mid(1));
+}
+
 void tst_QCanFrameProcessor::roundtrip_data()
 {
     QTest::addColumn<QCanMessageDescription>("messageDescription");
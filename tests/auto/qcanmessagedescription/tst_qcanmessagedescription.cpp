@@ -204,6 +204,31 @@ void tst_QCanMessageDescription::signalForName()
     // invalid name
     s = d.signalDescriptionForName("test");
     QVERIFY(!s.isValid());
+
+    // the signals are sorted by name, and a signal with an existing name
+    // replaces the old one
+    QCanSignalDescription a;
+    a.setName("a");
+    a.setBitLength(4);
+    QCanSignalDescription b;
+    b.setName("s0b");
+    b.setBitLength(4);
+    QCanSignalDescription s0;
+    s0.setName("s0");
+    s0.setBitLength(16);
+    d.addSignalDescription(b);
+    d.addSignalDescription(a);
+    d.addSignalDescription(s0);
+
+    const QList<QCanSignalDescription> descriptions = d.signalDescriptions();
+    QStringList names;
+    for (const QCanSignalDescription &desc : descriptions)
+        names.append(desc.name());
+    QCOMPARE(names, QStringList({ "a", "s0", "s0b", "s1" }));
+    QCOMPARE(d.signalDescriptionForName("s0").bitLength(), 16);
+    QCOMPARE(d.signalDescriptionForName("s0b").bitLength(), 4);
+    QCOMPARE(d.signalDescriptionForName("a").bitLength(), 4);
+    QVERIFY(!d.signalDescriptionForName("s").isValid());
 }
 
 QTEST_MAIN(tst_QCanMessageDescription)
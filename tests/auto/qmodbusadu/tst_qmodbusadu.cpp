@@ -78,6 +78,41 @@ private slots:
         ba = QModbusSerialAdu::create(QModbusSerialAdu::Rtu, 17, pdu);
         QCOMPARE(ba, adu.rawData());
         QCOMPARE(adu.data(), QModbusSerialAdu(QModbusSerialAdu::Rtu, ba).data());
+
+        char buffer[QModbusSerialAdu::MaxSize];
+        const qsizetype size = QModbusSerialAdu::create(buffer, 17, pdu);
+        QCOMPARE(QByteArray(buffer, size), ba);
+
+        // the largest valid PDU fits, a larger one does not
+        const QModbusRequest largest(QModbusPdu::WriteMultipleRegisters, QByteArray(252, 0x01));
+        QCOMPARE(QModbusSerialAdu::create(buffer, 17, largest), QModbusSerialAdu::MaxSize);
+        QCOMPARE(QByteArray(buffer, QModbusSerialAdu::MaxSize),
+                 QModbusSerialAdu::create(QModbusSerialAdu::Rtu, 17, largest));
+        const QModbusRequest tooLarge(QModbusPdu::WriteMultipleRegisters, QByteArray(253, 0x01));
+        QCOMPARE(QModbusSerialAdu::create(buffer, 17, tooLarge), qsizetype(-1));
+    }
+
+    void testInlineStorage()
+    {
+        QByteArray raw = QByteArray::fromHex("f00103001200080f1d");
+        const QModbusSerialAdu adu(QModbusSerialAdu::Rtu, raw);
+        // the ADU does not refer to the input
+        raw.fill(0);
+        QCOMPARE(adu.rawData(), QByteArray::fromHex("f00103001200080f1d"));
+        QVERIFY(adu.matchingChecksum());
+
+        const QModbusPdu view = adu.pduView();
+        QCOMPARE(view.functionCode(), QModbusPdu::ReadCoils);
+        QCOMPARE(view.data(), QByteArray::fromHex("0300120008"));
+        QVERIFY(view.data().constData() == adu.dataView().data() + 2);
+        QCOMPARE(adu.pdu().data(), view.data());
+        QVERIFY(adu.pdu().data().constData() != view.data().constData());
+
+        // longer input is truncated, but the raw size is kept
+        const QModbusSerialAdu longAdu(QModbusSerialAdu::Rtu, QByteArray(300, 0x01));
+        QCOMPARE(longAdu.rawSize(), 300);
+        QCOMPARE(longAdu.size(), int(QModbusSerialAdu::MaxSize) - 2);
+        QCOMPARE(longAdu.pduView().dataSize(), qint16(QModbusSerialAdu::MaxSize - 4));
     }
 
     void testChecksumLRC_data()
@@ -182,6 +217,32 @@ private slots:
         QFETCH(quint16, crc);
         QCOMPARE(QModbusSerialAdu::calculateCRC(pdu.constData(), pdu.size()), crc);
     }
+
+    void testRunningCRC_data()
+    {
+        testChecksumCRC_data();
+    }
+
+    void testRunningCRC()
+    {
+        QFETCH(QByteArray, pdu);
+        QFETCH(quint16, crc);
+
+        // one byte at a time, as they may arrive on the serial line
+        quint16 runningCrc = QModbusSerialAdu::CrcInitialValue;
+        for (const char c : std::as_const(pdu))
+            runningCrc = QModbusSerialAdu::updateCRC(runningCrc, &c, 1);
+        QCOMPARE(quint16((runningCrc >> 8) | (runningCrc << 8)), crc);
+
+        // the checksum of the whole ADU is zero, unless a bit is corrupted
+        QByteArray adu = pdu;
+        adu.append(char(crc >> 8)).append(char(crc & 0xff));
+        QCOMPARE(QModbusSerialAdu::updateCRC(QModbusSerialAdu::CrcInitialValue,
+                                             adu.constData(), adu.size()), quint16(0));
+        adu[1] = char(adu.at(1) ^ 0x10);
+        QVERIFY(QModbusSerialAdu::updateCRC(QModbusSerialAdu::CrcInitialValue,
+                                            adu.constData(), adu.size()) != 0);
+    }
 };
 
 QTEST_MAIN(tst_QModbusAdu)
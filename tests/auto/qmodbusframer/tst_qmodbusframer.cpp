@@ -0,0 +1,180 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <private/qmodbusframer_p.h>
+
+#include <QtTest/QtTest>
+
+Q_DECLARE_METATYPE(QModbusFramer::Direction)
+
+class tst_QModbusFramer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCreateAdu_data()
+    {
+        QTest::addColumn<QModbusDevice::Framing>("framing");
+        QTest::addColumn<QByteArray>("adu");
+
+        QTest::newRow("MBAP") << QModbusDevice::MbapFraming
+                              << QByteArray::fromHex("12340000000611030000000a");
+        QTest::newRow("RTU") << QModbusDevice::RtuFraming
+                             << QByteArray::fromHex("11030000000ac75d");
+        QTest::newRow("ASCII") << QModbusDevice::AsciiFraming
+                               << QByteArray(":11030000000AE2\r\n");
+    }
+
+    void testCreateAdu()
+    {
+        QFETCH(QModbusDevice::Framing, framing);
+        QFETCH(QByteArray, adu);
+
+        const auto framer = QModbusFramer::create(framing, QModbusFramer::Requests);
+        QVERIFY(framer);
+        QCOMPARE(framer->framing(), framing);
+        QCOMPARE(framer->hasTransactionId(), framing == QModbusDevice::MbapFraming);
+
+        const QModbusRequest request(QModbusRequest::ReadHoldingRegisters, quint16(0),
+                                     quint16(10));
+        QCOMPARE(framer->createAdu(0x1234, 0x11, request), adu);
+
+        // appends to existing data
+        QByteArray out("x");
+        framer->appendAdu(&out, 0x1234, 0x11, request);
+        QCOMPARE(out, "x" + adu);
+    }
+
+    void testParse_data()
+    {
+        QTest::addColumn<QModbusDevice::Framing>("framing");
+        QTest::addColumn<QModbusFramer::Direction>("direction");
+        QTest::addColumn<QByteArray>("pdu");
+
+        const QList<std::pair<QModbusDevice::Framing, const char *>> framings = {
+            { QModbusDevice::MbapFraming, "MBAP" },
+            { QModbusDevice::RtuFraming, "RTU" },
+            { QModbusDevice::AsciiFraming, "ASCII" }
+        };
+        for (const auto &framing : framings) {
+            const auto addRow = [&framing](const char *name, QModbusFramer::Direction direction,
+                                           const char *hex) {
+                QTest::addRow("%s: %s", framing.second, name)
+                    << framing.first << direction << QByteArray::fromHex(hex);
+            };
+            addRow("read request", QModbusFramer::Requests, "030000000a");
+            addRow("read response", QModbusFramer::Responses, "03040001002a");
+            addRow("exception response", QModbusFramer::Responses, "8302");
+            addRow("write multiple request", QModbusFramer::Requests, "100000000204002a0001");
+            addRow("return query data request", QModbusFramer::Requests, "08000001020304");
+            addRow("return query data response", QModbusFramer::Responses, "08000001020304");
+            addRow("custom function code", QModbusFramer::Requests, "41deadbeef");
+        }
+    }
+
+    void testParse()
+    {
+        QFETCH(QModbusDevice::Framing, framing);
+        QFETCH(QModbusFramer::Direction, direction);
+        QFETCH(QByteArray, pdu);
+
+        const auto framer = QModbusFramer::create(framing, direction);
+        const QModbusRequest request(QModbusPdu::FunctionCode(quint8(pdu.at(0))), pdu.mid(1));
+        const QByteArray adu = framer->createAdu(0x1234, 0x11, request);
+
+        // two frames in a row, the second one arrives byte by byte
+        QByteArray buffer = adu;
+        QModbusFramer::Frame frame;
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Complete);
+        QCOMPARE(frame.size, adu.size());
+        QCOMPARE(frame.serverAddress, 0x11);
+        QCOMPARE(frame.transactionId, framer->hasTransactionId() ? 0x1234 : -1);
+        QCOMPARE(quint8(frame.functionCode), quint8(pdu.at(0)));
+        QCOMPARE(frame.data, pdu.mid(1));
+        QVERIFY(frame.matchingChecksum);
+        QCOMPARE(frame.pdu<QModbusRequest>(), request);
+        buffer.remove(0, frame.size);
+
+        for (qsizetype i = 0; i < adu.size() - 1; ++i) {
+            buffer.append(adu.at(i));
+            QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Incomplete);
+        }
+        buffer.append(adu.back());
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Complete);
+        QCOMPARE(frame.size, adu.size());
+        QCOMPARE(frame.data, pdu.mid(1));
+    }
+
+    void testWrongChecksum_data()
+    {
+        QTest::addColumn<QModbusDevice::Framing>("framing");
+        QTest::addColumn<QByteArray>("adu");
+
+        QTest::newRow("RTU") << QModbusDevice::RtuFraming
+                             << QByteArray::fromHex("11030000000ac75e");
+        QTest::newRow("ASCII") << QModbusDevice::AsciiFraming
+                               << QByteArray(":11030000000AE3\r\n");
+    }
+
+    void testWrongChecksum()
+    {
+        QFETCH(QModbusDevice::Framing, framing);
+        QFETCH(QByteArray, adu);
+
+        const auto framer = QModbusFramer::create(framing, QModbusFramer::Requests);
+        QModbusFramer::Frame frame;
+        QCOMPARE(framer->parse(adu, &frame), QModbusFramer::Complete);
+        QCOMPARE(frame.size, adu.size());
+        QVERIFY(!frame.matchingChecksum);
+    }
+
+    void testInvalidData()
+    {
+        QModbusFramer::Frame frame;
+
+        // ASCII: everything in front of the colon is skipped
+        auto framer = QModbusFramer::create(QModbusDevice::AsciiFraming,
+                                            QModbusFramer::Requests);
+        QByteArray buffer("xy:11030000000AE2\r\n");
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Invalid);
+        QCOMPARE(frame.size, 2);
+        buffer.remove(0, frame.size);
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Complete);
+
+        // ASCII: characters that are not hexadecimal
+        QCOMPARE(framer->parse(":11030000000XE2\r\n", &frame), QModbusFramer::Invalid);
+        QCOMPARE(frame.size, 17);
+
+        // MBAP: a length that cannot be right drops the buffer
+        framer = QModbusFramer::create(QModbusDevice::MbapFraming, QModbusFramer::Requests);
+        buffer = QByteArray::fromHex("1234000001ff11030000000a");
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Invalid);
+        QCOMPARE(frame.size, buffer.size());
+
+        // RTU: a size beyond the maximum ADU size skips the server address
+        framer = QModbusFramer::create(QModbusDevice::RtuFraming, QModbusFramer::Requests);
+        buffer = QByteArray::fromHex("1110000000fffe");
+        QCOMPARE(framer->parse(buffer, &frame), QModbusFramer::Invalid);
+        QCOMPARE(frame.size, 1);
+    }
+
+    void testReset()
+    {
+        const auto framer = QModbusFramer::create(QModbusDevice::RtuFraming,
+                                                  QModbusFramer::Responses);
+        QModbusFramer::Frame frame;
+
+        // the start of a frame is dropped by the caller, e.g. after a timeout
+        QCOMPARE(framer->parse(QByteArray::fromHex("1103020102"), &frame),
+                 QModbusFramer::Incomplete);
+        framer->reset();
+        QCOMPARE(framer->parse(QByteArray::fromHex("1103020102f9d6"), &frame),
+                 QModbusFramer::Complete);
+        QVERIFY(frame.matchingChecksum);
+        QCOMPARE(frame.data, QByteArray::fromHex("020102"));
+    }
+};
+
+QTEST_MAIN(tst_QModbusFramer)
+
+#include "tst_qmodbusframer.moc"
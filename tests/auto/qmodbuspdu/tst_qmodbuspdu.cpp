@@ -210,6 +210,23 @@ private slots:
         QCOMPARE(bytes, quint8(2));
         QCOMPARE(firstByte, quint8(0xcd));
         QCOMPARE(secondByte, quint8(0x01));
+
+        // values that are not fully available are set to 0
+        request = QModbusRequest(QModbusRequest::ReadCoils, QByteArray::fromHex("001301"));
+        address = 0xffff, quantity = 0xffff, bytes = 0xff;
+        request.decodeData(&address, &quantity, &bytes);
+        QCOMPARE(address, quint16(19));
+        QCOMPARE(quantity, quint16(0));
+        QCOMPARE(bytes, quint8(0));
+
+        QModbusRequest writeRegisters(QModbusRequest::WriteMultipleRegisters);
+        writeRegisters.encodeData(quint16(0x0102), quint16(2), quint8(4),
+                                  QList<quint16>{ 0x0a0b, 0xfffe });
+        QCOMPARE(writeRegisters.data().toHex(), QByteArray("0102000204" "0a0bfffe"));
+        writeRegisters.encodeData(QList<quint8>{ 0x01, 0x02 }, QList<quint16>());
+        QCOMPARE(writeRegisters.data().toHex(), QByteArray("0102"));
+        writeRegisters.encodeData();
+        QVERIFY(writeRegisters.data().isEmpty());
     }
 
     void testQModbusExceptionResponsePdu()
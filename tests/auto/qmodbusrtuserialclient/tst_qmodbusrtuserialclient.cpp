@@ -2,9 +2,12 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include <QtSerialBus/qmodbusrtuserialclient.h>
+#include <QtSerialPort/qserialport.h>
 
 #include <QtTest/QtTest>
 
+#include "pseudoterminal_helpers.h"
+
 class tst_QModbusRtuSerialClient : public QObject
 {
     Q_OBJECT
@@ -21,6 +24,212 @@ private slots:
         qmrsm.setInterFrameDelay(-1);
         QCOMPARE(qmrsm.interFrameDelay(), 2000);
     }
+
+    void testPreciseInterFrameDelay()
+    {
+        QModbusRtuSerialClient client;
+        QVERIFY(!client.isPreciseTimingEnabled());
+        client.setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                      QSerialPort::Baud115200);
+        client.setConnectionParameter(QModbusDevice::SerialParityParameter,
+                                      QSerialPort::NoParity);
+        QCOMPARE(client.interFrameDelay(), 2000);
+
+        client.setPreciseTimingEnabled(true);
+        QVERIFY(client.isPreciseTimingEnabled());
+        // 10 bits per character: 3.5 * 10 / 115200 s = 303.8 us
+        QCOMPARE(client.interFrameDelay(), 304);
+
+        // 11 bits per character
+        client.setConnectionParameter(QModbusDevice::SerialParityParameter,
+                                      QSerialPort::EvenParity);
+        QCOMPARE(client.interFrameDelay(), 335);
+
+        // a longer user defined delay is kept
+        client.setInterFrameDelay(1500);
+        QCOMPARE(client.interFrameDelay(), 1500);
+        client.setInterFrameDelay(100);
+        QCOMPARE(client.interFrameDelay(), 335);
+        client.setInterFrameDelay(-1);
+        QCOMPARE(client.interFrameDelay(), 335);
+
+        client.setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                      QSerialPort::Baud9600);
+        QCOMPARE(client.interFrameDelay(), 4011);
+
+        client.setPreciseTimingEnabled(false);
+        QCOMPARE(client.interFrameDelay(), 2000);
+    }
+
+#if defined(Q_OS_LINUX)
+    void testPreciseTimingOverPty()
+    {
+        PseudoTerminal pty;
+        if (!pty.open())
+            QSKIP("Cannot open a pseudo terminal.");
+        // the server answers at the line rate of the client
+        pty.setBaudRate(QSerialPort::Baud115200);
+
+        QModbusRtuSerialClient client;
+        client.setConnectionParameter(QModbusDevice::SerialPortNameParameter, pty.portName());
+        client.setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                      QSerialPort::Baud115200);
+        client.setTimeout(1000);
+        client.setNumberOfRetries(0);
+        client.setPreciseTimingEnabled(true);
+        QVERIFY(client.connectDevice());
+
+        constexpr int Requests = 20;
+        int finished = 0;
+        for (int i = 0; i < Requests; ++i) {
+            auto reply = client.sendReadRequest(
+                    QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, 1), 1);
+            QVERIFY(reply);
+            connect(reply, &QModbusReply::finished, this, [&finished, reply]() {
+                QCOMPARE(reply->error(), QModbusDevice::NoError);
+                QCOMPARE(reply->result().value(0), quint16(0x2a));
+                ++finished;
+                reply->deleteLater();
+            });
+        }
+
+        // Act as the server: answer every read request for one holding
+        // register, and measure the silence until the next request starts.
+        const QByteArray request = QByteArray::fromHex("010300000001840a");
+        const QByteArray response = QByteArray::fromHex("010302002a399b");
+        QList<qint64> gaps;
+        qint64 respondedAt = -1;
+        for (int i = 0; i < Requests; ++i) {
+            qint64 requestedAt = -1;
+            QCOMPARE(pty.read(request.size(), 1000, &requestedAt), request);
+            if (respondedAt >= 0)
+                gaps.append((requestedAt - respondedAt) / 1000);
+            QVERIFY(pty.write(response));
+            respondedAt = pty.nsecsElapsed();
+        }
+        QTRY_COMPARE(finished, Requests);
+        QCOMPARE(gaps.size(), Requests - 1);
+
+        // Never shorter than 3.5 character times. A loaded machine makes
+        // single gaps longer, but not all of them: without precise timing,
+        // no gap is shorter than 2 msec.
+        std::sort(gaps.begin(), gaps.end());
+        QVERIFY2(gaps.first() >= client.interFrameDelay(), QByteArray::number(gaps.first()));
+        QVERIFY2(gaps.first() < 2000, QByteArray::number(gaps.first()));
+
+        client.disconnectDevice();
+    }
+
+    void testResponseInChunks_data()
+    {
+        QTest::addColumn<QByteArray>("response");
+        QTest::addColumn<bool>("valid");
+
+        QTest::newRow("read holding registers") << QByteArray::fromHex("010302002a399b") << true;
+        QTest::newRow("wrong CRC") << QByteArray::fromHex("010302002a399c") << false;
+        QTest::newRow("exception") << QByteArray::fromHex("018302c0f1") << true;
+    }
+
+    void testResponseInChunks()
+    {
+        QFETCH(QByteArray, response);
+        QFETCH(bool, valid);
+
+        PseudoTerminal pty;
+        if (!pty.open())
+            QSKIP("Cannot open a pseudo terminal.");
+        // one byte per read on the client side, as at low baud rates
+        pty.setBaudRate(QSerialPort::Baud1200, 11);
+
+        QModbusRtuSerialClient client;
+        client.setConnectionParameter(QModbusDevice::SerialPortNameParameter, pty.portName());
+        client.setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                      QSerialPort::Baud1200);
+        client.setTimeout(500);
+        client.setNumberOfRetries(0);
+        QVERIFY(client.connectDevice());
+
+        auto reply = client.sendReadRequest(
+                QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, 1), 1);
+        QVERIFY(reply);
+        const auto deleteReply = qScopeGuard([reply] { delete reply; });
+
+        QCOMPARE(pty.read(8), QByteArray::fromHex("010300000001840a"));
+        QVERIFY(pty.write(response));
+        QTRY_VERIFY(reply->isFinished());
+
+        if (!valid) {
+            QCOMPARE(reply->error(), QModbusDevice::TimeoutError);
+            QVERIFY(reply->intermediateErrors().contains(QModbusDevice::ResponseCrcError));
+        } else if (response.at(1) & 0x80) {
+            QCOMPARE(reply->error(), QModbusDevice::ProtocolError);
+            QCOMPARE(reply->rawResult().exceptionCode(),
+                     QModbusExceptionResponse::IllegalDataAddress);
+        } else {
+            QCOMPARE(reply->error(), QModbusDevice::NoError);
+            QCOMPARE(reply->result().value(0), quint16(0x2a));
+        }
+        client.disconnectDevice();
+    }
+
+    void testTurnaroundAfterBroadcast()
+    {
+        PseudoTerminal pty;
+        if (!pty.open())
+            QSKIP("Cannot open a pseudo terminal.");
+        pty.setBaudRate(QSerialPort::Baud115200);
+
+        QModbusRtuSerialClient client;
+        client.setConnectionParameter(QModbusDevice::SerialPortNameParameter, pty.portName());
+        client.setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                      QSerialPort::Baud115200);
+        client.setTimeout(200);
+        client.setNumberOfRetries(0);
+        client.setTurnaroundDelay(20);
+        client.setPreciseTimingEnabled(true);
+        QVERIFY(client.connectDevice());
+
+        const QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, 0, 1);
+        auto broadcast = client.sendWriteRequest(
+                QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, QList<quint16>{ 0x2a }), 0);
+        QVERIFY(broadcast);
+        auto reply = client.sendReadRequest(readUnit, 1);
+        QVERIFY(reply);
+        const auto deleteReplies = qScopeGuard([&] {
+            delete broadcast;
+            delete reply;
+        });
+
+        // the read request follows the broadcast after the turnaround delay
+        QCOMPARE(pty.read(8), QByteArray::fromHex("00060000002a09c4"));
+        const qint64 broadcastAt = pty.nsecsElapsed();
+        QTRY_VERIFY(broadcast->isFinished());
+        QCOMPARE(broadcast->error(), QModbusDevice::NoError);
+        qint64 requestAt = -1;
+        QCOMPARE(pty.read(8, 1000, &requestAt), QByteArray::fromHex("010300000001840a"));
+        const qint64 turnaround = (requestAt - broadcastAt) / 1000;
+        QVERIFY2(turnaround >= 18'000, QByteArray::number(turnaround));
+
+        // A response that starts before, but ends after the timeout is stale,
+        // and must not be taken for the response to the next request.
+        const QByteArray response = QByteArray::fromHex("010302002a399b");
+        QVERIFY(pty.write(response.first(3)));
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QModbusDevice::TimeoutError);
+        QVERIFY(pty.write(response.sliced(3)));
+
+        auto next = client.sendReadRequest(readUnit, 1);
+        QVERIFY(next);
+        const auto deleteNext = qScopeGuard([next] { delete next; });
+        QCOMPARE(pty.read(8), QByteArray::fromHex("010300000001840a"));
+        QVERIFY(pty.write(response));
+        QTRY_VERIFY(next->isFinished());
+        QCOMPARE(next->error(), QModbusDevice::NoError);
+        QCOMPARE(next->result().value(0), quint16(0x2a));
+
+        client.disconnectDevice();
+    }
+#endif
 };
 
 QTEST_MAIN(tst_QModbusRtuSerialClient)
@@ -0,0 +1,160 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtSerialBus/qmodbusrtuserialclient.h>
+#include <QtSerialBus/qmodbusrtuserialclientgroup.h>
+#include <QtSerialPort/qserialport.h>
+
+#include <QtTest/QtTest>
+
+#include "pseudoterminal_helpers.h"
+
+#if defined(Q_OS_LINUX)
+#include <memory>
+
+// The server side of a line: answers each read request for one holding
+// register of server 1, unless it is silent. The responses are not paced,
+// so that the notifier is not activated again while one is written.
+class PtyServer : public QObject
+{
+public:
+    explicit PtyServer(bool silent) : m_silent(silent) { }
+
+    bool open()
+    {
+        if (!m_pty.open())
+            return false;
+        m_notifier = std::make_unique<QSocketNotifier>(m_pty.handle(), QSocketNotifier::Read);
+        connect(m_notifier.get(), &QSocketNotifier::activated, this, [this]() {
+            onReadyRead();
+        });
+        return true;
+    }
+
+    QString portName() const { return m_pty.portName(); }
+    int requests = 0;
+
+private:
+    void onReadyRead()
+    {
+        m_received.append(m_pty.readAll());
+        while (m_received.size() >= 8) {
+            m_received.remove(0, 8);
+            ++requests;
+            if (m_silent)
+                continue;
+            if (!m_pty.write(QByteArray::fromHex("010302002a399b")))
+                qWarning("Cannot write the response.");
+        }
+    }
+
+    PseudoTerminal m_pty;
+    std::unique_ptr<QSocketNotifier> m_notifier; // destroyed before the pty
+    QByteArray m_received;
+    bool m_silent = false;
+};
+#endif
+
+class tst_QModbusRtuSerialClientGroup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lines()
+    {
+        QModbusRtuSerialClientGroup group;
+        QCOMPARE(group.lineCount(), 0);
+        QVERIFY(!group.line(0));
+
+        QCOMPARE(group.addLine(QStringLiteral("ttyS0")), 0);
+        QCOMPARE(group.addLine(QStringLiteral("ttyS1")), 1);
+        QCOMPARE(group.lineCount(), 2);
+        QVERIFY(group.line(1));
+        QVERIFY(group.line(1)->parent() == &group);
+        QCOMPARE(group.line(1)->connectionParameter(QModbusDevice::SerialPortNameParameter)
+                         .toString(), QStringLiteral("ttyS1"));
+        QVERIFY(!group.line(2));
+        QVERIFY(!group.line(-1));
+
+        QCOMPARE(group.metrics().requestsSent, quint64(0));
+        QCOMPARE(group.metrics(5).requestsSent, quint64(0));
+    }
+
+#if defined(Q_OS_LINUX)
+    void transactions()
+    {
+        constexpr int Lines = 3;
+        constexpr int Requests = 10;
+        constexpr int SilentLine = 1;
+
+        // the lines are disconnected before the servers go away
+        std::vector<std::unique_ptr<PtyServer>> servers;
+        QModbusRtuSerialClientGroup group;
+        for (int i = 0; i < Lines; ++i) {
+            servers.push_back(std::make_unique<PtyServer>(i == SilentLine));
+            if (!servers.back()->open())
+                QSKIP("Cannot open a pseudo terminal.");
+            QCOMPARE(group.addLine(servers.back()->portName()), i);
+            group.line(i)->setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                                  QSerialPort::Baud115200);
+            group.line(i)->setPreciseTimingEnabled(true);
+            group.line(i)->setTimeout(100);
+            group.line(i)->setNumberOfRetries(0);
+        }
+        QVERIFY(group.connectLines());
+
+        int finished = 0;
+        int succeeded = 0;
+        for (int i = 0; i < Lines; ++i) {
+            const int requests = (i == SilentLine) ? 1 : Requests;
+            for (int j = 0; j < requests; ++j) {
+                auto reply = group.line(i)->sendReadRequest(
+                        QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, 1), 1);
+                QVERIFY(reply);
+                connect(reply, &QModbusReply::finished, this, [&, reply]() {
+                    ++finished;
+                    if (reply->error() == QModbusDevice::NoError
+                        && reply->result().value(0) == 0x2a) {
+                        ++succeeded;
+                    }
+                    reply->deleteLater();
+                });
+            }
+        }
+
+        // the silent line does not stall the other ones
+        QTRY_COMPARE(finished, 2 * Requests + 1);
+        QCOMPARE(succeeded, 2 * Requests);
+
+        QCOMPARE(servers.at(0)->requests, Requests);
+        QCOMPARE(servers.at(SilentLine)->requests, 1);
+        QCOMPARE(servers.at(2)->requests, Requests);
+
+        const QModbusRtuSerialClientGroup::Metrics line0 = group.metrics(0);
+        QCOMPARE(line0.requestsSent, quint64(Requests));
+        QCOMPARE(line0.responsesReceived, quint64(Requests));
+        QCOMPARE(line0.timeouts, quint64(0));
+
+        const QModbusRtuSerialClientGroup::Metrics silent = group.metrics(SilentLine);
+        QCOMPARE(silent.requestsSent, quint64(1));
+        QCOMPARE(silent.responsesReceived, quint64(0));
+        QCOMPARE(silent.timeouts, quint64(1));
+
+        const QModbusRtuSerialClientGroup::Metrics total = group.metrics();
+        QCOMPARE(total.requestsSent, quint64(2 * Requests + 1));
+        QCOMPARE(total.responsesReceived, quint64(2 * Requests));
+        QCOMPARE(total.timeouts, quint64(1));
+        QCOMPARE(total.checksumErrors, quint64(0));
+
+        group.resetMetrics();
+        QCOMPARE(group.metrics().requestsSent, quint64(0));
+
+        group.disconnectLines();
+        QCOMPARE(group.line(0)->state(), QModbusDevice::UnconnectedState);
+    }
+#endif
+};
+
+QTEST_MAIN(tst_QModbusRtuSerialClientGroup)
+
+#include "tst_qmodbusrtuserialclientgroup.moc"
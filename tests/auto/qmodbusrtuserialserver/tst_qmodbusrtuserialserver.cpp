@@ -0,0 +1,173 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtSerialBus/qmodbusrtuserialserver.h>
+#include <QtSerialPort/qserialport.h>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+#include "pseudoterminal_helpers.h"
+
+// Read one holding register at address 0 of server 1, and the response with the value 0x2a.
+static const QByteArray ReadRequest = QByteArray::fromHex("010300000001840a");
+static const QByteArray ReadResponse = QByteArray::fromHex("010302002a399b");
+
+class tst_QModbusRtuSerialServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void interCharacterTimeout()
+    {
+        QModbusRtuSerialServer server;
+        QVERIFY(!server.isInterCharacterTimeoutEnabled());
+        server.setInterCharacterTimeoutEnabled(true);
+        QVERIFY(server.isInterCharacterTimeoutEnabled());
+    }
+
+#if defined(Q_OS_LINUX)
+private:
+    std::unique_ptr<PseudoTerminal> m_pty;
+    QModbusRtuSerialServer *m_server = nullptr;
+
+private slots:
+    void init()
+    {
+        m_pty = std::make_unique<PseudoTerminal>();
+        if (!m_pty->open())
+            QSKIP("Cannot open a pseudo terminal.");
+
+        // At 1200 baud with 11 bits per character, a character takes 9.2
+        // msec, t1.5 is 13.75 msec and t3.5 is 32.1 msec. The client side
+        // writes at the same rate.
+        m_pty->setBaudRate(QSerialPort::Baud1200, 11);
+        m_server = new QModbusRtuSerialServer(this);
+        m_server->setConnectionParameter(QModbusDevice::SerialPortNameParameter,
+                                         m_pty->portName());
+        m_server->setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                         QSerialPort::Baud1200);
+        m_server->setServerAddress(1);
+        QModbusDataUnitMap map;
+        map.insert(QModbusDataUnit::HoldingRegisters, { QModbusDataUnit::HoldingRegisters, 0, 10 });
+        m_server->setMap(map);
+        QVERIFY(m_server->setData(QModbusDataUnit::HoldingRegisters, 0, 0x2a));
+        QVERIFY(m_server->connectDevice());
+    }
+
+    void cleanup()
+    {
+        delete m_server;
+        m_server = nullptr;
+        m_pty.reset();
+    }
+
+    void completeFrame()
+    {
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+    }
+
+    void framesBackToBack()
+    {
+        // the end of a frame is known from its function code
+        QVERIFY(m_pty->write(ReadRequest + ReadRequest));
+        QCOMPARE(m_pty->read(2 * ReadResponse.size()), ReadResponse + ReadResponse);
+    }
+
+    void frameInChunks()
+    {
+        // Without the inter-character timeout, gaps longer than t1.5 keep
+        // the frame intact. A longer t3.5 leaves room for a loaded machine.
+        m_server->setInterFrameDelay(200'000);
+        QVERIFY(m_pty->write(ReadRequest.first(4)));
+        m_pty->wait(20);
+        QVERIFY(m_pty->write(ReadRequest.sliced(4, 2)));
+        m_pty->wait(20);
+        QVERIFY(m_pty->write(ReadRequest.sliced(6)));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+    }
+
+    void interruptedFrame()
+    {
+        // A gap longer than t1.5 makes the frame incomplete, if enabled.
+        m_server->setInterCharacterTimeoutEnabled(true);
+        QVERIFY(m_pty->write(ReadRequest.first(4)));
+        m_pty->wait(20);
+        QVERIFY(m_pty->write(ReadRequest.sliced(4)));
+        QVERIFY(m_pty->readAll(200).isEmpty());
+
+        // the next frame is received again
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+    }
+
+    void incompleteFrame()
+    {
+        // t3.5 ends the frame, the halves are invalid on their own
+        QVERIFY(m_pty->write(ReadRequest.first(4)));
+        m_pty->wait(100);
+        QVERIFY(m_pty->write(ReadRequest.sliced(4)));
+        QVERIFY(m_pty->readAll(200).isEmpty());
+
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+        QVERIFY(m_pty->readAll(200).isEmpty());
+    }
+
+    void foreignResponseBeforeRequest()
+    {
+        // A request to server 2, and its response with ten registers. The
+        // response is no request, and is ignored until the line is silent.
+        QVERIFY(m_pty->write(QByteArray::fromHex("0203000000018439")));
+        m_pty->wait(100);
+        QVERIFY(m_pty->write(QByteArray::fromHex(
+                "0203140100010101020103010401050106010701080109" "58bf")));
+        m_pty->wait(100);
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+        QVERIFY(m_pty->readAll(200).isEmpty());
+
+        // no bus communication error was counted for the traffic of others
+        const QByteArray errorCount = QByteArray::fromHex("0108000c00002008");
+        QVERIFY(m_pty->write(errorCount));
+        QCOMPARE(m_pty->read(errorCount.size()), errorCount);
+    }
+
+    void garbageBeforeFrame()
+    {
+        QVERIFY(m_pty->write(QByteArray::fromHex("ff00ff")));
+        m_pty->wait(100);
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+    }
+
+    void wrongChecksum()
+    {
+        QByteArray request = ReadRequest;
+        request[request.size() - 1] = char(request.at(request.size() - 1) ^ 0x01);
+        QVERIFY(m_pty->write(request));
+        QVERIFY(m_pty->readAll(200).isEmpty());
+
+        // The characters up to the silence are ignored, since the frame may
+        // be the response of another server. The next frame is received.
+        QVERIFY(m_pty->write(request + ReadRequest));
+        QVERIFY(m_pty->readAll(200).isEmpty());
+        QVERIFY(m_pty->write(ReadRequest));
+        QCOMPARE(m_pty->read(ReadResponse.size()), ReadResponse);
+    }
+
+    void unknownFunctionCode()
+    {
+        // Function codes without a known size end where the checksum
+        // matches, and get an exception response.
+        QVERIFY(m_pty->write(QByteArray::fromHex("0141c010")));
+        QCOMPARE(m_pty->read(5), QByteArray::fromHex("01c101b050"));
+    }
+#endif
+};
+
+QTEST_MAIN(tst_QModbusRtuSerialServer)
+
+#include "tst_qmodbusrtuserialserver.moc"
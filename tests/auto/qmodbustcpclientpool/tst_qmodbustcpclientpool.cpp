@@ -0,0 +1,194 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+#include <QtSerialBus/qmodbustcpclientpool.h>
+#include <QtSerialBus/qmodbustcpserver.h>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+// Keeps the server side of the connections, and counts the connections
+// that received requests.
+class ConnectionObserver : public QModbusTcpConnectionObserver
+{
+public:
+    explicit ConnectionObserver(QList<QPointer<QTcpSocket>> *sockets,
+                                QSet<QTcpSocket *> *usedSockets)
+        : m_sockets(sockets), m_usedSockets(usedSockets)
+    {}
+
+    bool acceptNewConnection(QTcpSocket *newClient) override
+    {
+        m_sockets->append(newClient);
+        // connected before the server reads the requests
+        QObject::connect(newClient, &QIODevice::readyRead, newClient,
+                         [usedSockets = m_usedSockets, newClient]() {
+            usedSockets->insert(newClient);
+        });
+        return true;
+    }
+
+private:
+    QList<QPointer<QTcpSocket>> *m_sockets;
+    QSet<QTcpSocket *> *m_usedSockets;
+};
+
+class tst_QModbusTcpClientPool : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList<QPointer<QTcpSocket>> serverSockets;
+    QSet<QTcpSocket *> usedSockets;
+    std::unique_ptr<QModbusTcpServer> server;
+    quint16 port = 0;
+
+    void setupPool(QModbusTcpClientPool *pool, int connectionCount)
+    {
+        pool->setConnectionParameter(QModbusDevice::NetworkAddressParameter,
+                                     QStringLiteral("127.0.0.1"));
+        pool->setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+        pool->setConnectionCount(connectionCount);
+        pool->setReconnectInterval(10);
+    }
+
+    int countOpenReplies(const QList<QModbusReply *> &replies)
+    {
+        return int(std::count_if(replies.cbegin(), replies.cend(), [](QModbusReply *reply) {
+            return !reply->isFinished();
+        }));
+    }
+
+private slots:
+    void init()
+    {
+        // a port that was free a moment ago
+        QTcpServer probe;
+        QVERIFY(probe.listen(QHostAddress::LocalHost, 0));
+        port = probe.serverPort();
+        probe.close();
+
+        serverSockets.clear();
+        usedSockets.clear();
+        server = std::make_unique<QModbusTcpServer>();
+        server->setConnectionParameter(QModbusDevice::NetworkAddressParameter,
+                                       QStringLiteral("127.0.0.1"));
+        server->setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+        server->setServerAddress(1);
+        QModbusDataUnitMap map;
+        map.insert(QModbusDataUnit::HoldingRegisters,
+                   { QModbusDataUnit::HoldingRegisters, 0, 10 });
+        server->setMap(map);
+        server->installConnectionObserver(new ConnectionObserver(&serverSockets, &usedSockets));
+        QVERIFY(server->connectDevice());
+    }
+
+    void cleanup()
+    {
+        server.reset();
+    }
+
+    void testDefaults()
+    {
+        QModbusTcpClientPool pool;
+        QCOMPARE(pool.connectionCount(), 4);
+        QCOMPARE(pool.activeConnectionCount(), 0);
+        QCOMPARE(pool.reconnectInterval(), 1000);
+        QVERIFY(!pool.device());
+
+        pool.setConnectionCount(0);
+        QCOMPARE(pool.connectionCount(), 4);
+        pool.setConnectionCount(2);
+        QCOMPARE(pool.connectionCount(), 2);
+    }
+
+    void testSpreadsRequests()
+    {
+        QModbusTcpClientPool pool;
+        setupPool(&pool, 3);
+        QVERIFY(pool.connectDevice());
+        QTRY_COMPARE(pool.state(), QModbusDevice::ConnectedState);
+        QTRY_COMPARE(pool.activeConnectionCount(), 3);
+        QTRY_COMPARE(serverSockets.size(), 3);
+
+        QList<QModbusReply *> replies;
+        for (int i = 0; i < 30; ++i) {
+            QModbusReply *reply = pool.sendReadRequest(
+                    { QModbusDataUnit::HoldingRegisters, 0, 10 }, 1);
+            QVERIFY(reply);
+            replies.append(reply);
+        }
+        QTRY_COMPARE(countOpenReplies(replies), 0);
+        for (QModbusReply *reply : std::as_const(replies)) {
+            QCOMPARE(reply->error(), QModbusDevice::NoError);
+            QCOMPARE(reply->result().valueCount(), 10);
+        }
+        // the requests sent at once were written to all connections
+        QCOMPARE(usedSockets.size(), 3);
+        qDeleteAll(replies);
+
+        pool.disconnectDevice();
+        QTRY_COMPARE(pool.state(), QModbusDevice::UnconnectedState);
+        QCOMPARE(pool.activeConnectionCount(), 0);
+    }
+
+    void testReconnect()
+    {
+        QModbusTcpClientPool pool;
+        setupPool(&pool, 2);
+        // long enough to see the pool with one connection
+        pool.setReconnectInterval(500);
+        QVERIFY(pool.connectDevice());
+        QTRY_COMPARE(pool.activeConnectionCount(), 2);
+        QTRY_COMPARE(serverSockets.size(), 2);
+
+        // the server closes one connection, the other one keeps serving requests
+        serverSockets.first()->disconnectFromHost();
+        QTRY_COMPARE(pool.activeConnectionCount(), 1);
+        QCOMPARE(pool.state(), QModbusDevice::ConnectedState);
+
+        std::unique_ptr<QModbusReply> reply(pool.sendReadRequest(
+                { QModbusDataUnit::HoldingRegisters, 0, 1 }, 1));
+        QVERIFY(reply);
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QModbusDevice::NoError);
+
+        // the closed connection is established again
+        QTRY_COMPARE(pool.activeConnectionCount(), 2);
+        QTRY_COMPARE(serverSockets.size(), 3);
+    }
+
+    void testAllConnectionsLost()
+    {
+        QModbusTcpClientPool pool;
+        setupPool(&pool, 2);
+        QVERIFY(pool.connectDevice());
+        QTRY_COMPARE(pool.activeConnectionCount(), 2);
+
+        // without a server, the pool keeps trying to connect
+        server.reset();
+        QTRY_COMPARE(pool.state(), QModbusDevice::ConnectingState);
+        QCOMPARE(pool.error(), QModbusDevice::ConnectionError);
+        QVERIFY(!pool.sendReadRequest({ QModbusDataUnit::HoldingRegisters, 0, 1 }, 1));
+
+        pool.disconnectDevice();
+        QTRY_COMPARE(pool.state(), QModbusDevice::UnconnectedState);
+    }
+
+    void testRequiresMbapFraming()
+    {
+        QModbusTcpClientPool pool;
+        setupPool(&pool, 2);
+        pool.setConnectionParameter(QModbusDevice::FramingParameter, QModbusDevice::RtuFraming);
+        QVERIFY(!pool.connectDevice());
+        QCOMPARE(pool.state(), QModbusDevice::UnconnectedState);
+        QCOMPARE(pool.error(), QModbusDevice::ConnectionError);
+    }
+};
+
+QTEST_MAIN(tst_QModbusTcpClientPool)
+
+#include "tst_qmodbustcpclientpool.moc"
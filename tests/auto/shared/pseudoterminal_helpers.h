@@ -0,0 +1,153 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef PSEUDOTERMINAL_HELPERS_H
+#define PSEUDOTERMINAL_HELPERS_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qstring.h>
+
+#if defined(Q_OS_LINUX)
+
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+// The master side of a pseudo terminal, which takes the place of the other
+// devices on a serial line. The device under test opens portName().
+//
+// A pseudo terminal has no line rate, all bytes written at once arrive at
+// once. With a baud rate set, write() simulates the line and hands the bytes
+// over one character time apart, while the events of the device under test
+// are processed.
+class PseudoTerminal
+{
+public:
+    PseudoTerminal() = default;
+    ~PseudoTerminal()
+    {
+        if (m_master >= 0)
+            ::close(m_master);
+    }
+    Q_DISABLE_COPY_MOVE(PseudoTerminal)
+
+    // Returns false if the system has no pseudo terminals, the test is
+    // skipped then.
+    bool open()
+    {
+        m_master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (m_master < 0)
+            return false;
+        if (::grantpt(m_master) != 0 || ::unlockpt(m_master) != 0) {
+            ::close(m_master);
+            m_master = -1;
+            return false;
+        }
+        m_clock.start();
+        return true;
+    }
+
+    int handle() const { return m_master; }
+    QString portName() const { return QString::fromLocal8Bit(::ptsname(m_master)); }
+
+    // Nanoseconds since open(), the time base of the read and write times.
+    qint64 nsecsElapsed() const { return m_clock.nsecsElapsed(); }
+
+    // 0 turns the pacing off.
+    void setBaudRate(int baudRate, int bitsPerCharacter = 10)
+    {
+        m_characterTime = baudRate > 0 ? qint64(bitsPerCharacter) * 1'000'000'000 / baudRate : 0;
+    }
+    qint64 characterTimeNsecs() const { return m_characterTime; }
+
+    // Reads until size bytes arrived, or until timeout milliseconds passed.
+    // The time of the first byte is stored in firstByteAt.
+    QByteArray read(qsizetype size, int timeout = 1000, qint64 *firstByteAt = nullptr)
+    {
+        QByteArray data;
+        QDeadlineTimer deadline(timeout);
+        while (data.size() < size && !deadline.hasExpired()) {
+            char buffer[64];
+            const auto bytes = ::read(m_master, buffer,
+                                      qMin(sizeof(buffer), size_t(size - data.size())));
+            if (bytes > 0) {
+                if (data.isEmpty() && firstByteAt)
+                    *firstByteAt = m_clock.nsecsElapsed();
+                data.append(buffer, bytes);
+            } else {
+                processEvents();
+            }
+        }
+        return data;
+    }
+
+    // Returns everything that arrived in the next timeout milliseconds.
+    // Without a timeout, no events are processed.
+    QByteArray readAll(int timeout = 0)
+    {
+        QByteArray data;
+        QDeadlineTimer deadline(timeout);
+        for (;;) {
+            char buffer[64];
+            const auto bytes = ::read(m_master, buffer, sizeof(buffer));
+            if (bytes > 0) {
+                data.append(buffer, bytes);
+                continue;
+            }
+            if (deadline.hasExpired())
+                return data;
+            processEvents();
+        }
+    }
+
+    // Returns once the last character is written, so that the silence after
+    // a frame can be measured from the return.
+    bool write(const QByteArray &data)
+    {
+        if (m_characterTime <= 0)
+            return ::write(m_master, data.constData(), data.size()) == data.size();
+
+        const qint64 startedAt = m_clock.nsecsElapsed();
+        for (qsizetype i = 0; i < data.size(); ++i) {
+            waitUntil(startedAt + i * m_characterTime);
+            if (::write(m_master, data.constData() + i, 1) != 1)
+                return false;
+        }
+        return true;
+    }
+
+    // Processes events of the device under test for msecs milliseconds,
+    // without the 10 msec steps of QTest::qWait().
+    void wait(int msecs) { waitUntil(m_clock.nsecsElapsed() + qint64(msecs) * 1'000'000); }
+
+private:
+    void waitUntil(qint64 nsecs)
+    {
+        while (m_clock.nsecsElapsed() < nsecs)
+            processEvents();
+    }
+
+    static void processEvents()
+    {
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    QElapsedTimer m_clock;
+    qint64 m_characterTime = 0;
+    int m_master = -1;
+};
+
+QT_END_NAMESPACE
+
+#endif // Q_OS_LINUX
+
+#endif // PSEUDOTERMINAL_HELPERS_H
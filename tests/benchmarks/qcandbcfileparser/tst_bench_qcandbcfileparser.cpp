@@ -0,0 +1,160 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtSerialBus/qcandbcfileparser.h>
+#include <QtSerialBus/qcanmessagedescription.h>
+#include <QtSerialBus/qcansignaldescription.h>
+
+#include <QtCore/qtemporaryfile.h>
+#include <QtTest/qtest.h>
+
+#if defined(__GLIBC__)
+#  if __GLIBC_PREREQ(2, 33)
+#    include <malloc.h>
+#    define HAS_MALLINFO2
+#  endif
+#endif
+
+using namespace Qt::StringLiterals;
+
+class tst_QCanDbcFileParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void parseFile();
+    void parseFiles();
+    void parseData();
+    void lazyLoading();
+    void memoryUsage();
+    void iterateSignals();
+
+private:
+    static constexpr int MessageCount = 2000;
+
+    QString m_content;
+    QTemporaryFile m_file;
+};
+
+void tst_QCanDbcFileParser::initTestCase()
+{
+    // A database of the size used by typical vehicle networks, with all
+    // sections supported by the parser.
+    QString messages;
+    QString extraData;
+    for (int i = 0; i < MessageCount; ++i) {
+        messages += "BO_ %1 Message%1: 8 Transmitter\n"_L1.arg(i);
+        messages += " SG_ Switch M : 0|4@1+ (1,0) [0|15] \"\" Receiver\n"_L1;
+        messages += " SG_ Speed m1 : 8|16@1+ (0.01,0) [0|655.35] \"km/h\" Receiver,Logger\n"_L1;
+        messages += " SG_ Temperature m2 : 8|12@1- (0.5,-40) [-40|100] \"degC\" Receiver\n"_L1;
+        messages += " SG_ Counter : 32|32@1+ (1,0) [0|4294967295] \"\" Receiver\n"_L1;
+        messages += "\n"_L1;
+
+        extraData += "CM_ BO_ %1 \"Comment for message %1\";\n"_L1.arg(i);
+        extraData += "CM_ SG_ %1 Speed \"Vehicle speed\";\n"_L1.arg(i);
+        extraData += "SIG_VALTYPE_ %1 Counter : 0;\n"_L1.arg(i);
+        extraData += "VAL_ %1 Switch 0 \"Off\" 1 \"Speed\" 2 \"Temperature\";\n"_L1.arg(i);
+    }
+    m_content = messages + extraData;
+
+    QVERIFY(m_file.open());
+    m_file.write(m_content.toUtf8());
+    m_file.close();
+}
+
+void tst_QCanDbcFileParser::parseFile()
+{
+    QCanDbcFileParser parser;
+    QBENCHMARK {
+        parser.parse(m_file.fileName());
+    }
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    QVERIFY(parser.warnings().isEmpty());
+    QCOMPARE(parser.messageDescriptions().size(), MessageCount);
+}
+
+void tst_QCanDbcFileParser::parseFiles()
+{
+    // e.g. the databases of all networks of a vehicle
+    const QStringList fileNames(20, m_file.fileName());
+    QCanDbcFileParser parser;
+    QBENCHMARK {
+        parser.parse(fileNames);
+    }
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    QCOMPARE(parser.messageDescriptions().size(), MessageCount);
+}
+
+void tst_QCanDbcFileParser::parseData()
+{
+    QCanDbcFileParser parser;
+    QBENCHMARK {
+        parser.parseData(m_content);
+    }
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    QVERIFY(parser.warnings().isEmpty());
+    QCOMPARE(parser.messageDescriptions().size(), MessageCount);
+}
+
+void tst_QCanDbcFileParser::lazyLoading()
+{
+    // Parses the file and loads every tenth message, as an application that
+    // receives only a part of the messages of a database would do.
+    QCanDbcFileParser parser;
+    parser.setLazyLoading(true);
+    int loaded = 0;
+    QBENCHMARK {
+        parser.parse(m_file.fileName());
+        const auto provider = parser.messageDescriptionProvider();
+        loaded = 0;
+        for (int i = 0; i < MessageCount; i += 10)
+            loaded += provider(QtCanBus::UniqueId(i)).isValid() ? 1 : 0;
+    }
+    QCOMPARE(parser.error(), QCanDbcFileParser::Error::None);
+    QVERIFY(parser.warnings().isEmpty());
+    QCOMPARE(loaded, MessageCount / 10);
+}
+
+void tst_QCanDbcFileParser::memoryUsage()
+{
+#ifdef HAS_MALLINFO2
+    // Measures the heap memory that is kept by the parsed descriptions
+    const auto heapInUse = []() { return mallinfo2().uordblks; };
+
+    QList<QCanMessageDescription> messages;
+    const size_t before = heapInUse();
+    {
+        QCanDbcFileParser parser;
+        QVERIFY(parser.parseData(m_content));
+        messages = parser.messageDescriptions();
+    }
+    const size_t after = heapInUse();
+    QCOMPARE(messages.size(), MessageCount);
+
+    QTest::setBenchmarkResult(qreal(after - before), QTest::BytesAllocated);
+#else
+    QSKIP("Measuring the heap usage is not supported on this platform");
+#endif
+}
+
+void tst_QCanDbcFileParser::iterateSignals()
+{
+    QCanDbcFileParser parser;
+    QVERIFY(parser.parseData(m_content));
+    const QList<QCanMessageDescription> messages = parser.messageDescriptions();
+
+    quint64 sum = 0;
+    QBENCHMARK {
+        for (const QCanMessageDescription &message : messages) {
+            const QList<QCanSignalDescription> messageSignals = message.signalDescriptions();
+            for (const QCanSignalDescription &signal : messageSignals)
+                sum += signal.startBit() + signal.bitLength();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_MAIN(tst_QCanDbcFileParser)
+
+#include "tst_bench_qcandbcfileparser.moc"
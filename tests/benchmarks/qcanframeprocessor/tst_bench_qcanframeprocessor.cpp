@@ -0,0 +1,225 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtSerialBus/qcanbusframe.h>
+#include <QtSerialBus/qcanframeprocessor.h>
+#include <QtSerialBus/qcanmessagedescription.h>
+#include <QtSerialBus/qcansignaldescription.h>
+#include <QtSerialBus/qcanuniqueiddescription.h>
+
+#include <QtTest/qtest.h>
+
+using namespace Qt::StringLiterals;
+
+class tst_QCanFrameProcessor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseFrame_data();
+    void parseFrame();
+    void decodeFrame_data();
+    void decodeFrame();
+    void extractSignals_data();
+    void extractSignals();
+};
+
+void tst_QCanFrameProcessor::parseFrame_data()
+{
+    QTest::addColumn<QCanUniqueIdDescription>("uniqueIdDescription");
+    QTest::addColumn<QCanBusFrame>("frame");
+    QTest::addColumn<QtCanBus::UniqueId>("uniqueId");
+
+    const QByteArray payload = QByteArray::fromHex("0102030405060708");
+
+    // the most common case: the unique id is the full 11-bit frame id
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setSource(QtCanBus::DataSource::FrameId);
+    uidDesc.setEndian(QSysInfo::Endian::LittleEndian);
+    uidDesc.setStartBit(0);
+    uidDesc.setBitLength(11);
+    QTest::newRow("frameId, LE") << uidDesc << QCanBusFrame(0x123, payload)
+                                << QtCanBus::UniqueId{0x123};
+
+    uidDesc.setBitLength(29);
+    QTest::newRow("extended frameId, LE") << uidDesc << QCanBusFrame(0x12345, payload)
+                                          << QtCanBus::UniqueId{0x12345};
+
+    uidDesc.setSource(QtCanBus::DataSource::Payload);
+    uidDesc.setStartBit(12);
+    uidDesc.setBitLength(16);
+    QTest::newRow("payload, LE") << uidDesc << QCanBusFrame(0, payload)
+                                 << QtCanBus::UniqueId{0x4030};
+
+    uidDesc.setEndian(QSysInfo::Endian::BigEndian);
+    uidDesc.setStartBit(15);
+    QTest::newRow("payload, BE") << uidDesc << QCanBusFrame(0, payload)
+                                 << QtCanBus::UniqueId{0x0203};
+}
+
+void tst_QCanFrameProcessor::parseFrame()
+{
+    QFETCH(QCanUniqueIdDescription, uniqueIdDescription);
+    QFETCH(QCanBusFrame, frame);
+    QFETCH(QtCanBus::UniqueId, uniqueId);
+
+    // A message without signals, so that the unique id extraction and the
+    // message lookup dominate the measured time.
+    QCanMessageDescription messageDesc;
+    messageDesc.setName(u"empty"_s);
+    messageDesc.setUniqueId(uniqueId);
+    messageDesc.setSize(frame.payload().size());
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uniqueIdDescription);
+    processor.setMessageDescriptions({ messageDesc });
+
+    QCanFrameProcessor::ParseResult result;
+    QBENCHMARK {
+        result = processor.parseFrame(frame);
+    }
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+    QCOMPARE(result.uniqueId, uniqueId);
+}
+
+void tst_QCanFrameProcessor::decodeFrame_data()
+{
+    QTest::addColumn<bool>("useDecodeFrame");
+    QTest::addColumn<bool>("withValueDescriptions");
+
+    QTest::newRow("parseFrame") << false << false;
+    QTest::newRow("decodeFrame") << true << false;
+    QTest::newRow("decodeFrame, value descriptions") << true << true;
+}
+
+void tst_QCanFrameProcessor::decodeFrame()
+{
+    QFETCH(bool, useDecodeFrame);
+    QFETCH(bool, withValueDescriptions);
+
+    constexpr auto uniqueId = QtCanBus::UniqueId{0x123};
+
+    // eight 8-bit signals, each with a few value descriptions
+    QCanMessageDescription messageDesc;
+    messageDesc.setName(u"states"_s);
+    messageDesc.setUniqueId(uniqueId);
+    messageDesc.setSize(8);
+    QCanFrameProcessor::SignalValueDescriptions signalValues;
+    for (quint16 i = 0; i < 8; ++i) {
+        QCanSignalDescription signalDesc;
+        signalDesc.setName(u"state%1"_s.arg(i));
+        signalDesc.setDataEndian(QSysInfo::Endian::LittleEndian);
+        signalDesc.setStartBit(i * 8);
+        signalDesc.setBitLength(8);
+        messageDesc.addSignalDescription(signalDesc);
+        signalValues.insert(signalDesc.name(), { {0, u"Off"_s}, {1, u"On"_s},
+                                                 {2, u"Error"_s}, {255, u"N/A"_s} });
+    }
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(11);
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+    processor.setMessageDescriptions({ messageDesc });
+    if (withValueDescriptions)
+        processor.setValueDescriptions({ { uniqueId, signalValues } });
+
+    const QCanBusFrame frame(0x123, QByteArray::fromHex("00010201ff000102"));
+    if (useDecodeFrame) {
+        QCanFrameProcessor::DecodeResult result;
+        QBENCHMARK {
+            result = processor.decodeFrame(frame);
+        }
+        QCOMPARE(result.signalValues.size(), 8);
+    } else {
+        QCanFrameProcessor::ParseResult result;
+        QBENCHMARK {
+            result = processor.parseFrame(frame);
+        }
+        QCOMPARE(result.signalValues.size(), 8);
+    }
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+}
+
+void tst_QCanFrameProcessor::extractSignals_data()
+{
+    QTest::addColumn<QSysInfo::Endian>("endian");
+    QTest::addColumn<quint16>("bitLength");
+    QTest::addColumn<QtCanBus::DataFormat>("format");
+
+    QTest::newRow("LE, 8 bit") << QSysInfo::Endian::LittleEndian << quint16(8)
+                               << QtCanBus::DataFormat::UnsignedInteger;
+    QTest::newRow("LE, 13 bit") << QSysInfo::Endian::LittleEndian << quint16(13)
+                                << QtCanBus::DataFormat::UnsignedInteger;
+    QTest::newRow("LE, 13 bit, signed") << QSysInfo::Endian::LittleEndian << quint16(13)
+                                        << QtCanBus::DataFormat::SignedInteger;
+    QTest::newRow("LE, 64 bit") << QSysInfo::Endian::LittleEndian << quint16(64)
+                                << QtCanBus::DataFormat::UnsignedInteger;
+    QTest::newRow("BE, 8 bit") << QSysInfo::Endian::BigEndian << quint16(8)
+                               << QtCanBus::DataFormat::UnsignedInteger;
+    QTest::newRow("BE, 13 bit") << QSysInfo::Endian::BigEndian << quint16(13)
+                                << QtCanBus::DataFormat::UnsignedInteger;
+    QTest::newRow("BE, 13 bit, signed") << QSysInfo::Endian::BigEndian << quint16(13)
+                                        << QtCanBus::DataFormat::SignedInteger;
+    QTest::newRow("BE, 64 bit") << QSysInfo::Endian::BigEndian << quint16(64)
+                                << QtCanBus::DataFormat::UnsignedInteger;
+}
+
+void tst_QCanFrameProcessor::extractSignals()
+{
+    QFETCH(QSysInfo::Endian, endian);
+    QFETCH(quint16, bitLength);
+    QFETCH(QtCanBus::DataFormat, format);
+
+    constexpr auto uniqueId = QtCanBus::UniqueId{0x123};
+    constexpr qsizetype payloadSize = 64;
+
+    // A CAN FD message that is filled with adjacent signals, to measure the
+    // throughput of the signal extraction.
+    QCanMessageDescription messageDesc;
+    messageDesc.setName(u"signals"_s);
+    messageDesc.setUniqueId(uniqueId);
+    messageDesc.setSize(payloadSize);
+    const qsizetype signalCount = payloadSize * 8 / bitLength;
+    for (qsizetype i = 0; i < signalCount; ++i) {
+        // For BE signals the start bit is the MSB. Numbering the bits of the
+        // payload from the MSB of the first byte, the signal starts at
+        // i * bitLength.
+        const qsizetype lsbFirstBit = i * bitLength;
+        const qsizetype msbFirstBit = lsbFirstBit / 8 * 8 + 7 - lsbFirstBit % 8;
+        QCanSignalDescription signalDesc;
+        signalDesc.setName(u"signal%1"_s.arg(i));
+        signalDesc.setDataEndian(endian);
+        signalDesc.setDataFormat(format);
+        signalDesc.setStartBit(endian == QSysInfo::Endian::LittleEndian ? lsbFirstBit
+                                                                        : msbFirstBit);
+        signalDesc.setBitLength(bitLength);
+        messageDesc.addSignalDescription(signalDesc);
+    }
+
+    QCanUniqueIdDescription uidDesc;
+    uidDesc.setBitLength(11);
+
+    QCanFrameProcessor processor;
+    processor.setUniqueIdDescription(uidDesc);
+    processor.setMessageDescriptions({ messageDesc });
+
+    QByteArray payload(payloadSize, Qt::Uninitialized);
+    for (qsizetype i = 0; i < payloadSize; ++i)
+        payload[i] = char(i * 37 + 11);
+    QCanBusFrame frame(0x123, payload);
+    frame.setFlexibleDataRateFormat(true);
+
+    QCanFrameProcessor::DecodeResult result;
+    QBENCHMARK {
+        result = processor.decodeFrame(frame);
+    }
+    QCOMPARE(processor.error(), QCanFrameProcessor::Error::None);
+    QVERIFY(processor.warnings().isEmpty());
+    QCOMPARE(result.signalValues.size(), signalCount);
+}
+
+QTEST_MAIN(tst_QCanFrameProcessor)
+
+#include "tst_bench_qcanframeprocessor.moc"
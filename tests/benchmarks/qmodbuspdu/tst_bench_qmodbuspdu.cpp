@@ -0,0 +1,115 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtSerialBus/qmodbuspdu.h>
+
+#include <QtCore/qdatastream.h>
+#include <QtTest/qtest.h>
+
+class tst_QModbusPdu : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encodeData_data();
+    void encodeData();
+    void decodeData_data();
+    void decodeData();
+    void encodeRegisters_data();
+    void encodeRegisters();
+};
+
+// QModbusPdu used to encode and decode the data with a QDataStream over its
+// buffer. The streams are kept here as a reference for the measurements.
+
+void tst_QModbusPdu::encodeData_data()
+{
+    QTest::addColumn<bool>("useDataStream");
+
+    QTest::newRow("QDataStream") << true;
+    QTest::newRow("QModbusPdu") << false;
+}
+
+void tst_QModbusPdu::encodeData()
+{
+    QFETCH(bool, useDataStream);
+
+    // a typical request: the start address and the quantity of registers
+    QModbusRequest request(QModbusRequest::ReadHoldingRegisters);
+    if (useDataStream) {
+        QBENCHMARK {
+            QByteArray data;
+            QDataStream stream(&data, QIODevice::WriteOnly);
+            stream << quint16(0x0100) << quint16(10);
+            request.setData(data);
+        }
+    } else {
+        QBENCHMARK {
+            request.encodeData(quint16(0x0100), quint16(10));
+        }
+    }
+    QCOMPARE(request.data(), QByteArray::fromHex("0100000a"));
+}
+
+void tst_QModbusPdu::decodeData_data()
+{
+    encodeData_data();
+}
+
+void tst_QModbusPdu::decodeData()
+{
+    QFETCH(bool, useDataStream);
+
+    const QModbusRequest request(QModbusRequest::ReadHoldingRegisters,
+                                 QByteArray::fromHex("0100000a"));
+    quint16 address = 0;
+    quint16 count = 0;
+    if (useDataStream) {
+        QBENCHMARK {
+            QDataStream stream(request.data());
+            stream >> address >> count;
+        }
+    } else {
+        QBENCHMARK {
+            request.decodeData(&address, &count);
+        }
+    }
+    QCOMPARE(address, quint16(0x0100));
+    QCOMPARE(count, quint16(10));
+}
+
+void tst_QModbusPdu::encodeRegisters_data()
+{
+    encodeData_data();
+}
+
+void tst_QModbusPdu::encodeRegisters()
+{
+    QFETCH(bool, useDataStream);
+
+    // the largest response to a ReadHoldingRegisters request
+    QList<quint16> values(125);
+    for (qsizetype i = 0; i < values.size(); ++i)
+        values[i] = quint16(i * 0x0101);
+
+    QModbusResponse response(QModbusResponse::ReadHoldingRegisters);
+    if (useDataStream) {
+        QBENCHMARK {
+            QByteArray data;
+            QDataStream stream(&data, QIODevice::WriteOnly);
+            stream << quint8(values.size() * 2);
+            for (quint16 value : std::as_const(values))
+                stream << value;
+            response.setData(data);
+        }
+    } else {
+        QBENCHMARK {
+            response.encodeData(quint8(values.size() * 2), values);
+        }
+    }
+    QCOMPARE(response.dataSize(), 251);
+}
+
+QTEST_MAIN(tst_QModbusPdu)
+
+#include "tst_bench_qmodbuspdu.moc"
@@ -0,0 +1,124 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtSerialBus/qmodbustcpclient.h>
+#include <QtSerialBus/qmodbustcpserver.h>
+#include <QtSerialBus/qmodbusudpclient.h>
+#include <QtSerialBus/qmodbusudpserver.h>
+
+#include <QtCore/qeventloop.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qudpsocket.h>
+#include <QtTest/qtest.h>
+
+#include <functional>
+#include <memory>
+
+class tst_QModbusUdp : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readRegisters_data();
+    void readRegisters();
+};
+
+// Returns a port on the loopback interface that was free a moment ago.
+static quint16 freePort(bool udp)
+{
+    if (udp) {
+        QUdpSocket socket;
+        socket.bind(QHostAddress::LocalHost, 0);
+        return socket.localPort();
+    }
+    QTcpServer server;
+    server.listen(QHostAddress::LocalHost, 0);
+    return server.serverPort();
+}
+
+void tst_QModbusUdp::readRegisters_data()
+{
+    QTest::addColumn<bool>("udp");
+    QTest::addColumn<int>("inFlight");
+
+    for (int inFlight : { 1, 64 }) {
+        QTest::addRow("TCP, %d in flight", inFlight) << false << inFlight;
+        QTest::addRow("UDP, %d in flight", inFlight) << true << inFlight;
+    }
+}
+
+// The throughput of ReadHoldingRegisters requests over the loopback interface,
+// with one request at a time, and with many requests in flight.
+void tst_QModbusUdp::readRegisters()
+{
+    QFETCH(bool, udp);
+    QFETCH(int, inFlight);
+
+    std::unique_ptr<QModbusServer> server;
+    std::unique_ptr<QModbusClient> client;
+    if (udp) {
+        server = std::make_unique<QModbusUdpServer>();
+        client = std::make_unique<QModbusUdpClient>();
+    } else {
+        server = std::make_unique<QModbusTcpServer>();
+        client = std::make_unique<QModbusTcpClient>();
+    }
+
+    const quint16 port = freePort(udp);
+    QVERIFY(port != 0);
+    for (QModbusDevice *device : { static_cast<QModbusDevice *>(server.get()),
+                                   static_cast<QModbusDevice *>(client.get()) }) {
+        device->setConnectionParameter(QModbusDevice::NetworkAddressParameter,
+                                       QStringLiteral("127.0.0.1"));
+        device->setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+    }
+
+    QModbusDataUnitMap map;
+    map.insert(QModbusDataUnit::HoldingRegisters, { QModbusDataUnit::HoldingRegisters, 0, 10 });
+    server->setMap(map);
+    server->setServerAddress(1);
+    QVERIFY(server->connectDevice());
+    QVERIFY(client->connectDevice());
+    QTRY_COMPARE(client->state(), QModbusDevice::ConnectedState);
+
+    constexpr int RequestCount = 1000;
+    const QModbusDataUnit unit(QModbusDataUnit::HoldingRegisters, 0, 10);
+    int sent = 0;
+    int finished = 0;
+    int failed = 0;
+    QEventLoop loop;
+
+    // Keeps inFlight requests open until all requests are sent.
+    std::function<void()> sendNext = [&]() {
+        QModbusReply *reply = client->sendReadRequest(unit, 1);
+        if (!reply) {
+            ++failed;
+            loop.quit();
+            return;
+        }
+        ++sent;
+        connect(reply, &QModbusReply::finished, this, [&, reply]() {
+            reply->deleteLater();
+            if (reply->error() != QModbusDevice::NoError)
+                ++failed;
+            if (++finished == RequestCount)
+                loop.quit();
+            else if (sent < RequestCount)
+                sendNext();
+        });
+    };
+
+    QBENCHMARK {
+        sent = 0;
+        finished = 0;
+        for (int i = 0; i < inFlight; ++i)
+            sendNext();
+        if (failed == 0)
+            loop.exec();
+    }
+    QCOMPARE(failed, 0);
+}
+
+QTEST_MAIN(tst_QModbusUdp)
+
+#include "tst_bench_qmodbusudp.moc"